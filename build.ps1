@@ -1,7 +1,7 @@
 [CmdletBinding()]
-param ([switch]$dbg, [switch]$clean,
+param ([switch]$dbg, [switch]$clean, [switch]$bench,
     [Parameter(Mandatory=$false)]
-    [ValidateSet("Dev", "FX01", "FX02")]
+    [ValidateSet("Dev", "FX01", "FX02", "Bench")]
     [string]$board = "Dev",
     [switch]$log
 )
@@ -9,14 +9,16 @@ param ([switch]$dbg, [switch]$clean,
 # see platformio.ini for the environment names
 $relEnv = "rp2040-rel"
 $dbgEnv = "rp2040-dbg"
+$benchEnv = "rp2040-bench"
 
 function prepEnvironment() {
     # see config.h in the include folder for board ID values
-    # 1 = Dev, 2 = FX01, 3 = FX02
+    # 1 = Dev, 2 = FX01, 3 = FX02, 4 = Bench
     $boardId = switch ($board) {
         "Dev" { 1 }
         "FX01" { 2 }
         "FX02" { 3 }
+        "Bench" { 4 }
     }
     $env:PLATFORMIO_BUILD_FLAGS = "-DBOARD_ID=$boardId"
     if ($log) {
@@ -39,4 +41,4 @@ if ($clean) {
     pio run -t clean -e ($dbg ? $dbgEnv : $relEnv)
 }
 # Call the build function with the appropriate environment name based on debug flag
-Build-Application ($dbg ? $dbgEnv : $relEnv)
+Build-Application ($bench ? $benchEnv : ($dbg ? $dbgEnv : $relEnv))
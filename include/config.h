@@ -16,6 +16,12 @@
 // initial global brightness 0-255
 #define BRIGHTNESS 255
 
+// maximum time (ms) an unchanged frame is held without pushing it again to the strip - refreshes the strip against glitches
+#define SHOW_KEEPALIVE_MS   1000
+
+// gamma exponent of the output LUT - 1.0 keeps the output linear in the LED buffer values (the FastLED behavior), ~2.2 is perceptual
+#define OUTPUT_GAMMA    1.0f
+
 // These are lists and need to be commas instead of dots e.g., for IP address 192.168.0.1 use 192,168,0,1 instead
 // #define IP_DNS 8,8,8,8               // Google DNS
 #define IP_DNS 75,75,75,75              // Xfinity DNS
@@ -27,12 +33,14 @@
 // MODE 1 = Access point mode
 // #define MODE 0
 
-// Board 1 is the dev board, board 2 is the house lighting controller, board 3 is the spare light controller.
+// Board 1 is the dev board, board 2 is the house lighting controller, board 3 is the spare light controller, board 4 is the dev board
+// configured with the maximum number of pixels - used for benchmarking effects.
 #ifndef BOARD_ID
 #define BOARD_ID    1
 #endif
 
-// Board specific configurations
+// Board specific configurations - NUM_PIXELS sizes the LED buffer and the strip output; how the logical pixels land on the strip
+// (segments, reversed runs, mirrors, matrix layout) is read at boot from /topology.json, see Topology
 #if BOARD_ID == 1
 
 #define NUM_PIXELS  170      //the number of pixels on the office window edge is 166
@@ -85,5 +93,20 @@
 
 #endif
 
+#if BOARD_ID == 4
+
+#define NUM_PIXELS  MAX_NUM_PIXELS      //benchmark board - the dev board hardware driving the maximum number of pixels supported
+#define FRAME_SIZE  76
+#define PIXEL_BUFFER_SPACE  (4*FRAME_SIZE)    //number of pixels to reserve for secondary buffer (used for effects data maneuvering)
+
+#define IP_ADDR 192,168,0,10    //same as Board 1 (dev)
+#define V3_3    3.262f      //measured 3V3 pin voltage in V
+#define MV3_3    3262       //measured 3V3 pin voltage in mV - technically 1000*V3_3 - expressed as int
+#define VCC_DIV_R4  21950
+#define VCC_DIV_R5  3304
+#define DEVICE_NAME  "Bench"
+
+#endif
+
 
 #endif //LIGHTFX_CONFIG_H
@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_CROSSFADE_H
+#define ARDUINO_LIGHTFX_CROSSFADE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <FastLED.h>
+#include "config.h"
+#include "fx_stats.h"
+#include "frame_scheduler.h"
+#include "fx_context.h"
+
+#define XFADE_DURATION_MS   2000    // crossfade duration - 0 disables crossfades, effect changes turn the strip off and on instead (see EffectTransition)
+#define XFADE_FRAME_MS      20      // compositing period - the crossfade frame rate, independent of the two effects' frame rates
+#define XFADE_EDGE          16      // soft edge width of the mask, in rank units (pixels) - power of 2
+#define XFADE_BUDGET_US     6000    // per-frame cost budget - both effect steps, compositing and show; frames above are counted
+#define XFADE_BUDGET_FRAMES 3       // consecutive frames over budget that cut the crossfade short - the incoming effect takes over
+
+enum CrossfadeMask : uint8_t {Wipe, Dissolve, Radial, CrossfadeMaskCount};
+
+class LedEffect;
+
+/**
+ * A→B effect transition - while it lasts, both the outgoing and the incoming effect run, each in its own pixel buffer, and a mask
+ * mixes the two buffers into the LED buffer at a fixed rate. Each pixel has a rank in the mask order - its position for a wipe, its
+ * shuffled position for a dissolve, its distance from the center for a radial - and switches from the outgoing to the incoming
+ * effect as the crossfade front passes its rank, blending over a soft edge of <code>XFADE_EDGE</code> ranks.
+ * <p>The effects write the global LED buffer, hence each effect step swaps its own buffer in and out of it; shows issued by the
+ * effects while crossfading are captured (not pushed to the strip) - only the composited frames are. The ranks are computed once
+ * when the crossfade begins, such that compositing costs one pass over the pixels regardless of the mask.</p>
+ * <p>The outgoing effect is stopped when the crossfade completes - no wind down, no transition break. Each effect keeps its own
+ * context of the globals (side buffer, palettes, speed, etc.), restored around its steps - the incoming effect's setup resets only its
+ * own. The scratch arena is flipped for the incoming effect to allocate from the other end, and the outgoing effect's end released at
+ * completion; a crossfade only begins when the arena has room for both. Effects that render in blocking loops do not crossfade.</p>
+ * <p>Crossfading costs both effects' steps per frame - a crossfade running over <code>XFADE_BUDGET_US</code> for
+ * <code>XFADE_BUDGET_FRAMES</code> frames in a row is cut short, the incoming effect taking over right away.</p>
+ * <p>Used by the FX task only - not thread safe.</p>
+ */
+class EffectCrossfade {
+    CRGB bufFrom[NUM_PIXELS] {};
+    CRGB bufTo[NUM_PIXELS] {};
+    uint16_t rank[NUM_PIXELS] {};
+    LedEffect *from = nullptr;
+    LedEffect *to = nullptr;
+    FxContext ctxFrom {};
+    FxContext ctxTo {};
+    FrameTimer tick {XFADE_FRAME_MS};
+    uint32_t startMs = 0;
+    uint32_t head = 0;          // crossfade front - in 1/256 rank units
+    CrossfadeMask mask = Wipe;
+    uint8_t overRun = 0;        // consecutive frames over budget
+    bool active = false;
+    bool capturing = false;
+    //statistics
+    TimeHistogram frame;
+    uint32_t count = 0;
+    uint32_t fallbacks = 0;     // effect changes that turned the strip off and on instead - effect not running, blocking, or arena too small
+    uint32_t cut = 0;           // crossfades cut short - by another effect change, or over budget
+    uint32_t overBudget = 0;
+    uint32_t budgetCuts = 0;    // crossfades cut short over budget
+
+    void buildRanks();
+    static void step(LedEffect *fx, CRGB *buf, FxContext &ctx);
+    void mix(uint16_t lo, uint16_t hi) const;
+    void composite(uint16_t progress);
+public:
+    bool begin(LedEffect *outgoing, LedEffect *incoming);
+    void loop();
+    void finish();
+    [[nodiscard]] bool isActive() const { return active; }
+    [[nodiscard]] bool isCapturing() const { return capturing; }
+    void stats(const JsonObject &json) const;
+};
+
+extern EffectCrossfade crossfade;
+
+#endif //ARDUINO_LIGHTFX_CROSSFADE_H
@@ -0,0 +1,32 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_EASING_H
+#define ARDUINO_LIGHTFX_EASING_H
+
+#include <cstdint>
+
+/**
+ * Fixed point easing functions - the easings.net family, computed with integer math only. The polynomial curves (quad through
+ * quint, back, bounce) are evaluated directly; the sine, exponential and elastic curves interpolate small compile-time generated
+ * tables (quarter sine wave and the fractional part of 2^x); circ uses an integer square root.
+ * <p>Values are Q15 - <code>EASE_ONE</code> (32768) is 1.0 - such that every intermediate product fits a single 32-bit multiply
+ * on the Cortex-M0+ (which has no FPU). Back and elastic overshoot the [0, EASE_ONE] range, as their float counterparts do.</p>
+ * @see https://easings.net
+ */
+
+constexpr int32_t EASE_ONE = 1 << 15;
+
+enum EaseCurve:uint8_t {
+    EaseSine, EaseQuad, EaseCubic, EaseQuart, EaseQuint, EaseExpo, EaseCirc, EaseBack, EaseElastic, EaseBounce
+};
+
+enum EaseMode:uint8_t {
+    EaseIn, EaseOut, EaseInOut
+};
+
+int32_t easeQ15(EaseCurve curve, EaseMode mode, int32_t t);
+int32_t ease(EaseCurve curve, EaseMode mode, uint16_t x, uint16_t lim);
+uint8_t ease8(EaseCurve curve, EaseMode mode, uint8_t x);
+
+#endif //ARDUINO_LIGHTFX_EASING_H
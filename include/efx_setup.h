@@ -8,15 +8,31 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <FastLED.h>
+#include <atomic>
+#include <deque>
+#include <vector>
 #include "fixed_queue.h"
+#include "frame_scheduler.h"
+#include "easing.h"
+#include "palette_cache.h"
+#include "output_map.h"
+#include "output_lut.h"
+#include "frame_output.h"
+#include "span_render.h"
+#include "fx_catalog.h"
+#include "fx_arena.h"
+#include "fx_context.h"
+#include "index_perm.h"
+#include "lit_map.h"
+#include "crossfade.h"
+#include "layers.h"
+#include "topology.h"
 #include "config.h"
 #include "global.h"
 #include "PaletteFactory.h"
 #include "constants.hpp"
 #include "log.h"
 
-typedef void (*setupFunc)();
-
 /**
  * Viewport definition packed as a 4-byte unsigned integer - uint32_t
  */
@@ -28,14 +44,18 @@ struct Viewport {
     Viewport(uint16_t low, uint16_t high);
     [[nodiscard]] uint16_t size() const;
 };
-enum OpMode { TurnOff, Chase };
 enum EffectState:uint8_t {Setup, Running, WindDownPrep, WindDown, TransitionBreakPrep, TransitionBreak, Idle};
 extern CRGB leds[NUM_PIXELS];
 extern CRGBArray<PIXEL_BUFFER_SPACE> frame;
 extern CRGBSet tpl;
 extern CRGBSet others;
 extern CRGBSet ledSet;
-extern uint16_t stripShuffleIndex[NUM_PIXELS];
+/**
+ * The logical pixels of the LED buffer - the ones the strip topology shows, see Topology::logicalSize
+ * @return a view over the first logical pixels of <code>leds</code>
+ */
+inline CRGBSet logicalSet() { return CRGBSet(leds, topology.logicalSize()); }
+extern IndexPermutation stripShuffle;
 extern CRGBPalette16 palette;
 extern CRGBPalette16 targetPalette;
 extern OpMode mode;
@@ -62,6 +82,12 @@ extern volatile uint16_t curPos;
 
 void ledStripInit();
 
+void showStrip(uint8_t scale);
+
+void clearStrip(bool flush);
+
+uint32_t frameHash();
+
 void shiftRight(CRGBSet &set, CRGB feedLeft, Viewport vwp = (Viewport)0, uint16_t pos = 1);
 
 void loopRight(CRGBSet &set, Viewport vwp = (Viewport)0, uint16_t pos = 1);
@@ -73,11 +99,9 @@ bool spreadColor(CRGBSet &set, CRGB color = BKG, uint8_t gradient = 255);
 bool moveBlend(CRGBSet &target, const CRGBSet &segment, fract8 overlay, uint16_t fromPos, uint16_t toPos);
 bool areSame(const CRGBSet &lhs, const CRGBSet &rhs);
 
-void shuffleIndexes(uint16_t array[], uint16_t szArray);
+uint32_t shuffleSeed();
 void shuffle(CRGBSet &set);
 
-uint16_t easeOutBounce(uint16_t x, uint16_t lim);
-uint16_t easeOutQuad(uint16_t x, uint16_t lim);
 
 void copyArray(const CRGB *src, CRGB *dest, uint16_t length);
 
@@ -91,7 +115,7 @@ bool isAnyLedOn(const CRGB *arr, uint16_t szArray, CRGB backg = BKG);
 
 void fillArray(const CRGB *src, uint16_t srcLength, CRGB *array, uint16_t arrLength, uint16_t arrOfs = 0);
 
-void replicateSet(const CRGBSet& src, CRGBSet& dest);
+void replicateSet(const CRGBSet& src, CRGBSet& dest, OutputRule rule = Repeat);
 
 uint8_t adjustStripBrightness();
 
@@ -101,13 +125,14 @@ void mirrorHigh(CRGBSet &set);
 
 void resetGlobals();
 
-CRGB& setBrightness(CRGB& rgb, uint8_t br);
-uint8_t getBrightness(const CRGB& rgb);
-
 inline CHSV toHSV(const CRGB &rgb) { return rgb2hsv_approximate(rgb); }
 inline CRGB toRGB(const CHSV &hsv) { CRGB rgb{}; hsv2rgb_rainbow(hsv, rgb); return rgb; }
 
 bool rblend(CRGB &existing, const CRGB &target, fract8 frOverlay);
+void scaleSet(CRGBSet &set, uint8_t scale);
+void fadeSet(CRGBSet &set, uint8_t fadeBy);
+void blendSet(CRGBSet &set, const CRGB &overlay, fract8 amount);
+void blendSet(CRGBSet &set, const CRGBSet &overlay, fract8 amount);
 void blendMultiply(CRGBSet &blendLayer, const CRGBSet &topLayer);
 void blendMultiply(CRGB &blendRGB, const CRGB &topRGB);
 void blendScreen(CRGBSet &blendLayer, const CRGBSet &topLayer);
@@ -118,36 +143,6 @@ CRGB adjustBrightness(CRGB color, uint8_t bright);
 void saveFxState();
 void readFxState();
 
-namespace FxA {
-    void fxRegister();
-}
-namespace FxB {
-    void fxRegister();
-}
-namespace FxC {
-    void fxRegister();
-}
-namespace FxD {
-    void fxRegister();
-}
-namespace FxE {
-    void fxRegister();
-}
-namespace FxF {
-    void fxRegister();
-}
-namespace FxH {
-    void fxRegister();
-}
-namespace FxI {
-    void fxRegister();
-}
-namespace FxJ {
-    void fxRegister();
-}
-namespace FxK {
-    void fxRegister();
-}
 void fx_setup();
 
 void fx_run();
@@ -155,13 +150,15 @@ void fx_run();
 //base class/interface for all effects
 class LedEffect {
 protected:
-    uint registryIndex = 0;
+    uint registryIndex = 0;         //the position in the effects catalog - id, description, etc. are read from there
     EffectState state;
     ulong transOffStart = 0;
-    const char* const desc;
-    char id[LED_EFFECT_ID_SIZE] {};   //this is name of the class, max 5 characters (plus null terminal)
+
+    virtual void renderSpan(uint16_t lo, uint16_t hi) {}
+
+    void renderSpans(uint16_t lo, uint16_t hi, uint8_t callerShare = 128);
 public:
-    explicit LedEffect(const char* description);
+    LedEffect();
 
     virtual void setup();
 
@@ -191,20 +188,19 @@ public:
 
     [[nodiscard]] EffectState getState() const { return state; }
 
-    /**
-     * What weight does this effect have when random selection is engaged
-     * Subclasses have the opportunity to customize this value by e.g. the current holiday, time, etc., hence changing/reshaping the chances of selecting an effect
-     * @return a value between 1 and 255. If returning 0, this effectively removes the effect from random selection.
-     */
-    [[nodiscard]] virtual uint8_t selectionWeight() const {
-        return 1;
-    }
+    [[nodiscard]] uint8_t selectionWeight() const;
 
     virtual ~LedEffect() = default;     // Destructor
+
+    friend class EffectRegistry;
+    friend class EffectCrossfade;
+    friend class LayerStack;
 };
 
 class EffectRegistry {
-    std::deque<LedEffect*> effects;
+    //effect instances by catalog index - created when first needed, under the mutex; published with release, read with acquire
+    mutable std::vector<std::atomic<LedEffect*>> effects;
+    mutable mutex_t mutex {};
     FixedQueue<uint16_t, MAX_EFFECTS_HISTORY> lastEffects;
     uint16_t currentEffect = 0;
     uint16_t effectsCount = 0;
@@ -213,10 +209,23 @@ class EffectRegistry {
     bool autoSwitch = true;
     bool sleepState = false;
     bool sleepModeEnabled = false;
+    volatile bool switchPending = false;    //an effect change to carry out on the FX task - see loop
+    //Walker alias table for the weighted random selection - rebuilt only when the selection weights may have changed
+    std::vector<uint16_t> aliasIndex;       // the alternate effect of each column
+    std::vector<uint16_t> aliasThreshold;   // Q16 probability of selecting the column's own effect rather than its alternate
+    uint32_t aliasTotalWeight = 0;
+    Holiday aliasHoliday = None;            // the holiday the table was built for - effect weights vary with the holiday
+    bool aliasValid = false;
+
+    void buildAliasTable();
+    LedEffect *instance(uint16_t index) const;
+    void effectChanged();
 
 public:
     EffectRegistry() = default;
 
+    void begin();
+
     [[nodiscard]] LedEffect *getCurrentEffect() const;
 
     [[nodiscard]] LedEffect *getEffect(uint16_t index) const;
@@ -231,12 +240,22 @@ public:
 
     uint16_t nextRandomEffectPos();
 
-    void transitionEffect() const;
+    uint16_t randomEffectIndex();
 
-    uint16_t registerEffect(LedEffect *effect);
+    void invalidateSelection() { aliasValid = false; }
+
+    void transitionEffect();
 
     LedEffect* findEffect(const char* id) const;
 
+    [[nodiscard]] const char *effectName(uint16_t index) const;
+
+    [[nodiscard]] uint8_t selectionWeight(uint16_t index) const;
+
+    [[nodiscard]] uint16_t instancesCount() const;
+
+    void describeEffect(uint16_t index, JsonObject &json) const;
+
     [[nodiscard]] uint16_t size() const;
 
     void setup() const;
@@ -264,7 +283,5 @@ public:
 
 extern EffectRegistry fxRegistry;
 
-extern const setupFunc categorySetup[];
-
 
 #endif //LIGHTFX_EFX_SETUP_H
@@ -0,0 +1,46 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_ENTROPY_POOL_H
+#define ARDUINO_LIGHTFX_ENTROPY_POOL_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <atomic>
+
+#define ENTROPY_POOL_SIZE       256     // number of 16-bit random values the pool holds - power of 2
+#define ENTROPY_BLOCK_SIZE      16      // 16-bit values per ECC608 random command (the chip returns 32 random bytes per command)
+#define ENTROPY_REFILL_IDLE_MS  250     // diagnostic task idle time before it refills the pool with another block
+
+/**
+ * Pool of secure random numbers from the ECC608 TRNG. The diagnostic task - owner of the I2C bus - refills the pool one block
+ * at a time whenever it has been idle for a while; the consumers draw a value in O(1), without touching I2C, and fall back to
+ * FastLED's <code>random16</code> when the pool is empty.
+ * <p>The ring is lock-free single producer (diagnostic task) - single consumer (FX task): the producer only writes the head,
+ * the consumer only writes the tail.</p>
+ */
+class EntropyPool {
+    uint16_t ring[ENTROPY_POOL_SIZE] {};
+    std::atomic<uint16_t> head {0};     // next slot to write - producer owned
+    std::atomic<uint16_t> tail {0};     // next slot to read - consumer owned
+    volatile uint32_t refills = 0;      // blocks added - producer owned
+    volatile uint32_t refillErrors = 0; // failed ECC608 random commands - producer owned
+    volatile uint32_t drawn = 0;        // values served from the pool - consumer owned
+    volatile uint32_t fallbacks = 0;    // values served by random16 as the pool was empty - consumer owned
+    volatile uint16_t lowLevel = ENTROPY_POOL_SIZE;  // lowest fill level seen by the consumer since the pool was first filled
+    bool primed = false;
+
+public:
+    [[nodiscard]] uint16_t level() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+    [[nodiscard]] bool needsRefill() const { return level() <= ENTROPY_POOL_SIZE - ENTROPY_BLOCK_SIZE; }
+    bool refill();
+    bool draw(uint16_t &val);
+    uint16_t random16();
+    uint16_t random16(uint16_t lim);
+    uint16_t random16(uint16_t min, uint16_t lim);
+    void stats(const JsonObject &json) const;
+};
+
+extern EntropyPool entropyPool;
+
+#endif //ARDUINO_LIGHTFX_ENTROPY_POOL_H
@@ -0,0 +1,45 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_FIRE_SIM_H
+#define ARDUINO_LIGHTFX_FIRE_SIM_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "palette_cache.h"
+
+/**
+ * Fire2012 simulation (by Mark Kriegsman) over several independent fire segments. The heat cells of all segments are bytes packed
+ * back to back in one array - segment k starts at offset <code>ofs[k]</code> - rather than interleaved as color channels of a pixel.
+ * <p>The per-cell random values of the cooling and rendering passes are drawn in one batch per pass, straight from FastLED's
+ * random generator state - the draws, hence the frames, are identical with calling <code>random8</code> per cell. Heat is mapped
+ * to color through the expanded palette table of a <code>PaletteCache</code> - a table read per pixel rather than a palette
+ * interpolation.</p>
+ * <p>A frame is simulated in two phases: <code>advance</code> runs the heat simulation and draws the rendering random values of all
+ * segments, in order, then <code>renderCells</code> maps any range of the (flattened) cells to colors independently - such that the
+ * rendering can be split across cores, see <code>SpanRenderer</code>.</p>
+ * <p>The arrays are carved out of the scratch arena at <code>begin()</code> - the simulation is valid only while its effect is active.</p>
+ */
+class FireSim {
+    CRGBSet *segs = nullptr;    // the fire segments - owned by the caller; heat cell 0 is the segment's first pixel (fire base)
+    uint16_t *ofs = nullptr;    // offset of each segment's heat cells; ofs[numSegs] is the total number of cells
+    uint8_t *heat = nullptr;    // heat cells of all segments
+    uint8_t *rnd = nullptr;     // batched random draws of all cells - cooling, then overwritten with the rendering flicker heights
+    uint8_t numSegs = 0;
+    uint8_t cooling = 0;
+    uint8_t sparking = 0;
+
+    static void random8Batch(uint8_t *dest, uint16_t count, uint8_t lim);
+public:
+    bool begin(CRGBSet *fires, uint8_t numFires, uint8_t cooling, uint8_t sparking);
+    void step(uint8_t seg);
+    void advance();
+    void renderCells(const PaletteCache &colors, uint8_t brightness, uint16_t lo, uint16_t hi);
+    void update(const PaletteCache &colors, uint8_t brightness);
+
+    [[nodiscard]] uint8_t size() const { return numSegs; }
+    [[nodiscard]] uint16_t cells() const { return numSegs > 0 ? ofs[numSegs] : 0; }
+    [[nodiscard]] const uint8_t *heatMap(const uint8_t seg) const { return heat + ofs[seg]; }
+};
+
+#endif //ARDUINO_LIGHTFX_FIRE_SIM_H
@@ -5,42 +5,146 @@
 #ifndef ARDUINO_LIGHTFX_FIXED_QUEUE_H
 #define ARDUINO_LIGHTFX_FIXED_QUEUE_H
 
-#include <deque>
-#include <queue>
+#include <array>
+#include <cstddef>
+#include <iterator>
 
 /**
  * @class FixedQueue
  *
- * @brief A class that represents a fixed size queue.
+ * @brief A fixed capacity double-ended queue, stored inline - no heap use.
  *
- * This class is a specialization of std::queue that limits the
- * maximum number of elements that can be stored in the queue to a
- * fixed number defined by the template parameter MaxSize. If the
- * queue exceeds its maximum size, the oldest element is automatically
- * removed when a new element is added.
+ * The elements are kept in a <code>std::array</code> used as a ring: the front moves around the array rather than the
+ * elements being shifted. The queue limits the number of elements to MaxSize; when full, adding an element at one end
+ * automatically removes the element at the other end (e.g. <code>push</code> drops the oldest element).
+ * <p>Iterators are random access, in queue order (front to back) - e.g. <code>end()[-2]</code> is the second-last element.
+ * Erasing elements shifts the remainder of the queue, hence it is O(n) - intended for small queues.</p>
  *
- * @tparam T The type of elements to be stored in the queue.
+ * @tparam T The type of elements to be stored in the queue - default constructible and copy assignable.
  * @tparam MaxSize The maximum number of elements that can be stored in the queue.
- * @tparam Container The underlying container type used to store the elements (default: std::deque<T>).
- *
- * @note This class inherits from std::queue to provide the basic queue functionality.
- *
- * @see std::queue
  */
-template <typename T, int MaxSize, typename Container = std::deque<T>> class FixedQueue : public std::queue<T, Container> {
-public:
-    void push(const T& value) {
-        if (this->size() >= MaxSize)
-            this->c.pop_front();
-        std::queue<T, Container>::push(value);
+template <typename T, size_t MaxSize> class FixedQueue {
+    static_assert(MaxSize > 0, "FixedQueue capacity must be positive");
+
+    std::array<T, MaxSize> buf {};
+    size_t head = 0;    // physical position of the front element
+    size_t count = 0;
+
+    [[nodiscard]] size_t phys(const size_t i) const {
+        const size_t p = head + i;
+        return p >= MaxSize ? p - MaxSize : p;
+    }
+
+    template<typename Q, typename V> class Iterator {
+        Q *q;
+        ptrdiff_t i;
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = V*;
+        using reference = V&;
+
+        template<typename, typename> friend class Iterator;
+        Iterator(Q *queue, const ptrdiff_t pos) : q(queue), i(pos) {}
+        template<typename Q2, typename V2> Iterator(const Iterator<Q2, V2> &o) : q(o.q), i(o.i) {}   // iterator -> const_iterator
+
+        reference operator*() const { return (*q)[i]; }
+        pointer operator->() const { return &(*q)[i]; }
+        reference operator[](const difference_type n) const { return (*q)[i + n]; }
+        Iterator &operator++() { ++i; return *this; }
+        Iterator operator++(int) { Iterator t = *this; ++i; return t; }
+        Iterator &operator--() { --i; return *this; }
+        Iterator operator--(int) { Iterator t = *this; --i; return t; }
+        Iterator &operator+=(const difference_type n) { i += n; return *this; }
+        Iterator &operator-=(const difference_type n) { i -= n; return *this; }
+        Iterator operator+(const difference_type n) const { return {q, i + n}; }
+        Iterator operator-(const difference_type n) const { return {q, i - n}; }
+        difference_type operator-(const Iterator &o) const { return i - o.i; }
+        bool operator==(const Iterator &o) const { return i == o.i; }
+        bool operator!=(const Iterator &o) const { return i != o.i; }
+        bool operator<(const Iterator &o) const { return i < o.i; }
+        bool operator>(const Iterator &o) const { return i > o.i; }
+        bool operator<=(const Iterator &o) const { return i <= o.i; }
+        bool operator>=(const Iterator &o) const { return i >= o.i; }
+        [[nodiscard]] ptrdiff_t index() const { return i; }
     };
-    typedef typename Container::iterator iterator;
-    typedef typename Container::const_iterator const_iterator;
 
-    iterator begin() { return this->c.begin(); }
-    iterator end() { return this->c.end(); }
-    const_iterator begin() const { return this->c.begin(); }
-    const_iterator end() const { return this->c.end(); }
+public:
+    typedef Iterator<FixedQueue, T> iterator;
+    typedef Iterator<const FixedQueue, const T> const_iterator;
+
+    static constexpr size_t capacity() { return MaxSize; }
+    [[nodiscard]] size_t size() const { return count; }
+    [[nodiscard]] bool empty() const { return count == 0; }
+    [[nodiscard]] bool full() const { return count == MaxSize; }
+
+    T &operator[](const size_t i) { return buf[phys(i)]; }
+    const T &operator[](const size_t i) const { return buf[phys(i)]; }
+    T &front() { return buf[head]; }
+    const T &front() const { return buf[head]; }
+    T &back() { return buf[phys(count - 1)]; }
+    const T &back() const { return buf[phys(count - 1)]; }
+
+    /**
+     * Adds an element at the back of the queue, removing the front (oldest) element if the queue is full
+     * @param value element to add
+     */
+    void push(const T &value) { push_back(value); }
+
+    void push_back(const T &value) {
+        if (count == MaxSize)
+            head = phys(1);
+        else
+            ++count;
+        buf[phys(count - 1)] = value;
+    }
+
+    /**
+     * Adds an element at the front of the queue, removing the back element if the queue is full
+     * @param value element to add
+     */
+    void push_front(const T &value) {
+        head = head == 0 ? MaxSize - 1 : head - 1;
+        if (count < MaxSize)
+            ++count;
+        buf[head] = value;
+    }
+
+    /**
+     * Removes the front (oldest) element - the queue must not be empty
+     */
+    void pop() { pop_front(); }
+
+    void pop_front() {
+        head = phys(1);
+        --count;
+    }
+
+    void pop_back() { --count; }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    /**
+     * Removes the element at the position given, shifting the elements after it one position towards the front
+     * @param pos position of the element to remove
+     * @return iterator to the element following the removed one
+     */
+    iterator erase(const const_iterator pos) {
+        const size_t at = pos.index();
+        for (size_t i = at + 1; i < count; ++i)
+            (*this)[i - 1] = (*this)[i];
+        --count;
+        return {this, static_cast<ptrdiff_t>(at)};
+    }
+
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, static_cast<ptrdiff_t>(count)}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, static_cast<ptrdiff_t>(count)}; }
 };
 
 #endif //ARDUINO_LIGHTFX_FIXED_QUEUE_H
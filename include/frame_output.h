@@ -0,0 +1,60 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_FRAME_OUTPUT_H
+#define ARDUINO_LIGHTFX_FRAME_OUTPUT_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <FastLED.h>
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+#include <pico/mutex.h>
+#include "config.h"
+#include "fx_stats.h"
+
+/**
+ * Double buffered strip output - the FX task prepares a frame in the back buffer (see <code>showStrip</code>) and hands it to the
+ * Show task, which pushes it to the strip while the FX task goes on rendering the next frame. At most one frame is in flight:
+ * handing a frame over waits for the previous one to be pushed, which also guarantees the back buffer is no longer being read.
+ * <p>Until the Show task is attached the frames are pushed synchronously, from the calling task.</p>
+ * <p><code>fence</code> waits for the frame in flight to reach the strip - for code that needs the strip to actually show what
+ * has been handed over (e.g. before timing a pause with the strip turned off).</p>
+ * <p>The interval between pushes is kept in a rolling histogram - the frame rate the strip actually gets, reported with the
+ * statistics.</p>
+ */
+class FrameOutput {
+    CRGB buffers[2][NUM_PIXELS] {};
+    CLEDController *controller = nullptr;
+    SemaphoreHandle_t idle = nullptr;           // available when no frame is in flight
+    TaskHandle_t volatile worker = nullptr;     // the Show task
+    volatile uint8_t front = 0;                 // buffer in flight or last pushed
+    volatile uint32_t pushes = 0;
+    volatile uint32_t pushUs = 0;
+    volatile uint32_t pushMaxUs = 0;
+    uint32_t fenceWaits = 0;                    // hand overs and fences that had to wait on the frame in flight
+    uint64_t fenceWaitUs = 0;
+    TimeHistogram interval;                     // time between push starts - guarded by the mutex
+    uint32_t lastPushStart = 0;
+    mutable mutex_t mutex {};
+
+    void push();
+    bool acquire();
+public:
+    void begin(CLEDController &ctl);
+    void attach();
+    [[nodiscard]] CRGB *back() { return buffers[front ^ 1]; }
+    void submit();
+    void fence();
+    void run();
+    void stats(const JsonObject &json) const;
+};
+
+extern FrameOutput frameOutput;
+
+void show_setup();
+
+void show_run();
+
+#endif //ARDUINO_LIGHTFX_FRAME_OUTPUT_H
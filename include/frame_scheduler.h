@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_FRAME_SCHEDULER_H
+#define ARDUINO_LIGHTFX_FRAME_SCHEDULER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <FastLED.h>
+#include <FreeRTOS.h>
+#include <task.h>
+
+#define FX_SCHED_MAX_SLEEP_MS   100     // upper limit of the FX task sleep time - keeps the periodic fx_run housekeeping and effect changes responsive
+
+/**
+ * Deadline aware replacement of FastLED's <code>CEveryNMillis</code>. Besides gating the code like its FastLED counterpart,
+ * it reports its next deadline to the frame scheduler, such that the FX task can block until the earliest deadline
+ * rather than polling the timers.
+ * <p>The timer is phase locked - the next deadline is computed from the previous deadline, not from the time it was polled -
+ * hence the frame rate does not drift with the task wake-up latency. If the timer falls behind by more than one period
+ * (e.g. effect was not running) it re-synchronizes with current time.</p>
+ */
+class FrameTimer {
+    uint32_t prevTrigger;
+    uint32_t period;
+    uint32_t prevTriggerUs = 0;
+    uint32_t prevPollLoop = 0;  //scheduler loop of the latest poll - a gap means the timer has been paused (e.g. its effect idle)
+public:
+    explicit FrameTimer(uint32_t period);
+    bool ready();
+    void setPeriod(uint32_t p) { period = p; }
+    [[nodiscard]] uint32_t getPeriod() const { return period; }
+    void reset();
+};
+
+/**
+ * Frame scheduler for the FX task - collects the deadlines requested by the frame timers polled during one fx_run loop
+ * and blocks the task (<code>vTaskDelayUntil</code>) until the earliest one. Loops where no frame timers have been polled
+ * (e.g. effects still using FastLED's EVERY_N timers) fall back to the regular one tick polling.
+ * Keeps frame pacing jitter and FX task load statistics.
+ */
+class FrameScheduler {
+    uint32_t earliest = 0;      //earliest deadline requested (ms)
+    uint16_t requests = 0;      //number of deadlines requested in current loop
+    TickType_t wakeTick = 0;
+    uint32_t wakeMs = 0;
+    uint32_t wakeUs = 0;
+    //statistics
+    uint64_t statsStartUs = 0;
+    uint64_t busyUs = 0;
+    uint32_t frames = 0;
+    uint32_t missed = 0;
+    uint64_t jitterSumUs = 0;
+    uint32_t jitterMaxUs = 0;
+    uint32_t sleeps = 0;
+    uint32_t polls = 0;
+    uint32_t loops = 0;         //FX task loops since boot - not a statistic, never reset
+public:
+    void begin();
+    void request(uint32_t deadline);
+    void frameTriggered(uint32_t jitterUs);
+    void frameMissed();
+    void waitNextFrame();
+    void loopDone();
+    [[nodiscard]] uint32_t loopCount() const { return loops; }
+    void resetStats();
+    void stats(const JsonObject &json) const;
+};
+
+extern FrameScheduler fxScheduler;
+
+#define FRAME_TIMER_CONCAT_(a, b) a##b
+#define FRAME_TIMER_CONCAT(a, b) FRAME_TIMER_CONCAT_(a, b)
+/// Deadline aware equivalent of EVERY_N_MILLISECONDS_I - the timer instance is named, can have its period changed
+#define FRAME_EVERY_N_MILLIS_I(NAME, PERIOD) static FrameTimer NAME(PERIOD); if (NAME.ready())
+/// Deadline aware equivalent of EVERY_N_MILLISECONDS
+#define FRAME_EVERY_N_MILLIS(PERIOD) FRAME_EVERY_N_MILLIS_I(FRAME_TIMER_CONCAT(frameTimer_, __COUNTER__), PERIOD)
+
+#endif //ARDUINO_LIGHTFX_FRAME_SCHEDULER_H
@@ -22,8 +22,6 @@ namespace FxA {
 
         void baseConfig(JsonObject &json) const override;
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
-
     protected:
         void makeDot(CRGB color, uint16_t szDot) const;
 
@@ -42,8 +40,6 @@ namespace FxA {
 
         void baseConfig(JsonObject &json) const override;
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
-
     protected:
         enum Movement { forward, pause, backward };
         void makeDot() const;
@@ -63,8 +59,6 @@ namespace FxA {
 
         void baseConfig(JsonObject &json) const override;
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
-
     protected:
         CRGBSet dot;
         void makeDot(CRGB color, uint16_t szDot) const;
@@ -83,8 +77,6 @@ namespace FxA {
 
         void baseConfig(JsonObject &json) const override;
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
-
     protected:
         CRGBSet dot;
         CRGBSet frL;
@@ -106,8 +98,6 @@ namespace FxA {
 
         void baseConfig(JsonObject &json) const override;
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
-
     protected:
         CRGBSet ovr;
 
@@ -124,8 +114,6 @@ namespace FxA {
 
         void windDownPrep() override;
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
-
         ~SleepLight() override = default;
 
     protected:
@@ -24,7 +24,6 @@ namespace FxC {
 
         void animationB();
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
     };
 
     class FxC2 : public LedEffect {
@@ -37,7 +36,6 @@ namespace FxC {
 
         void windDownPrep() override;
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
     };
 
     class FxC3 : public LedEffect {
@@ -52,7 +50,6 @@ namespace FxC {
 
         void baseConfig(JsonObject &json) const override;
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
     };
 
     class FxC4 : public LedEffect {
@@ -65,8 +62,6 @@ namespace FxC {
 
         bool windDown() override;
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
-
     protected:
         uint8_t frequency {10};
         uint8_t flashes {12};
@@ -86,8 +81,6 @@ namespace FxC {
 
         void matrix();
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
-
     protected:
         uint8_t palIndex = 95;
         bool hueRot = false;                                     // Does the hue rotate? 1 = yes
@@ -107,8 +100,6 @@ namespace FxC {
 
         void one_sine_pal(uint8_t colorIndex);
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
-
     protected:
         uint8_t allfreq = 32;                                     // You can change the frequency, thus distance between bars.
         int phase = 0;                                            // Phase change value gets calculated.
@@ -5,6 +5,7 @@
 #define LIGHTFX_FXD_H
 
 #include "efx_setup.h"
+#include "particles.h"
 
 namespace FxD {
     extern int8_t rot;
@@ -24,7 +25,6 @@ namespace FxD {
 
         void confetti();
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
     };
 
     class FxD2 : public LedEffect {
@@ -41,7 +41,6 @@ namespace FxD {
 
         void dot_beat();
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
     };
 
     class FxD3 : public LedEffect {
@@ -56,9 +55,9 @@ namespace FxD {
 
         void plasma() const;
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
-
     protected:
+        void plasmaPixel(uint16_t k, uint8_t colorIndex) const;
+
         uint8_t monoColor;
     };
 
@@ -76,26 +75,8 @@ namespace FxD {
 
         void update_params(uint8_t slot);
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
-    };
-
-
-    struct ripple {
-        uint8_t rpBright;
-        uint8_t color;
-        uint16_t center;
-        uint8_t rpFade;   // low value - slow fade to black
-        uint8_t step;
-        CRGBSet *pSeg;
-
-        void Move();
-        void Fade() const;
-        bool Alive() const;
-        void Init(CRGBSet *set);
-
     };
 
-    typedef struct ripple Ripple;
 
     class FxD5 : public LedEffect {
     public:
@@ -109,13 +90,15 @@ namespace FxD {
 
         void ripples();
 
-        uint8_t selectionWeight() const override;
-
     protected:
-        static const uint8_t maxRipples = 8;
-        Ripple ripplesData[maxRipples]{};
-
-
+        static constexpr uint8_t maxRipples = 8;
+        static constexpr uint8_t rippleSteps = 42;  //ripple life time, in frames
+        //ripples as particles - pos is the center, hue the color, bright the ripple brightness, aux the fade rate (low value - slow fade to black)
+        ParticlePool ripplePool;
+
+        void spawnRipple();
+        void rippleFade(uint16_t i) const;
+        void rippleMove(uint16_t i) const;
     };
 }
 
@@ -24,8 +24,6 @@ namespace FxE {
         void baseConfig(JsonObject &json) const override;
 
         static void updateParams();
-
-        [[nodiscard]] uint8_t selectionWeight() const override;
     };
 
     class FxE2 : public LedEffect {
@@ -39,8 +37,6 @@ namespace FxE {
         void windDownPrep() override;
 
         void beatwave();
-
-        [[nodiscard]] uint8_t selectionWeight() const override;
     };
 
     class FxE3 : public LedEffect {
@@ -53,8 +49,6 @@ namespace FxE {
 
         void windDownPrep() override;
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
-
     protected:
         const uint8_t sasquatchSize = 3;
         enum Movement {forward, backward, sasquatch, pauseF, pauseB};
@@ -76,8 +70,6 @@ namespace FxE {
 
         void serendipitous();
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
-
     protected:
         uint16_t Xorig = 0x012;
         uint16_t Yorig = 0x015;
@@ -95,8 +87,6 @@ namespace FxE {
 
         void windDownPrep() override;
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
-
     protected:
         CRGBSet wave2, wave3;
         uint8_t clr1, clr2, clr3;
@@ -5,6 +5,7 @@
 #define ARDUINO_LIGHTFX_FXF_H
 
 #include "efx_setup.h"
+#include "particles.h"
 
 namespace FxF {
 
@@ -17,8 +18,6 @@ namespace FxF {
         void run() override;
 
         bool windDown() override;
-
-        [[nodiscard]] uint8_t selectionWeight() const override;
     };
 
     class FxF2 : public LedEffect {
@@ -31,8 +30,6 @@ namespace FxF {
 
         bool windDown() override;
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
-
     protected:
         void makePattern(uint8_t hue);
         CRGBSet pattern;
@@ -84,11 +81,9 @@ namespace FxF {
 
         EyeBlink *findAvailableEye();
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
-
     protected:
         static const uint8_t maxEyes = 5;   //correlated with size of a FRAME
-        EyeBlink eyes[maxEyes]{};
+        EyeBlink *eyes = nullptr;           //maxEyes eyes in the scratch arena, created at setup
     };
 
     class FxF4 : public LedEffect {
@@ -101,8 +96,6 @@ namespace FxF {
 
         bool windDown() override;
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
-
     protected:
         enum FxState {Bounce, Reduce, Flash};
         static constexpr uint8_t dotSize = 4;
@@ -115,15 +108,6 @@ namespace FxF {
         void offsetBounce(const CRGB &feed) const;
     };
 
-    struct Spark {
-        float pos=0;
-        float velocity=0;
-        uint8_t hue=0;
-
-        [[nodiscard]] inline uint16_t iPos() const { return uint16_t(abs(pos)); }
-        inline float limitPos(const float limit) { return pos = constrain(pos, 0, limit); }
-    };
-
     class FxF5 : public LedEffect {
     public:
         explicit FxF5();
@@ -134,18 +118,17 @@ namespace FxF {
 
         bool windDown() override;
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
-
     protected:
-        //Spark sparks[NUM_SPARKS]{};
-        float flarePos{};
+        ParticlePool sparks;            //flare sparks, then explosion sparks - pos, vel and hue are used
+        uint16_t flarePos{};
         bool bFade = false;
-        const float gravity = -.004;    // m/s/s
-        const ushort explRangeLow = 3;  //30%
-        const ushort explRangeHigh = 8; //80%
+        static constexpr saccum1516 gravity = -262;     // -.004 pixels/step/step, in 15.16 fixed point
+        static constexpr ushort explRangeLow = 3;  //30%
+        static constexpr ushort explRangeHigh = 8; //80%
+        static constexpr ushort flareSparksCount = 3;
 
         void flare();
-        void explode() const;
+        void explode();
     };
 }
 #endif //ARDUINO_LIGHTFX_FXF_H
@@ -5,7 +5,7 @@
 #define LIGHTFX_FXH_H
 
 #include "efx_setup.h"
-#include <vector>
+#include "fire_sim.h"
 
 namespace FxH {
 // This basic one-dimensional 'fire' simulation works roughly as follows:
@@ -48,7 +48,9 @@ namespace FxH {
     private:
         static constexpr uint8_t numFires = 2;
         CRGBSet fires[numFires];
-        std::vector<CRGB> hMap;
+        FireSim fireSim;
+    protected:
+        void renderSpan(uint16_t lo, uint16_t hi) override;
     public:
         FxH1();
 
@@ -59,10 +61,6 @@ namespace FxH {
         void windDownPrep() override;
 
         void baseConfig(JsonObject &json) const override;
-
-        void Fire2012WithPalette(uint8_t xFire);
-
-        [[nodiscard]] uint8_t selectionWeight() const override;
     };
 
     class FxH2 : public LedEffect {
@@ -80,8 +78,6 @@ namespace FxH {
         static void confetti_pal();
 
         static void updateParams();
-
-        [[nodiscard]] uint8_t selectionWeight() const override;
     };
 
     class FxH3 : public LedEffect {
@@ -95,8 +91,6 @@ namespace FxH {
         void windDownPrep() override;
 
         void baseConfig(JsonObject &json) const override;
-
-        [[nodiscard]] uint8_t selectionWeight() const override;
     };
 
     class FxH4 : public LedEffect {
@@ -111,7 +105,6 @@ namespace FxH {
 
         void baseConfig(JsonObject &json) const override;
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
     private:
         static constexpr uint8_t twinkleDensity = 5;
         static constexpr uint8_t twinkleSpeed = 4;
@@ -137,7 +130,6 @@ namespace FxH {
 
         void baseConfig(JsonObject &json) const override;
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
     private:
         int red {0};
         int green {0};
@@ -197,17 +189,13 @@ namespace FxH {
 
         void windDownPrep() override;
 
-        [[nodiscard]] uint8_t selectionWeight() const override;
-
-        ~FxH6() override;
-
     private:
         static constexpr int frameSize = 7;
         enum Phase:uint8_t {DefinedPattern, Random} stage;
 
         uint16_t timerCounter {};
-        std::deque<Spark*> sparks {};
-        std::deque<Spark*> activeSparks {};
+        FixedQueue<Spark*, frameSize> sparks {};       //sparks live in the scratch arena, created at setup
+        FixedQueue<Spark*, frameSize> activeSparks {};
 
         CRGBSet window, rest;
 
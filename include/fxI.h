@@ -17,7 +17,6 @@ namespace FxI {
         void setup() override;
         void run() override; // Main loop for the ping-pong effect
         void reWall();
-        [[nodiscard]] uint8_t selectionWeight() const override;
 
     private:
         uint16_t wallStart, wallEnd, prevWallStart, prevWallEnd;
@@ -28,21 +27,45 @@ namespace FxI {
         uint8_t fgColor, bgColor;
     };
 
+    /**
+     * Pacifica wave layers - the motion state is advanced once per frame, after which any range of pixels can be rendered
+     * independently (hence in parallel)
+     */
+    class PacificaWaves {
+        struct Layer {
+            const PaletteCache *pal;
+            uint16_t ciStart;
+            uint16_t waveScale;
+            uint16_t ioff;
+            uint8_t bri;
+        };
+        uint16_t sCIStart1{}, sCIStart2{}, sCIStart3{}, sCIStart4{};
+        uint32_t sLastMs = 0;
+        Layer layers[4] {};
+        uint8_t capThreshold = 0;
+        uint8_t capWave = 0;
+        PaletteCache pal1, pal2, pal3;  //the pacifica palettes never change - expanded once
+
+        static void addLayer(const Layer &layer, CRGB *dest, uint16_t lo, uint16_t hi);
+        void addWhitecaps(CRGB *dest, uint16_t lo, uint16_t hi) const;
+        static void deepenColors(CRGB *dest, uint16_t lo, uint16_t hi);
+    public:
+        void begin();
+        void advance(uint32_t ms);
+        void render(CRGB *dest, uint16_t lo, uint16_t hi) const;
+    };
+
     class FxI2 : public LedEffect {
     public:
         FxI2();
         void setup() override;
         void run() override;
-        [[nodiscard]] inline uint8_t selectionWeight() const override;
 
-    private:
-        void pacifica_loop();
-        void pacifica_one_layer(const CRGBPalette16& p, uint16_t ciStart, uint16_t waveScale, uint8_t bri, uint16_t ioff);
-        void pacifica_add_whitecaps();
-        void pacifica_deepen_colors();
+    protected:
+        void renderSpan(uint16_t lo, uint16_t hi) override;
 
-        uint16_t sCIStart1{}, sCIStart2{}, sCIStart3{}, sCIStart4{};
-        uint32_t sLastMs = 0;
+    private:
+        PacificaWaves waves;
     };
 
 }
@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_FX_ARENA_H
+#define ARDUINO_LIGHTFX_FX_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#define FX_ARENA_SIZE   3072    // bytes - must fit the scratch state of the largest effect, see the arenaPeak effect statistics
+
+/**
+ * Scratch memory shared by the effects - a statically allocated bump arena. Only one effect runs at a time, hence its state
+ * lives in the arena only while it is active: the effect allocates from the arena in <code>setup()</code> and the whole arena
+ * is reset when the effect completes its wind down (and again right before the next effect setup). There is no per-allocation
+ * free, no heap use and no fragmentation - the peak RAM is the arena size, regardless of which effects have been run.
+ * <p>The arena is double ended - allocations and resets apply to the current end, growing up from the bottom or down from the top.
+ * During a crossfade two effects run at once: the arena is flipped, such that the incoming effect setup allocates from the other end,
+ * and the outgoing effect's end is released when the crossfade completes (see EffectCrossfade) - no space is left behind however
+ * many crossfades are chained. Pinning the current end makes resets rewind only down to the blocks allocated so far.</p>
+ * <p>Resetting does not call destructors, hence only trivially destructible types can be placed in the arena. Pointers into
+ * the arena are not valid past the effect's wind down - the effect acquires them again in its next setup.</p>
+ * <p>Used by the FX task only - not thread safe.</p>
+ */
+class ScratchArena {
+    alignas(8) uint8_t buf[FX_ARENA_SIZE] {};
+    size_t used[2] {};      // bytes allocated from the bottom [0] and from the top [1] end
+    size_t base[2] {};      // pinned bytes of each end - resets rewind down to here
+    size_t highWater = 0;
+    uint8_t end = 0;        // the current end - allocations and resets apply to it
+public:
+    void *allocate(size_t bytes, size_t align);
+
+    /**
+     * Creates an object in the arena
+     * @tparam T type of the object - trivially destructible
+     * @param args constructor arguments
+     * @return pointer to the new object; nullptr if the arena is exhausted
+     */
+    template<typename T, typename... Args> T *make(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena objects are discarded without calling their destructor");
+        void *p = allocate(sizeof(T), alignof(T));
+        return p == nullptr ? nullptr : new (p) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * Creates an array of value initialized (default constructed or zeroed) elements in the arena
+     * @tparam T type of the elements - trivially destructible
+     * @param n number of elements
+     * @return pointer to the first element; nullptr if the arena is exhausted
+     */
+    template<typename T> T *makeArray(const size_t n) {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena objects are discarded without calling their destructor");
+        void *p = allocate(sizeof(T) * n, alignof(T));
+        if (p == nullptr)
+            return nullptr;
+        T *arr = static_cast<T*>(p);
+        for (size_t i = 0; i < n; i++)
+            new (arr + i) T();
+        return arr;
+    }
+
+    size_t reset();
+    size_t releaseOther();
+    void flip() { end ^= 1; }
+    size_t pin() { const size_t prev = base[end]; base[end] = used[end]; return prev; }
+    void unpin(const size_t prev = 0) { base[end] = prev; }
+    [[nodiscard]] size_t size() const { return used[end] - base[end]; }
+    [[nodiscard]] size_t available() const { return FX_ARENA_SIZE - used[0] - used[1]; }
+    [[nodiscard]] size_t peak() const { return highWater; }
+    static constexpr size_t capacity() { return FX_ARENA_SIZE; }
+};
+
+extern ScratchArena fxArena;
+
+#endif //ARDUINO_LIGHTFX_FX_ARENA_H
@@ -0,0 +1,60 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_FX_BENCH_H
+#define ARDUINO_LIGHTFX_FX_BENCH_H
+
+// *************************************************************************
+//  Effects benchmark - enabled through the build flag FX_BENCH_ENABLED=1 (see rp2040-bench environment in platformio.ini)
+//  Requires USE_GET_MILLISECOND_TIMER such that FastLED timers (EVERY_N_*, beat functions) read the controllable bench clock
+// ************************************************************************
+#ifndef FX_BENCH_ENABLED
+#define FX_BENCH_ENABLED 0
+#endif
+
+#if FX_BENCH_ENABLED == 1
+#include <Arduino.h>
+
+#define FX_BENCH_RUN_MS         8000    // virtual time each effect spends in Running state
+#define FX_BENCH_WINDDOWN_MS    12000   // upper limit of virtual time allowed for an effect's WindDown state
+#define FX_BENCH_FRAME_BUDGET_US    10000   // frame budget - effects with worst case run() time above this are flagged
+#define FX_BENCH_EASE_LIM       1023    // easing benchmark input range [0, FX_BENCH_EASE_LIM]
+#define FX_BENCH_SELECTIONS     4096    // number of random effect selections timed by the selection benchmark
+#define FX_BENCH_PARTICLES      128     // number of particles moved by the particle benchmark - must fit the scratch arena
+#define FX_BENCH_PARTICLE_STEPS 256     // number of kinematic steps timed by the particle benchmark
+#define FX_BENCH_FIRE_FRAMES    200     // number of fire simulation frames timed by the fire benchmark - 3 fires over the whole strip
+#define FX_BENCH_LITMAP_STEPS   20000   // number of random turn off steps the lit map is checked against full scans after
+#define FX_BENCH_RENDER_FRAMES  100     // number of frames timed by the dual core rendering benchmark, for each effect and mode
+#define FX_BENCH_KERNEL_FRAMES  100     // number of random frames timed by the pixel kernels benchmark, for each kernel
+
+/**
+ * Benchmark statistics for one effect. A frame is a state machine step that has changed the LED strip buffer;
+ * steps that did not change the buffer are polls (e.g. waiting on an EVERY_N timer)
+ */
+struct FxBenchResult {
+    uint32_t setupUs;       // time spent in the Setup state
+    uint32_t frames;        // number of frames rendered in Running state
+    uint32_t polls;         // number of Running state steps that did not render anything
+    uint64_t frameUs;       // total time spent rendering frames in Running state
+    uint64_t pollUs;        // total time spent in polling steps
+    uint32_t worstUs;       // worst case Running state step
+    uint32_t windDownFrames;    // number of frames rendered while winding down
+    uint32_t windDownWorstUs;   // worst case WindDown state step
+};
+
+uint32_t get_millisecond_timer();
+
+void fxBenchmark();
+void easeBenchmark();
+void paletteBenchmark();
+void kernelBenchmark();
+void selectionBenchmark();
+void particleBenchmark();
+void fireBenchmark();
+void transitionBenchmark();
+void litMapCheck();
+void renderBenchmark();
+
+#endif
+
+#endif //ARDUINO_LIGHTFX_FX_BENCH_H
@@ -0,0 +1,42 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_FX_CATALOG_H
+#define ARDUINO_LIGHTFX_FX_CATALOG_H
+
+#include <Arduino.h>
+
+class LedEffect;
+
+#define FX_NOT_FOUND    UINT16_MAX      // catalog index of an unknown effect id
+
+typedef LedEffect *(*EffectFactory)();
+
+enum EffectFlags:uint8_t {
+    FxFlagNone  = 0x00,
+    FxFlagSleep = 0x01,     // the sleep light effect - selected when entering the sleep state
+    FxFlagArena = 0x02,     // allocates its scratch state from the arena in setup - see ScratchArena
+    FxFlagBlocking = 0x04   // renders whole sequences in one step, showing its own frames - cannot share the FX task with another effect
+};
+
+/**
+ * Compile-time description of an effect - the catalog of these is resident in flash. The effect instance is created through
+ * the factory only when the effect is first needed (e.g. selected to run), hence effects never selected cost no RAM.
+ */
+struct EffectDesc {
+    const char *id;             // effect id (name), e.g. FXA1 - category letter at position 2, followed by the effect number
+    const char *description;
+    EffectFactory factory;
+    uint8_t weight;             // random selection weight; 0 excludes the effect from random selection
+    uint8_t halloweenWeight;    // random selection weight during Halloween
+    uint8_t flags;              // EffectFlags
+};
+
+template<class T> LedEffect *makeEffect() { return new T(); }
+
+extern const EffectDesc effectCatalog[];
+extern const uint16_t effectCatalogSize;
+
+uint16_t fxCatalogIndex(const char *id);
+
+#endif //ARDUINO_LIGHTFX_FX_CATALOG_H
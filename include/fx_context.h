@@ -0,0 +1,35 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_FX_CONTEXT_H
+#define ARDUINO_LIGHTFX_FX_CONTEXT_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "config.h"
+#include "output_map.h"
+
+enum OpMode { TurnOff, Chase };
+
+/**
+ * Effect state held in the globals - the side buffer, the palettes, the parameters <code>resetGlobals</code> resets and the output
+ * mapping of the frame the effect rendered (see OutputMapper). Effects
+ * stepping in turn on the FX task (crossfade, layers) each keep a context, restored into the globals before their step and saved back
+ * after it, such that neither sees the other's state - nor its setup resetting the globals.
+ */
+struct FxContext {
+    CRGB side[PIXEL_BUFFER_SPACE];
+    CRGBPalette16 palette;
+    CRGBPalette16 targetPalette;
+    OpMode mode;
+    uint8_t brightness, colorIndex, lastColorIndex, fade, hue, delta, saturation, dotBpm;
+    uint16_t hueDiff, speed, curPos;
+    int32_t dist;
+    bool dirFwd;
+    OutputMapping mapping;
+
+    void save();
+    void restore() const;
+};
+
+#endif //ARDUINO_LIGHTFX_FX_CONTEXT_H
@@ -0,0 +1,81 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_FX_STATS_H
+#define ARDUINO_LIGHTFX_FX_STATS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <pico/mutex.h>
+#include <vector>
+
+#define TIME_HIST_BUCKETS   64      // log-linear buckets - 4 per power of two, covering 0 to 131ms in microseconds
+#define TIME_HIST_ROLL      2048    // number of samples after which the bucket counts are halved - keeps the histogram rolling
+#define TRANSITION_TYPES    6       // number of transition (off) effects - see EffectTransition
+
+/**
+ * Rolling histogram of time durations in microseconds with log-linear buckets (12% resolution). Once the number of samples
+ * reaches <code>TIME_HIST_ROLL</code> all counts are halved, such that the percentiles follow recent behavior. The max value is
+ * tracked exactly since last reset.
+ */
+class TimeHistogram {
+    uint16_t buckets[TIME_HIST_BUCKETS] {};
+    uint16_t count = 0;
+    uint32_t maxUs = 0;
+    uint32_t total = 0;
+public:
+    void add(uint32_t us);
+    [[nodiscard]] uint32_t percentile(uint8_t pct) const;
+    [[nodiscard]] uint32_t getMax() const { return maxUs; }
+    [[nodiscard]] uint32_t getTotal() const { return total; }
+    void reset();
+    void toJson(const JsonObject &json) const;
+    static uint8_t bucket(uint32_t us);
+    static uint32_t bucketValue(uint8_t idx);
+};
+
+/**
+ * Timing statistics for one effect
+ */
+struct EffectTiming {
+    TimeHistogram frame;        // Running state steps that rendered (showed) a frame - includes the show time
+    uint32_t setupMaxUs = 0;    // worst case setup time
+    uint32_t shows = 0;         // number of shows issued while running
+    uint32_t skipped = 0;       // number of shows skipped while running - frame unchanged
+    uint64_t showUs = 0;        // total time spent showing while running
+    uint16_t arenaBytes = 0;    // scratch arena bytes allocated during setup - see ScratchArena
+};
+
+/**
+ * Always-on effect timing instrumentation based on the RP2040 1us hardware timer. Keeps rolling histograms of frame time per
+ * effect, of the wind down step time per transition type and of the strip show time, as well as counters of the shows skipped
+ * for unchanged frames.
+ * <p>Written by the FX task only; the per effect entries are allocated lazily, first time an effect runs. Read by the web server from
+ * the other core - writers and the reader hold the mutex, the reader only long enough to copy the statistics it marshals.</p>
+ */
+class FxTimingStats {
+    std::vector<EffectTiming*> effects;
+    TimeHistogram transitions[TRANSITION_TYPES];
+    TimeHistogram show;
+    uint32_t showCount = 0;
+    uint32_t skipCount = 0;
+    uint64_t skipUs = 0;
+    uint32_t loopShowMark = 0;
+    uint32_t loopSkipMark = 0;
+    uint32_t loopShowUs = 0;
+    mutable mutex_t mutex {};
+    EffectTiming *timing(uint16_t fxIndex);
+public:
+    void begin(uint16_t fxCount);
+    void recordShow(uint32_t us);
+    void recordSkip(uint32_t us);
+    void loopStart() { loopShowMark = showCount; loopSkipMark = skipCount; loopShowUs = 0; }
+    void recordLoop(uint16_t fxIndex, uint8_t state, uint8_t transitionType, uint32_t us);
+    void recordArena(uint16_t fxIndex, size_t bytes);
+    [[nodiscard]] size_t arenaNeed(uint16_t fxIndex) const;
+    void stats(const JsonObject &json) const;
+};
+
+extern FxTimingStats fxTiming;
+
+#endif //ARDUINO_LIGHTFX_FX_STATS_H
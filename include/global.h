@@ -15,10 +15,13 @@
 #define qsuba(x, b) (((x)>(b))?(x-b):0)                             // Level shift. . . Unsigned subtraction macro. if result <0, then x=0. Otherwise x=x-b.
 #define asub(a, b)  (((a)>(b))?(a-b):(b-a))
 
-#define LED_EFFECT_ID_SIZE  6
 #define MAX_EFFECTS_HISTORY 20
 #define AUDIO_HIST_BINS_COUNT   10
 #define FX_SLEEPLIGHT_ID    "FXA6"
+#define FX_AUDIO_BUMP_ID    "FXB3"      // effect flashed over the running effect on an audio bump - see AUDIO_BUMP_LAYER
+#define AUDIO_BUMP_FLASH_MS 3000        // how long an audio bump flash lasts
+#define AUDIO_BUMP_DEBOUNCE_MS 30000    // minimum time between two audio bump reactions, keeps a noisy mic from strobing the strip
+#define AUDIO_BUMP_ADVANCE  0           // 1 - an audio bump advances to the next effect instead of flashing FX_AUDIO_BUMP_ID
 
 /**
  * Add one byte to another, saturating at given cap value
@@ -0,0 +1,36 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_INDEX_PERM_H
+#define ARDUINO_LIGHTFX_INDEX_PERM_H
+
+#include <cstdint>
+
+/**
+ * Keyed pseudo-random permutation of the indexes [0, size) - a format preserving cipher: a balanced Feistel network over the smallest
+ * even bit width covering the size, with cycle walking to stay within the range (values falling outside are enciphered again; the
+ * domain is less than 4 times the size, hence less than 4 rounds on average).
+ * <p>Evaluates <code>i -> π(i)</code> on demand in O(1) time with O(1) memory - no materialized shuffled array. Reseeding is
+ * instantaneous, and the same seed always yields the same permutation, such that effects can replay a shuffle.</p>
+ */
+class IndexPermutation {
+public:
+    static constexpr uint8_t rounds = 4;
+private:
+    uint32_t keys[rounds] {};
+    uint16_t n = 0;
+    uint8_t halfBits = 1;
+    uint16_t halfMask = 1;
+
+    [[nodiscard]] uint32_t encipher(uint32_t x) const;
+public:
+    IndexPermutation() = default;
+    IndexPermutation(uint16_t size, uint32_t seed);
+
+    void reset(uint16_t size, uint32_t seed);
+    void reseed(uint32_t seed);
+    [[nodiscard]] uint16_t operator()(uint16_t i) const;
+    [[nodiscard]] uint16_t size() const { return n; }
+};
+
+#endif //ARDUINO_LIGHTFX_INDEX_PERM_H
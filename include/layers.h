@@ -0,0 +1,113 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_LAYERS_H
+#define ARDUINO_LIGHTFX_LAYERS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <FastLED.h>
+#include <pico/mutex.h>
+#include "config.h"
+#include "fx_context.h"
+
+#define FX_LAYERS           2       // overlay layers stacked above the running effect - each takes a pixel buffer of NUM_PIXELS
+#define LAYER_BLOCK_SIZE    16      // pixels per block - dark blocks of a layer are skipped when compositing
+#define LAYER_APPLY_WAIT_MS 250     // how long a configuration request waits for the FX task to apply it - see LayerStack::waitApplied
+#define AUDIO_BUMP_LAYER    (FX_LAYERS-1)   // layer slot audio bumps flash on, when not configured otherwise - the top one
+
+enum BlendMode : uint8_t {BlendNormal, BlendAdd, BlendScreen, BlendMultiply, BlendOverlay, BlendModeCount};
+
+class LedEffect;
+
+/**
+ * An overlay layer - an effect instance rendering in its own pixel buffer, mixed over the layers below with a blend mode and an opacity,
+ * within a pixel range (the segment mask)
+ */
+struct Layer {
+    LedEffect *fx = nullptr;
+    BlendMode mode = BlendNormal;
+    uint8_t opacity = 0;
+    uint16_t lo = 0;            // first pixel of the segment mask
+    uint16_t hi = 0;            // end of the segment mask (exclusive)
+};
+
+/**
+ * Layer configuration requested by other tasks, applied by the FX task - see <code>LayerStack::configure</code>
+ */
+struct LayerConfig {
+    uint16_t fxIndex = 0;
+    BlendMode mode = BlendNormal;
+    uint8_t opacity = 0;        // 0 removes the layer
+    uint16_t lo = 0;
+    uint16_t hi = 0;
+};
+
+/**
+ * N-layer compositor - overlay effects stacked above the running (base) effect, mixed into the frame on its way to the strip (see
+ * <code>showStrip</code>). The base effect keeps owning the LED buffer undisturbed; each overlay effect runs against its own buffer,
+ * swapped in and out of the LED buffer around its steps, and its shows are captured - a layer that rendered a new frame marks the stack
+ * dirty and the frame is shown again.
+ * <p>Compositing is one pass over the frame, block by block: the base block is copied, then each layer overlapping the block is mixed
+ * in. Black is transparent for the normal, add and screen modes - a layer block found all black when the layer rendered is skipped
+ * outright; multiply and overlay leave black unchanged, hence they are skipped over the blocks black so far. Layers with opacity 0 are
+ * not stepped nor mixed, and an unchanged base frame with no dirty layers is not composited again. The cost follows how much of each
+ * layer is actually lit.</p>
+ * <p>Each layer effect keeps its own context of the globals (side buffer, palettes, speed, etc.) - the base effect's context is put
+ * aside while the layers step, such that neither the layer steps nor their setup disturb it. Effects that use the scratch arena,
+ * render in blocking loops or change the output stage (the sleep light) are turned down as layers - see <code>accepts</code>.</p>
+ * <p>Configured from any task through <code>configure</code> - the requests are queued under a mutex and applied by the FX task at its
+ * next step, which publishes the resulting layers for <code>describe</code>. Stepped and composited by the FX task only.</p>
+ * <p>Audio bumps flash an overlay effect on the top layer, when it is free - see <code>AUDIO_BUMP_LAYER</code>.</p>
+ */
+class LayerStack {
+    static constexpr uint16_t numBlocks = (NUM_PIXELS + LAYER_BLOCK_SIZE - 1) / LAYER_BLOCK_SIZE;
+    alignas(4) CRGB buffers[FX_LAYERS][NUM_PIXELS] {};
+    alignas(4) CRGB composed[NUM_PIXELS] {};
+    Layer layers[FX_LAYERS] {};
+    Layer published[FX_LAYERS] {};                          // copy of the layers for other tasks - guarded by the mutex
+    FxContext contexts[FX_LAYERS] {};                       // each layer effect's globals
+    FxContext baseContext {};                               // the base effect's globals, put aside while the layers step
+    uint32_t lit[FX_LAYERS][(numBlocks + 31) / 32] {};     // blocks with at least one pixel not black, per layer
+    LayerConfig pending[FX_LAYERS] {};                      // guarded by the mutex
+    uint8_t pendingMask = 0;                                // layers whose configuration changed - guarded by the mutex
+    uint32_t requested = 0;                                 // sequence number of the last configuration requested - guarded by the mutex
+    volatile uint32_t applied = 0;                          // sequence number of the last configuration applied
+    mutable mutex_t mutex {};
+    uint8_t active = 0;                                     // number of layers with opacity above 0
+    bool capturing = false;
+    bool captured = false;
+    bool dirty = true;
+    bool changed = false;                                   // layers changed since last published
+    //statistics
+    uint32_t composites = 0;
+    uint32_t blocksMixed = 0;
+    uint32_t blocksSkipped = 0;
+    uint64_t composeUs = 0;
+
+    void apply(uint8_t slot, const LayerConfig &cfg);
+    void release(uint8_t slot);
+    bool step(uint8_t slot);
+    void scanLit(uint8_t slot);
+    void publish();
+    [[nodiscard]] bool isLit(const uint8_t slot, const uint16_t block) const { return lit[slot][block >> 5] & (1u << (block & 31)); }
+public:
+    uint32_t configure(uint8_t slot, const LayerConfig &cfg);
+    bool waitApplied(uint32_t seq, uint32_t timeoutMs = LAYER_APPLY_WAIT_MS) const;
+    void loop();
+    [[nodiscard]] LedEffect *effect(const uint8_t slot) const { return slot < FX_LAYERS ? layers[slot].fx : nullptr; }
+    [[nodiscard]] bool isActive() const { return active > 0; }
+    [[nodiscard]] bool isDirty() const { return dirty; }
+    [[nodiscard]] bool isCapturing() const { return capturing; }
+    void frameCaptured() { captured = true; }
+    const CRGB *compose(const CRGB *base);
+    void describe(const JsonArray &json) const;
+    void stats(const JsonObject &json) const;
+    static const char *modeName(BlendMode mode);
+    static BlendMode parseMode(const char *name);
+    static bool accepts(uint16_t fxIndex);
+};
+
+extern LayerStack fxLayers;
+
+#endif //ARDUINO_LIGHTFX_LAYERS_H
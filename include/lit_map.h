@@ -0,0 +1,46 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_LIT_MAP_H
+#define ARDUINO_LIGHTFX_LIT_MAP_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "config.h"
+
+#define LIT_BLOCK_SIZE  16      // pixels summarized by one block of the lit map
+
+/**
+ * Per block summary of a pixel buffer - for each block of <code>LIT_BLOCK_SIZE</code> pixels it keeps an upper bound of the block's
+ * max luma. Blocks whose bound is at or below a threshold are skipped without reading their pixels; only the blocks that may be
+ * brighter are scanned, which also tightens their bound to the exact max. Hence "is anything lit" and "how many pixels are brighter"
+ * cost O(blocks) plus the pixels of the blocks still lit.
+ * <p>The bounds stay valid through writes that do not brighten pixels - fading, blending towards black, turning pixels off - which is
+ * all the turn off transitions do, with the exception of shifts: those move the bounds along with the pixels (see <code>shifted</code>).
+ * Any other write must be followed by <code>invalidate</code> - the effect state machine does this after every step other than
+ * wind down.</p>
+ * <p>Only the first pixels of the buffer are summarized, the logical ones the strip shows - see <code>resize</code>.</p>
+ */
+class LitMap {
+    static constexpr uint16_t numBlocks = (NUM_PIXELS + LIT_BLOCK_SIZE - 1) / LIT_BLOCK_SIZE;
+    const CRGB *buf;
+    uint8_t bound[numBlocks] {};
+    uint16_t pixels = NUM_PIXELS;   // pixels summarized - the ones shown
+    uint16_t blocks = numBlocks;    // blocks covering them
+
+    uint8_t rescan(uint16_t block);
+public:
+    explicit LitMap(const CRGB *pixels);
+
+    void resize(uint16_t count);
+    void invalidate();
+    void invalidate(uint16_t lo, uint16_t hi);
+    void shifted(uint16_t lo, uint16_t hi, int16_t by);
+    bool anyBrighter(uint8_t luma);
+    uint16_t countBrighter(uint8_t luma);
+    [[nodiscard]] uint16_t litBlocks(uint8_t luma) const;
+};
+
+extern LitMap litMap;
+
+#endif //ARDUINO_LIGHTFX_LIT_MAP_H
@@ -0,0 +1,30 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_LOOP_SPAN_H
+#define ARDUINO_LIGHTFX_LOOP_SPAN_H
+
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * Loops (circular shift) a span of elements to the right - the elements falling off the right end enter through the left. In place
+ * through <code>std::rotate</code>: O(n), no temporary buffer on the (small) task stack. Header only, no FastLED dependency - see
+ * <code>loopRight</code> for the pixel set flavor.
+ * @tparam T element type
+ * @param span first element of the span, in memory order
+ * @param len number of elements
+ * @param pos number of positions to loop - wraps around the span length
+ * @param reversed whether the logical order of the span runs against memory order (e.g. a reversed CRGBSet) - looping right is then
+ * looping left in memory
+ */
+template<typename T> void loopSpan(T *span, const uint16_t len, uint16_t pos, const bool reversed = false) {
+    if (len == 0)
+        return;
+    pos %= len;
+    if (pos == 0)
+        return;
+    std::rotate(span, span + (reversed ? pos : len - pos), span + len);
+}
+
+#endif //ARDUINO_LIGHTFX_LOOP_SPAN_H
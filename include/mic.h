@@ -5,9 +5,10 @@
 #ifndef ARDUINO_LIGHTFX_MIC_H
 #define ARDUINO_LIGHTFX_MIC_H
 
-#include "circular_buffer.h"
+#include "spsc_ring.h"
 
-extern CircularBuffer<short> *audioData;
+extern SpscRing<short, 1024> audioData;
+extern volatile uint32_t audioOverruns;
 
 void mic_setup();
 
@@ -0,0 +1,43 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_OUTPUT_LUT_H
+#define ARDUINO_LIGHTFX_OUTPUT_LUT_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "config.h"
+
+/**
+ * Output stage color transform - one 256 entry lookup table per channel combining the gamma curve, the color correction of the LED
+ * chip, the color temperature and the brightness the strip is shown at (the time of day dim curve is part of it, see
+ * <code>adjustStripBrightness</code>). The LED buffer is transformed through the tables into the output buffer pushed to the strip
+ * (see <code>FrameOutput</code>), in one pass at show time; FastLED itself applies no scaling, correction or dithering. The same pass
+ * gathers the physical pixels from the logical ones, when the strip topology is not the identity (see <code>Topology</code>).
+ * <p>Each table entry is rounded once from the 8.8 fixed point gamma curve scaled by all the factors, rather than truncated by
+ * successive 8 bit scalings - dim colors keep their hue. The tables are rebuilt only when one of the inputs changes.</p>
+ */
+class OutputLut {
+    uint16_t gammaCurve[256] {};    // gamma curve - output in 8.8 fixed point, full range 0-255
+    uint8_t lut[3][256] {};
+    CRGB correction = UncorrectedColor;
+    CRGB temperature = UncorrectedTemperature;
+    uint8_t brightness = 255;
+    uint16_t gen = 0;
+    bool stale = true;
+
+    void rebuild();
+    void changed();
+public:
+    void begin(float gamma, CRGB ledCorrection, CRGB colorTemperature);
+    void setCorrection(CRGB ledCorrection);
+    void setTemperature(CRGB colorTemperature);
+    void setBrightness(uint8_t scale);
+    void apply(const CRGB *src, CRGB *dest, const uint16_t *gather = nullptr);
+    [[nodiscard]] uint8_t getBrightness() const { return brightness; }
+    [[nodiscard]] uint16_t generation() const { return gen; }
+};
+
+extern OutputLut outputLut;
+
+#endif //ARDUINO_LIGHTFX_OUTPUT_LUT_H
@@ -0,0 +1,73 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_OUTPUT_MAP_H
+#define ARDUINO_LIGHTFX_OUTPUT_MAP_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "config.h"
+
+/**
+ * Rules for expanding a logical frame (e.g. the template <code>tpl</code>) across the rest of the strip
+ */
+enum OutputRule:uint8_t {
+    Repeat,     // frame, frame, frame...
+    Mirror,     // frame, reversed frame, frame, reversed frame...
+    Reverse     // frame, reversed frame, reversed frame...
+};
+
+/**
+ * Mapping of a logical frame onto the region of the LED buffer right after it - positions are LED buffer indices, such that the
+ * mapping holds for any pixel buffer laid out as the LED buffer (e.g. the crossfade and layer buffers)
+ */
+struct OutputMapping {
+    uint16_t start = 0;         // first pixel of the logical frame
+    uint16_t frameLen = 0;      // logical frame length
+    uint16_t totalLen = 0;      // length of the output region, logical frame included
+    OutputRule rule = Repeat;
+    bool active = false;
+
+    [[nodiscard]] uint16_t source(uint16_t i) const;
+    void copy(CRGB *dest, const CRGB *src, uint16_t lo, uint16_t hi) const;
+    bool operator==(const OutputMapping &other) const;
+};
+
+/**
+ * Output stage mapping of a logical frame onto the physical strip. Rather than copying the frame pixel by pixel each time an
+ * effect replicates it, the mapping is recorded and the replicated region is never written - the output stage gathers each pixel
+ * of the region from the logical frame, in the same pass as the color transform and the strip topology (see <code>gather</code>
+ * and <code>OutputLut::apply</code>). The gather table is built once per mapping, and effects replicating the same frame every step
+ * keep the same mapping.
+ * <p>The replicated region of the LED buffer is virtual while the mapping holds: writes to it are superseded by the mapping, same as
+ * when the region was expanded right before showing. The mapping holds across steps, until the effect maps a different frame, the
+ * strip is cleared or the whole buffer is needed - the wind down transitions, or replications overlapping the region, materialize
+ * it first (see <code>apply</code>). Effects stepping in turn on the FX task keep their mapping in their context (see FxContext).</p>
+ * <p>Only frames of the LED buffer immediately followed by their destination, clipped to the logical pixels, are mapped (e.g.
+ * <code>tpl</code> and <code>others</code>, or the halves of <code>mirrorLow</code>); any other source/destination combination is
+ * replicated right away. The mapping is composed ahead of the topology gather - the segments of a topology mirror group show the
+ * replicated frame as is, the two never stack.</p>
+ */
+class OutputMapper {
+    OutputMapping current {};
+    uint16_t gatherLut[NUM_PIXELS] {};      // output pixel -> LED buffer pixel, topology and mapping composed
+    const uint16_t *lutTopology = nullptr;  // topology gather table the gather table has been built for
+    uint32_t gen = 1;                       // mapping generation - starts past 0, bumped at each change
+    uint32_t lutGen = 0;                    // mapping generation the gather table has been built for
+
+    static void expand(CRGB *block, uint16_t blockLen, const CRGB *end);
+public:
+    bool map(const CRGBSet &src, const CRGBSet &dest, OutputRule outRule = Repeat);
+    void apply();
+    void cancel();
+    void restore(const OutputMapping &mapping);
+    [[nodiscard]] bool overlaps(const CRGBSet &set) const;
+    const uint16_t *gather(const uint16_t *topology);
+    [[nodiscard]] const OutputMapping &mapping() const { return current; }
+    [[nodiscard]] bool isPending() const { return current.active; }
+    [[nodiscard]] uint32_t generation() const { return gen; }
+};
+
+extern OutputMapper outputMap;
+
+#endif //ARDUINO_LIGHTFX_OUTPUT_MAP_H
@@ -0,0 +1,57 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_PALETTE_CACHE_H
+#define ARDUINO_LIGHTFX_PALETTE_CACHE_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+/**
+ * A 16-entry palette expanded into 256 colors - each entry is <code>ColorFromPalette(pal, index, 255, LINEARBLEND)</code>, such
+ * that a lookup is an array read plus an optional brightness scaling, rather than a 16-entry interpolation per pixel.
+ * <p>A cache tracking a palette (e.g. the global <code>palette</code>) keeps a snapshot of the palette it was expanded from;
+ * <code>sync()</code> compares it with the tracked palette and expands again only when the palette has actually changed -
+ * e.g. <code>nblendPaletteTowardPalette</code> converged, or nothing new came from the <code>PaletteFactory</code>.
+ * A cache without a tracked palette is expanded explicitly, once, for palettes that never change.</p>
+ */
+class PaletteCache {
+    const CRGBPalette16 *tracked;
+    CRGBPalette16 snapshot;
+    CRGB table[256];
+    bool valid = false;
+public:
+    explicit PaletteCache(const CRGBPalette16 *trackedPal = nullptr) : tracked(trackedPal) {}
+
+    void expand(const CRGBPalette16 &pal);
+    bool sync();
+    void invalidate() { valid = false; }
+    [[nodiscard]] bool isValid() const { return valid; }
+
+    /**
+     * Palette color lookup - same result as <code>ColorFromPalette(pal, index, brightness, LINEARBLEND)</code>
+     * @param index palette index
+     * @param brightness brightness to scale the color down to
+     * @return the palette color at given index and brightness
+     */
+    [[nodiscard]] CRGB color(const uint8_t index, const uint8_t brightness = 255) const {
+        CRGB c = table[index];
+        if (brightness == 255)
+            return c;
+        if (brightness == 0)
+            return CRGB::Black;
+        //ColorFromPalette bumps the brightness by one before scale8 - with FASTLED_SCALE8_FIXED that is a (brightness+2)/256 factor
+        const uint16_t scale = brightness + 2;
+        c.r = (c.r * scale) >> 8;
+        c.g = (c.g * scale) >> 8;
+        c.b = (c.b * scale) >> 8;
+        return c;
+    }
+};
+
+extern PaletteCache paletteCache;
+extern PaletteCache targetPaletteCache;
+
+void syncPaletteCaches();
+
+#endif //ARDUINO_LIGHTFX_PALETTE_CACHE_H
@@ -0,0 +1,64 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_PARTICLES_H
+#define ARDUINO_LIGHTFX_PARTICLES_H
+
+#include <cstdint>
+
+/**
+ * Fixed capacity pool of particles laid out as a structure of arrays - each attribute is a contiguous array indexed by the particle
+ * slot, such that the batched passes (<code>move</code>, <code>age</code>) stream through one or two arrays rather than striding
+ * over whole particle objects. Position and velocity are signed 15.16 fixed point (in pixels and pixels per step) - no floating point.
+ * <p>The arrays are carved out of the scratch arena at <code>begin()</code>, hence the pool is valid only while its effect is active;
+ * nothing is allocated afterwards. Live slots are tracked in a bitmap - spawning claims the first clear bit, iterating skips
+ * 32 dead slots at a time.</p>
+ * <p>No FastLED or core dependencies, such that the pool is unit tested on the host - see test/test_particles.</p>
+ */
+class ParticlePool {
+    uint32_t *liveMap = nullptr;
+    uint16_t cap = 0;
+    uint16_t live = 0;
+public:
+    using fixed = int32_t;          // signed 15.16 fixed point - same representation as FastLED's saccum1516
+
+    fixed *pos = nullptr;      // position in pixels, 15.16 fixed point
+    fixed *vel = nullptr;      // velocity in pixels per step, 15.16 fixed point
+    uint8_t *hue = nullptr;         // palette index or hue
+    uint8_t *bright = nullptr;      // brightness
+    uint8_t *life = nullptr;        // remaining steps - see age()
+    uint8_t *aux = nullptr;         // effect specific attribute (e.g. fade rate)
+
+    static constexpr fixed toFixed(const int16_t px) { return static_cast<fixed>(px) * 65536; }
+    static constexpr int16_t toPixel(const fixed fx) { return static_cast<int16_t>(fx >> 16); }
+
+    bool begin(uint16_t capacity);
+    int16_t spawn();
+    void kill(uint16_t i);
+    void clear();
+    void move(fixed accel, fixed lo, fixed hi);
+    void age(uint8_t steps = 1);
+
+    [[nodiscard]] bool isAlive(const uint16_t i) const { return liveMap[i >> 5] & (1u << (i & 0x1F)); }
+    [[nodiscard]] uint16_t count() const { return live; }
+    [[nodiscard]] uint16_t capacity() const { return cap; }
+    [[nodiscard]] int16_t pixel(const uint16_t i) const { return toPixel(pos[i]); }
+
+    /**
+     * Invokes the function provided for each live particle, in slot order. The function may kill the particle it is called for.
+     * @param fn callable taking the particle slot - <code>void(uint16_t)</code>
+     */
+    template<typename F> void forEach(F &&fn) const {
+        const uint16_t words = (cap + 31) >> 5;
+        for (uint16_t w = 0; w < words; w++) {
+            uint32_t bits = liveMap[w];
+            while (bits) {
+                const uint16_t i = (w << 5) + __builtin_ctz(bits);
+                bits &= bits - 1;
+                fn(i);
+            }
+        }
+    }
+};
+
+#endif //ARDUINO_LIGHTFX_PARTICLES_H
@@ -0,0 +1,26 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_PIXEL_KERNELS_H
+#define ARDUINO_LIGHTFX_PIXEL_KERNELS_H
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Pixel buffer kernels working on the raw channel bytes of contiguous CRGB arrays. The scaling and blending kernels are SWAR
+ * (SIMD within a register) - each 32-bit word is split in two sets of 16-bit lanes, such that one multiply processes two channels
+ * and one word (4 channels) takes 2 multiplies. They are bit-exact with FastLED's <code>nscale8</code> and <code>nblend</code>
+ * (FASTLED_SCALE8_FIXED=1 variants).
+ * <p>The blend mode kernels (multiply, screen, overlay) need a product of two varying channels - the Cortex-M0+ has no per-lane
+ * multiply, so these remain one multiply per channel, inlined in a flat byte loop - no per-pixel calls or iterators.</p>
+ */
+
+void scaleBytes(uint8_t *p, size_t n, uint8_t scale);
+void blendBytes(uint8_t *dst, const uint8_t *src, size_t n, uint8_t amountOfSrc);
+void blendColorBytes(uint8_t *dst, size_t nPixels, const uint8_t color[3], uint8_t amountOfColor);
+void multiplyBytes(uint8_t *dst, const uint8_t *src, size_t n);
+void screenBytes(uint8_t *dst, const uint8_t *src, size_t n);
+void overlayBytes(uint8_t *dst, const uint8_t *src, size_t n);
+
+#endif //ARDUINO_LIGHTFX_PIXEL_KERNELS_H
@@ -0,0 +1,55 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_SPAN_RENDER_H
+#define ARDUINO_LIGHTFX_SPAN_RENDER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+
+#define SPAN_RENDER_MIN     32      // spans shorter than this are rendered on the calling core - not worth the cross-core hand over
+
+/**
+ * Range kernel - renders the elements [lo, hi) of a span. Must only write the elements in its range, and only read state that is
+ * not changed by the kernel over the rest of the span.
+ */
+using SpanKernel = void (*)(void *ctx, uint16_t lo, uint16_t hi);
+
+/**
+ * Frame parallel rendering across the two RP2040 cores - a span is split in two, the upper part is handed to the Render task on the
+ * other core while the calling core renders the lower part, then the caller waits for the Render task to finish (the cross-core
+ * barrier) before returning. The caller's share of the span is adjustable, for kernels whose cost is not uniform over the span (e.g.
+ * that need to walk the span from the start to derive their state at the start of the range).
+ * <p>Renders on the calling core alone until the Render task is attached, when disabled, or for short spans.</p>
+ */
+class SpanRenderer {
+    TaskHandle_t volatile helper = nullptr;     // the Render task
+    SemaphoreHandle_t done = nullptr;           // given by the Render task when its part is rendered
+    SpanKernel volatile job = nullptr;
+    void *volatile jobCtx = nullptr;
+    volatile uint16_t jobLo = 0;
+    volatile uint16_t jobHi = 0;
+    bool enabled = true;
+    uint32_t parallelSpans = 0;
+    uint32_t serialSpans = 0;
+    uint32_t barrierWaits = 0;                  // spans where the caller finished first and waited on the Render task
+    uint64_t barrierWaitUs = 0;
+public:
+    void attach();
+    void run();
+    void render(SpanKernel kernel, void *ctx, uint16_t lo, uint16_t hi, uint8_t callerShare = 128);
+    void enable(bool parallel) { enabled = parallel; }
+    [[nodiscard]] bool isParallel() const { return enabled && helper != nullptr; }
+    void stats(const JsonObject &json) const;
+};
+
+extern SpanRenderer spanRender;
+
+void render_setup();
+
+void render_run();
+
+#endif //ARDUINO_LIGHTFX_SPAN_RENDER_H
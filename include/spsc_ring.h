@@ -0,0 +1,160 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_SPSC_RING_H
+#define ARDUINO_LIGHTFX_SPSC_RING_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * Contiguous run of elements inside a ring buffer - zero-copy access to the ring's storage
+ */
+template<typename T> struct RingSpan {
+    T *data;
+    size_t size;
+};
+
+/**
+ * Lock-free single producer - single consumer ring buffer with a power of two capacity.
+ * <p>The producer only writes <code>head</code> and the consumer only writes <code>tail</code>; both are running counters
+ * (not wrapped), masked into the storage on access - no modulo and no "full" flag. Publishing is an atomic store with
+ * release semantics, observed with acquire semantics on the other side, hence the producer and consumer can run on
+ * different cores without locks. Bulk operations are at most two <code>memcpy</code> calls.</p>
+ * <p>Unlike the mutex based circular buffer it replaces, a full ring does not overwrite the oldest elements - the producer
+ * cannot move the consumer's tail. A producer that is also the only reader can make room with <code>consume</code>.</p>
+ * @tparam T element type, trivially copyable
+ * @tparam N capacity, a power of 2
+ */
+template<typename T, size_t N> class SpscRing {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of 2");
+    static_assert(std::is_trivially_copyable_v<T>, "SpscRing elements are copied with memcpy");
+    static constexpr size_t MASK = N - 1;
+
+    T buffer[N] {};
+    std::atomic<size_t> head {0};   // elements written - producer owned
+    std::atomic<size_t> tail {0};   // elements read - consumer owned
+
+public:
+    static constexpr size_t capacity() { return N; }
+    [[nodiscard]] size_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+    [[nodiscard]] size_t available() const { return N - size(); }
+    [[nodiscard]] bool empty() const { return size() == 0; }
+    [[nodiscard]] bool full() const { return size() == N; }
+
+    // ---- producer side ----
+
+    /**
+     * Appends one element
+     * @param value element to append
+     * @return true if appended; false if the ring is full
+     */
+    bool push(const T &value) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == N)
+            return false;
+        buffer[h & MASK] = value;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Appends a block of elements - as many as there is room for
+     * @param src elements to append
+     * @param count number of elements
+     * @return number of elements appended
+     */
+    size_t push(const T *src, const size_t count) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        const size_t n = min(count, N - (h - tail.load(std::memory_order_acquire)));
+        const size_t ofs = h & MASK;
+        const size_t first = min(n, N - ofs);
+        memcpy(buffer + ofs, src, first * sizeof(T));
+        memcpy(buffer, src + first, (n - first) * sizeof(T));
+        head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * Zero-copy write access - the contiguous free region following the last element. Fill in up to <code>size</code>
+     * elements and publish them with <code>commit</code>
+     * @return the writable region; its size is 0 if the ring is full
+     */
+    RingSpan<T> writeSpan() {
+        const size_t h = head.load(std::memory_order_relaxed);
+        const size_t ofs = h & MASK;
+        return {buffer + ofs, min(N - (h - tail.load(std::memory_order_acquire)), N - ofs)};
+    }
+
+    /**
+     * Publishes elements written through <code>writeSpan</code>
+     * @param count number of elements written, at most the size of the span obtained
+     */
+    void commit(const size_t count) {
+        head.store(head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    // ---- consumer side ----
+
+    /**
+     * Removes the oldest element
+     * @param value receives the element
+     * @return true if an element has been removed; false if the ring is empty
+     */
+    bool pop(T &value) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_acquire) == t)
+            return false;
+        value = buffer[t & MASK];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Removes a block of the oldest elements
+     * @param dest receives the elements
+     * @param count maximum number of elements to remove
+     * @return number of elements removed
+     */
+    size_t pop(T *dest, const size_t count) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        const size_t n = min(count, head.load(std::memory_order_acquire) - t);
+        const size_t ofs = t & MASK;
+        const size_t first = min(n, N - ofs);
+        memcpy(dest, buffer + ofs, first * sizeof(T));
+        memcpy(dest + first, buffer, (n - first) * sizeof(T));
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * Zero-copy read access - the contiguous run of the oldest elements. When the content wraps around the end of the storage,
+     * the rest is available through another <code>readSpan</code> call after <code>consume</code>
+     * @return the readable region; its size is 0 if the ring is empty
+     */
+    RingSpan<const T> readSpan() const {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        const size_t ofs = t & MASK;
+        return {buffer + ofs, min(head.load(std::memory_order_acquire) - t, N - ofs)};
+    }
+
+    /**
+     * Discards the oldest elements - e.g. those read through <code>readSpan</code>
+     * @param count number of elements to discard, capped at the current size
+     */
+    void consume(const size_t count) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        tail.store(t + min(count, head.load(std::memory_order_acquire) - t), std::memory_order_release);
+    }
+
+    /**
+     * Discards all elements
+     */
+    void clear() {
+        tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+};
+
+#endif //ARDUINO_LIGHTFX_SPSC_RING_H
@@ -0,0 +1,75 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_TOPOLOGY_H
+#define ARDUINO_LIGHTFX_TOPOLOGY_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "config.h"
+
+#define TOPOLOGY_MAX_SEGMENTS   16          // segments a topology can describe
+#define TOPOLOGY_DARK           0xFFFFu     // gather table entry of a physical pixel fed by no logical pixel - shown black
+
+/**
+ * Physical run of pixels on the strip
+ */
+struct TopoSegment {
+    uint16_t start = 0;     // first physical pixel
+    uint16_t len = 0;       // number of pixels
+    bool reverse = false;   // the run is wired end to start - logical order runs from the last physical pixel down
+    int8_t mirrorOf = -1;   // segment this one mirrors (shows the same logical pixels as); -1 if it has its own logical pixels
+};
+
+/**
+ * Strip topology - how the logical pixels effects render (the LED buffer) land on the physical strip. Described in the LittleFS file
+ * <code>/topology.json</code>, such that each board gets its geometry without recompiling:
+ * <pre>
+ * {"segments": [{"start": 0, "len": 76}, {"start": 76, "len": 76, "reverse": true}, {"start": 152, "len": 18}],
+ *  "mirrors": [[0, 1]],
+ *  "matrix": {"width": 8, "height": 8, "serpentine": true}}
+ * </pre>
+ * Segments are physical runs, listed in logical order - each takes the next logical pixels, except for the mirrors: all segments of a
+ * mirror group past the first show the first one's logical pixels. The matrix lays a 2D grid over the logical pixels, row by row.
+ * <p>The description is compiled at boot into flat index tables - the output stage gathers each physical pixel from its logical pixel
+ * in the same pass as the color transform (see <code>OutputLut::apply</code>), and effects address the matrix through
+ * <code>xy</code> - no per pixel index arithmetic in the loops. Without a topology file the mapping is the identity, at no cost.</p>
+ * <p>The geometry is only partly configurable without recompiling: <code>NUM_PIXELS</code> stays the compile time capacity of the LED
+ * buffer and the strip output, and <code>FRAME_SIZE</code> the template frame - a topology must fit the former and leave room past
+ * the latter. Effects, the turn off transitions and the lit map size themselves from <code>logicalSize</code> (see
+ * <code>logicalSet</code>); the LED buffer pixels past the logical ones are not shown, and replications into them are clipped.
+ * Replications of the template frame (see OutputMapper) work on logical pixels, ahead of the topology gather - a mirror group shows
+ * the replicated frame, it does not replicate it again.</p>
+ */
+class Topology {
+    uint16_t gatherLut[NUM_PIXELS] {};  // physical pixel -> logical pixel it shows, TOPOLOGY_DARK for none
+    uint16_t xyLut[NUM_PIXELS] {};      // matrix cell (row major) -> logical pixel
+    TopoSegment segs[TOPOLOGY_MAX_SEGMENTS] {};
+    uint8_t numSegs = 0;
+    uint16_t logical = NUM_PIXELS;      // number of logical pixels shown
+    uint16_t width = 0;
+    uint16_t height = 0;
+    bool identity = true;
+
+    bool compile(bool serpentine);
+    void reset();
+public:
+    bool load(const char *fname);
+    [[nodiscard]] const uint16_t *gather() const { return identity ? nullptr : gatherLut; }
+    [[nodiscard]] bool isIdentity() const { return identity; }
+    [[nodiscard]] uint16_t logicalSize() const { return logical; }
+    [[nodiscard]] uint16_t matrixWidth() const { return width; }
+    [[nodiscard]] uint16_t matrixHeight() const { return height; }
+    /**
+     * Logical pixel of a matrix cell - valid only when a matrix is described, for cells within its width and height
+     * @param x column
+     * @param y row
+     * @return the logical pixel index
+     */
+    [[nodiscard]] uint16_t xy(const uint16_t x, const uint16_t y) const { return xyLut[y * width + x]; }
+    void describe(const JsonObject &json) const;
+};
+
+extern Topology topology;
+
+#endif //ARDUINO_LIGHTFX_TOPOLOGY_H
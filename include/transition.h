@@ -5,7 +5,8 @@
 #define ARDUINO_LIGHTFX_TRANSITION_H
 
 #include <Arduino.h>
-#include <deque>
+#include "fixed_queue.h"
+#include "config.h"
 
 #define SELECTOR_SPOTS  0x0100
 #define SELECTOR_WIPE   0x0200
@@ -22,6 +23,8 @@ public:
     bool transition();
     void prepare(uint selector = 0);
     uint selector() const;
+    [[nodiscard]] uint8_t type() const;
+    static const char *typeName(uint8_t type);
     void resetRandomBars();
     //fade off effects
     bool offSpots();
@@ -40,7 +43,7 @@ protected:
     uint16_t offPosIndex;
     uint16_t offSpotSegSize;
     //offRandomBars variables
-    std::deque<uint8_t> randomBarSegs;
+    FixedQueue<uint8_t, NUM_PIXELS/3+1> randomBarSegs;    //segments are at least 3 pixels long
 };
 
 extern EffectTransition transEffect;
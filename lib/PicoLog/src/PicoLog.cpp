@@ -15,7 +15,6 @@ DummyLog Log;
 #endif
 TaskWrapper *twStream;
 
-#define SERIAL_BUFFER_SIZE 256
 static constexpr char fmtTimestamp[] PROGMEM = "%02lu:%02lu:%02lu.%03lu";
 static constexpr char fmtTaskPriorityChanged[] PROGMEM = " [%s-%u/%u]";
 static constexpr char fmtTaskPriorityRegular[] PROGMEM = " [%s-%u]";
@@ -25,21 +24,24 @@ static constexpr char fmtLevel[] PROGMEM = " %c: ";
 #if LOGGING_ENABLED == 1
 /**
  * Flushes the log data queue by processing and outputting all queued log messages.
+ * The log records are written to the stream straight from the queue storage (no intermediate copy) and released afterwards.
  * If the log queue is empty, delays execution briefly to allow for log gathering.
  */
 void flushData() {
-    if (Log.m_queue.empty()) {
-        vTaskDelay(pdMS_TO_TICKS(250)); //empty log queue, allow some time to collect log statements
-        return;
-    }
     if (const size_t logSize = Log.m_queue.size(); logSize > Log.m_maxBufferSize)
         Log.m_maxBufferSize = logSize;
-    while (!Log.m_queue.empty()) {
-        char buf[SERIAL_BUFFER_SIZE]{0};    //zero-initialized buffer
-        const size_t sz = min(Log.m_queue.size(), SERIAL_BUFFER_SIZE);    //leave room for null terminator
-        Log.m_queue.pop_front(buf, sz);
-        buf[sz] = '\0'; //may not be needed, we're writing out the exact size of buffer read
-        Log.m_stream->write(buf, sz);
+    LogUtil::ByteSpan spans[2];
+    size_t written = 0;
+    while (Log.m_queue.peek(spans)) {
+        for (const auto &span : spans)
+            if (span.size)
+                Log.m_stream->write(span.data, span.size);
+        written += spans[0].size + spans[1].size;
+        Log.m_queue.release();
+    }
+    if (written == 0) {
+        vTaskDelay(pdMS_TO_TICKS(250)); //empty log queue, allow some time to collect log statements
+        return;
     }
     Log.m_stream->flush();
 }
@@ -101,7 +103,7 @@ size_t PicoLog::print(const LogLevel level, const char *format, va_list args) {
     if (isStreamingEnabled())
         m_stream->write(buf, sz + 1);
 #else
-    m_queue.push_back(buf, sz + 1);
+    m_queue.push(buf, sz + 1);
 #endif
 
     return sz;
@@ -5,7 +5,7 @@
 #define PICOLOG_H
 
 #include <Arduino.h>
-#include <util/circular_buffer.h>
+#include <util/mpsc_ring.h>
 
 #ifndef LOGGING_ENABLED
 #define LOGGING_ENABLED 0
@@ -13,14 +13,14 @@
 
 #define CR "\n"
 #define PICO_LOG_VERSION_STR "1.0.0"
-#define LOG_BUFFER_SIZE 10240
+#define LOG_BUFFER_SIZE 8192      //must be a power of 2 - the largest not above the 10KB of the former buffer
 #define LOG_BYPASS_BUFFER false
 
 enum LogLevel:uint8_t {SILENT, FATAL, ERROR, WARNING, INFO, DEBUG, TRACE};
 
 class PicoLog {
   public:
-    PicoLog() : m_queue(LOG_BUFFER_SIZE) {};
+    PicoLog() = default;
     ~PicoLog() = default;
 
     void begin(SerialUSB* serial, LogLevel level = INFO);
@@ -54,7 +54,7 @@ class PicoLog {
 
 private:
     LogLevel m_level{SILENT};
-    LogUtil::CircularBuffer<char> m_queue;
+    LogUtil::MpscByteRing<LOG_BUFFER_SIZE> m_queue;
     Print* m_stream{nullptr};
     time_t m_timebase{0};
     size_t m_maxBufferSize{0};
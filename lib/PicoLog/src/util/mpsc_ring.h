@@ -0,0 +1,126 @@
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+
+#pragma once
+#ifndef PICO_LOG_MPSC_RING_H
+#define PICO_LOG_MPSC_RING_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <cstring>
+#include "hardware/sync.h"
+
+namespace LogUtil {
+    /**
+     * Contiguous run of bytes inside the ring - zero-copy access to the ring's storage
+     */
+    struct ByteSpan {
+        const char *data;
+        size_t size;
+    };
+
+    /**
+     * @class MpscByteRing
+     *
+     * @brief Multi producer - single consumer ring of variable length records (e.g. log lines).
+     *
+     * Producers (any task, any core) reserve room for a record by advancing <code>head</code> under a hardware spin lock, copy the
+     * payload in, then publish the record by storing its header with the committed flag. Producers only contend for the
+     * reservation - a few instructions - never for the copy; a record that does not fit is dropped and counted. The consumer
+     * reads the committed records in order, straight from the ring storage, and releases them - zeroing their bytes, such that a
+     * reserved but not yet committed header always reads as not committed.
+     * <p>Records are 4 byte aligned (a 32-bit header holding the length, followed by the payload) hence headers never wrap
+     * around the end of the storage; payloads may, and are then exposed as two spans.</p>
+     * <p>The Cortex-M0+ has no exclusive access instructions, hence no lock-free compare-and-swap: a <code>std::atomic</code>
+     * read-modify-write compiles into a libatomic call whose cross-core safety depends on the core's runtime. The reservation
+     * takes one of the RP2040 SIO spin locks instead (interrupts off on the calling core for its duration), which is explicitly
+     * safe across cores. Plain 32-bit loads and stores are atomic on the M0+ - the consumer side needs no lock.</p>
+     *
+     * @tparam N capacity in bytes, a power of 2
+     */
+    template<size_t N> class MpscByteRing {
+        static_assert(N >= 8 && (N & (N - 1)) == 0, "MpscByteRing capacity must be a power of 2");
+        static constexpr uint32_t MASK = N - 1;
+        static constexpr uint32_t COMMITTED = 0x80000000u;
+        static constexpr uint32_t HEADER_SIZE = sizeof(uint32_t);
+
+        uint32_t words[N / sizeof(uint32_t)] {};
+        std::atomic<uint32_t> head {0};         // bytes reserved - producers, under the spin lock
+        std::atomic<uint32_t> tail {0};         // bytes released - consumer
+        volatile uint32_t droppedRecords = 0;   // under the spin lock
+        spin_lock_t *const lock = spin_lock_instance(spin_lock_claim_unused(true));
+
+        [[nodiscard]] char *bytes() { return reinterpret_cast<char *>(words); }
+        [[nodiscard]] const char *bytes() const { return reinterpret_cast<const char *>(words); }
+        static constexpr uint32_t recordSize(const uint32_t len) { return (HEADER_SIZE + len + 3) & ~3u; }
+
+    public:
+        static constexpr size_t capacity() { return N; }
+        [[nodiscard]] size_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+        [[nodiscard]] bool empty() const { return size() == 0; }
+        [[nodiscard]] uint32_t dropped() const { return droppedRecords; }
+
+        /**
+         * Appends a record - safe to call concurrently from multiple tasks and cores
+         * @param data record payload
+         * @param len payload length
+         * @return true if appended; false if the record has been dropped for lack of room
+         */
+        bool push(const char *data, const size_t len) {
+            const uint32_t recLen = recordSize(len);
+            const uint32_t irq = spin_lock_blocking(lock);
+            const uint32_t h = head.load(std::memory_order_relaxed);
+            if (len == 0 || len >= COMMITTED || recLen > N - (h - tail.load(std::memory_order_acquire))) {
+                droppedRecords = droppedRecords + 1;
+                spin_unlock(lock, irq);
+                return false;
+            }
+            head.store(h + recLen, std::memory_order_relaxed);
+            spin_unlock(lock, irq);
+            const uint32_t ofs = (h + HEADER_SIZE) & MASK;
+            const size_t first = min(len, static_cast<size_t>(N - ofs));
+            memcpy(bytes() + ofs, data, first);
+            memcpy(bytes(), data + first, len - first);
+            __atomic_store_n(&words[(h & MASK) / HEADER_SIZE], static_cast<uint32_t>(len) | COMMITTED, __ATOMIC_RELEASE);
+            return true;
+        }
+
+        /**
+         * Zero-copy access to the oldest record - consumer only
+         * @param spans receives the record payload, as one span or two when it wraps around the end of the storage
+         * @return the record length; 0 if there is no record, or the oldest record has been reserved but not committed yet
+         */
+        size_t peek(ByteSpan spans[2]) const {
+            const uint32_t t = tail.load(std::memory_order_relaxed);
+            if (head.load(std::memory_order_acquire) == t)
+                return 0;
+            const uint32_t hdr = __atomic_load_n(&words[(t & MASK) / HEADER_SIZE], __ATOMIC_ACQUIRE);
+            if (!(hdr & COMMITTED))
+                return 0;
+            const size_t len = hdr & ~COMMITTED;
+            const uint32_t ofs = (t + HEADER_SIZE) & MASK;
+            const size_t first = min(len, static_cast<size_t>(N - ofs));
+            spans[0] = {bytes() + ofs, first};
+            spans[1] = {bytes(), len - first};
+            return len;
+        }
+
+        /**
+         * Releases the oldest record, previously obtained with <code>peek</code> - consumer only
+         */
+        void release() {
+            const uint32_t t = tail.load(std::memory_order_relaxed);
+            const uint32_t hdr = __atomic_load_n(&words[(t & MASK) / HEADER_SIZE], __ATOMIC_ACQUIRE);
+            if (head.load(std::memory_order_acquire) == t || !(hdr & COMMITTED))
+                return;
+            const uint32_t recLen = recordSize(hdr & ~COMMITTED);
+            const uint32_t ofs = t & MASK;
+            const uint32_t first = min(recLen, static_cast<uint32_t>(N - ofs));
+            memset(bytes() + ofs, 0, first);
+            memset(bytes(), 0, recLen - first);
+            tail.store(t + recLen, std::memory_order_release);
+        }
+    };
+}
+
+#endif //PICO_LOG_MPSC_RING_H
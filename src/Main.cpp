@@ -26,12 +26,17 @@
  *   - CORE0 (default task - setup, loop) - Web and communications, lowered priority (5)
  *   - ALM - alarm processing and some misc actions (inherited priority - 5)
  *   - FS - filesystem interaction (raised priority from calling task - 7)
+ *   - Render - renders part of the frame for the effects whose rendering is span parallel, see SpanRenderer (same priority as the web
+ *     task - 5, round-robin with it rather than preempting WiFiNINA traffic)
  *   - IdleCore0, USB - default kernel tasks
  *
  * Second Core
  *   - CORE1 (default task - setup1, loop1) - Diag - diagnostic tasks, interaction with I2C devices, elevated priority (7)
  *   - FX - light effects (regular priority - 6)
- *   - Mic - microphone processing (regular priority - 6)
+ *   - Show - pushes the frames rendered by FX to the LED strip (below FX - 5); the push is PIO/DMA paced, hence FX preempts it to
+ *     render the next frame and the Show task fills the time FX waits. Frame rate and web poll latency are in the tasks statistics
+ *     (fxTiming.output, web)
+ *   - Mic - microphone processing (regular priority - 5)
  *   - IdleCore1 - default kernel task
  *
  * Following kernel tasks are set to run on either core (core affinity 0xFFFFFFFF):
@@ -51,6 +56,8 @@ void enqueueAlarmSetup();
 constexpr TaskDef fxTasks {fx_setup, fx_run, 1024, "Fx", 255, CORE_1};
 constexpr TaskDef micTasks {mic_setup, mic_run, 896, "Mic", 5, CORE_1};
 constexpr TaskDef alarmTasks {alarm_misc_begin, alarm_misc_run, 1024, "ALM", 5, CORE_0};
+constexpr TaskDef showTasks {show_setup, show_run, 1024, "Show", 5, CORE_1};
+constexpr TaskDef renderTasks {render_setup, render_run, 1024, "Render", 5, CORE_0};
 bool core1_separate_stack = true;
 QueueHandle_t almQueue;
 
@@ -200,6 +207,8 @@ void setup1() {
     //wait for the main core to notify us that the core components are ready (filesystem, logging, secure element), not interested in the notification value
     ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
 
+    Scheduler.startTask(&showTasks);
+    Scheduler.startTask(&renderTasks);
     Scheduler.startTask(&fxTasks);
     // taskDelay(250);         // leave reasonable time to FX task to set-up
 
@@ -215,15 +215,14 @@ void fxBroadcast(const uint16_t index) {
         return;
     }
 
-    const LedEffect *fx = fxRegistry.getEffect(index);
     if (!fxBroadcastEnabled) {
-        log_warn(F("This board is not a master (FX Broadcast disabled) - will not push effect %s [%hu] to others"), fx->name(), fx->getRegistryIndex());
+        log_warn(F("This board is not a master (FX Broadcast disabled) - will not push effect %s [%hu] to others"), fxRegistry.effectName(index), index);
         return;
     }
     broadcastState = Broadcasting;
-    log_info(F("Fx change event - start broadcasting %s [%hu] to %d recipients"), fx->name(), fx->getRegistryIndex(), fxBroadcastRecipients.size());
+    log_info(F("Fx change event - start broadcasting %s [%hu] to %d recipients"), fxRegistry.effectName(index), index, fxBroadcastRecipients.size());
     for (const auto &client : fxBroadcastRecipients)
-        clientUpdate(client, fx->getRegistryIndex());
+        clientUpdate(client, index);
     log_info(F("Finished broadcasting to %hu recipients - check individual log statements for status of each recipient"), fxBroadcastRecipients.size());
     broadcastState = Waiting;
 }
@@ -0,0 +1,190 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include "hardware/timer.h"
+#include "crossfade.h"
+#include "efx_setup.h"
+
+EffectCrossfade crossfade;
+
+static const char *const maskNames[CrossfadeMaskCount] = {"wipe", "dissolve", "radial"};
+
+/**
+ * Begins a crossfade between two effects - the outgoing effect must be running; the incoming effect is moved to setup if idle.
+ * Does not begin (the caller turns the strip off and on instead) when crossfades are disabled, the outgoing effect is not running,
+ * either effect renders in blocking loops or the scratch arena is not expected to fit both effects.
+ * @param outgoing the effect currently running
+ * @param incoming the effect taking over
+ * @return true if the crossfade has begun
+ */
+bool EffectCrossfade::begin(LedEffect *outgoing, LedEffect *incoming) {
+    if (XFADE_DURATION_MS == 0 || outgoing == incoming)
+        return false;
+    if (outgoing->getState() != Running || (incoming->getState() != Idle && incoming->getState() != Setup) ||
+        ((effectCatalog[outgoing->getRegistryIndex()].flags | effectCatalog[incoming->getRegistryIndex()].flags) & FxFlagBlocking)) {
+        fallbacks++;
+        return false;
+    }
+    const size_t need = fxTiming.arenaNeed(incoming->getRegistryIndex());
+    if (need > fxArena.available()) {
+        log_info(F("Crossfade to %s [%d] skipped - scratch arena has %zu bytes available, %zu bytes needed"),
+                 incoming->name(), incoming->getRegistryIndex(), fxArena.available(), need);
+        fallbacks++;
+        return false;
+    }
+    from = outgoing;
+    to = incoming;
+    memcpy(bufFrom, leds, sizeof(bufFrom));
+    fill_solid(bufTo, NUM_PIXELS, BKG);
+    mask = static_cast<CrossfadeMask>(random8(CrossfadeMaskCount));
+    buildRanks();
+    ctxFrom.save();
+    ctxTo.save();       //the incoming effect setup resets its globals anyway
+    fxArena.flip();     //the outgoing effect keeps its scratch state, the incoming effect setup allocates from the other end
+    if (to->getState() == Idle)
+        to->desiredState(Running);
+    startMs = millis();
+    tick.reset();
+    overRun = 0;
+    active = true;
+    count++;
+    log_info(F("Crossfade from %s [%d] to %s [%d] - %s mask over %d ms"), from->name(), from->getRegistryIndex(),
+             to->name(), to->getRegistryIndex(), maskNames[mask], XFADE_DURATION_MS);
+    return true;
+}
+
+/**
+ * Computes the rank of each pixel for the current mask - the order in which pixels switch to the incoming effect. Wipes and radials
+ * run either way at random.
+ */
+void EffectCrossfade::buildRanks() {
+    const bool reverse = random8() & 0x01;
+    IndexPermutation shuffle;
+    if (mask == Dissolve)
+        shuffle.reset(NUM_PIXELS, static_cast<uint32_t>(random16()) << 16 | random16());
+    for (uint16_t i = 0; i < NUM_PIXELS; i++) {
+        uint16_t r;
+        switch (mask) {
+            case Dissolve: r = shuffle(i); break;
+            case Radial: r = abs(2 * i - (NUM_PIXELS - 1)); break;     //distance from the center - outward
+            default: r = i; break;
+        }
+        rank[i] = (reverse && mask != Dissolve) ? (NUM_PIXELS - 1 - r) : r;
+    }
+}
+
+/**
+ * Runs one step of an effect against its own pixel buffer and context - both are swapped in and out of the LED buffer and the
+ * globals around the step
+ * @param fx the effect
+ * @param buf the effect's pixel buffer
+ * @param ctx the effect's context
+ */
+void EffectCrossfade::step(LedEffect *fx, CRGB *buf, FxContext &ctx) {
+    ctx.restore();
+    memcpy(leds, buf, sizeof(CRGB) * NUM_PIXELS);
+    fx->loop();
+    memcpy(buf, leds, sizeof(CRGB) * NUM_PIXELS);
+    ctx.save();
+}
+
+/**
+ * Mixes a range of pixels into the LED buffer - pixels the front has not reached yet show the outgoing effect, pixels past the soft
+ * edge show the incoming effect, the ones in between are blended. Each effect's pixels are read through its output mapping.
+ * @param lo first pixel of the range
+ * @param hi end of the range (exclusive)
+ */
+void EffectCrossfade::mix(const uint16_t lo, const uint16_t hi) const {
+    const OutputMapping &mapFrom = ctxFrom.mapping;
+    const OutputMapping &mapTo = ctxTo.mapping;
+    for (uint16_t i = lo; i < hi; i++) {
+        const int32_t d = static_cast<int32_t>(head) - (static_cast<int32_t>(rank[i]) << 8);
+        if (d <= 0)
+            leds[i] = bufFrom[mapFrom.source(i)];
+        else if (d >= (XFADE_EDGE << 8))
+            leds[i] = bufTo[mapTo.source(i)];
+        else
+            leds[i] = blend(bufFrom[mapFrom.source(i)], bufTo[mapTo.source(i)], static_cast<fract8>(d / XFADE_EDGE));
+    }
+}
+
+/**
+ * Composites the two effect buffers into the LED buffer, split across both cores
+ * @param progress crossfade progress, out of 65536
+ */
+void EffectCrossfade::composite(const uint16_t progress) {
+    head = (static_cast<uint32_t>(progress) * (NUM_PIXELS + XFADE_EDGE)) >> 8;
+    spanRender.render([](void *ctx, const uint16_t lo, const uint16_t hi) { static_cast<const EffectCrossfade *>(ctx)->mix(lo, hi); }, this, 0, NUM_PIXELS);
+    outputMap.cancel();     //the composited frame is whole - restored with the effects' contexts at their next step
+    litMap.invalidate();
+}
+
+/**
+ * Crossfade step, in lieu of the effect loop - steps both effects, and every <code>XFADE_FRAME_MS</code> composites and shows a
+ * frame. Completes the crossfade once its duration has elapsed, or once <code>XFADE_BUDGET_FRAMES</code> frames in a row went over
+ * budget.
+ */
+void EffectCrossfade::loop() {
+    const uint32_t start = time_us_32();
+    capturing = true;
+    step(from, bufFrom, ctxFrom);
+    step(to, bufTo, ctxTo);
+    capturing = false;
+    const uint32_t elapsed = millis() - startMs;
+    if (elapsed >= XFADE_DURATION_MS) {
+        finish();
+        return;
+    }
+    if (!tick.ready())
+        return;
+    composite(static_cast<uint16_t>(elapsed * 65536 / XFADE_DURATION_MS));
+    showStrip(stripBrightness);
+    const uint32_t us = time_us_32() - start;
+    frame.add(us);
+    if (us <= XFADE_BUDGET_US) {
+        overRun = 0;
+        return;
+    }
+    overBudget++;
+    if (++overRun >= XFADE_BUDGET_FRAMES) {
+        log_warn(F("Crossfade frames over budget - %lu us, %d frames in a row"), us, overRun);
+        budgetCuts++;
+        finish();
+    }
+}
+
+/**
+ * Completes the crossfade, if one is underway - the LED buffer, the globals and the scratch arena are handed over to the incoming
+ * effect and the outgoing effect is stopped, skipping its wind down; its arena end is released. Called early when another effect
+ * change comes in during the crossfade.
+ */
+void EffectCrossfade::finish() {
+    if (!active)
+        return;
+    const bool early = (millis() - startMs) < XFADE_DURATION_MS;
+    if (early)
+        cut++;
+    memcpy(leds, bufTo, sizeof(bufTo));
+    ctxTo.restore();
+    litMap.invalidate();
+    from->state = Idle;
+    fxArena.releaseOther();
+    active = false;
+    log_info(F("Crossfade from %s [%d] to %s [%d] completed%s"), from->name(), from->getRegistryIndex(),
+             to->name(), to->getRegistryIndex(), early ? " - cut short" : "");
+}
+
+/**
+ * Marshals the crossfade statistics into the JSON object provided
+ * @param json JSON object to add the statistics to
+ */
+void EffectCrossfade::stats(const JsonObject &json) const {
+    json["duration"] = XFADE_DURATION_MS;
+    json["count"] = count;
+    json["fallbacks"] = fallbacks;
+    json["cut"] = cut;
+    json["budget"] = XFADE_BUDGET_US;
+    json["overBudget"] = overBudget;
+    json["budgetCuts"] = budgetCuts;
+    frame.toJson(json["frame"].to<JsonObject>());
+}
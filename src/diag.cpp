@@ -12,6 +12,7 @@
 #include <FastLED.h>
 #include "SchedulerExt.h"
 #include "diag.h"
+#include "entropy_pool.h"
 #include "util.h"
 #include "filesystem.h"
 #include "FxSchedule.h"
@@ -222,10 +223,14 @@ void enqueueDiagInfo(TimerHandle_t xTimer) {
  */
 void diagExecute() {
     DiagAction msg;
-    //block indefinitely for a message to be received
-    if (pdFALSE == xQueueReceive(diagQueue, &msg, portMAX_DELAY))
-    // if (pdFALSE == xQueueReceive(diagQueue, &msg, 0))
+    //block for a message to be received - indefinitely when the entropy pool is full; otherwise a quiet I2C bus for a while
+    //is an opportunity to add another block of secure random values to the pool
+    const bool refillPool = entropyPool.needsRefill() && sysInfo->isSysStatus(SYS_STATUS_ECC);
+    if (pdFALSE == xQueueReceive(diagQueue, &msg, refillPool ? pdMS_TO_TICKS(ENTROPY_REFILL_IDLE_MS) : portMAX_DELAY)) {
+        if (refillPool)
+            entropyPool.refill();
         return;
+    }
     //the reception was successful, hence the msg is not null anymore
     switch (msg) {
         case RND_ENTROPY: updateSecEntropy(); break;
@@ -0,0 +1,243 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include <array>
+#include "easing.h"
+
+// table resolution - 256 segments, 128 Q15 units each
+static constexpr uint8_t TABLE_BITS = 8;
+static constexpr uint16_t TABLE_SIZE = 1 << TABLE_BITS;
+static constexpr uint8_t SEG_BITS = 15 - TABLE_BITS;
+static constexpr double PI_D = 3.14159265358979323846;
+static constexpr double LN2_D = 0.69314718055994530942;
+
+// Taylor series - the generator functions below only run at compile time
+static constexpr double sinSeries(const double x) {
+    double term = x, sum = x;
+    for (int n = 1; n < 16; n++) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+static constexpr double expSeries(const double x) {
+    double term = 1, sum = 1;
+    for (int n = 1; n < 24; n++) {
+        term *= x / n;
+        sum += term;
+    }
+    return sum;
+}
+
+// sin(PI/2 * i/TABLE_SIZE), Q15 - a quarter sine wave
+static constexpr std::array<uint16_t, TABLE_SIZE + 1> makeSineTable() {
+    std::array<uint16_t, TABLE_SIZE + 1> tbl{};
+    for (uint16_t i = 0; i <= TABLE_SIZE; i++)
+        tbl[i] = static_cast<uint16_t>(sinSeries(PI_D / 2 * i / TABLE_SIZE) * EASE_ONE + 0.5);
+    return tbl;
+}
+
+// 2^(i/TABLE_SIZE), Q15 - the range is [EASE_ONE, 2*EASE_ONE]
+static constexpr std::array<uint32_t, TABLE_SIZE + 1> makeExp2Table() {
+    std::array<uint32_t, TABLE_SIZE + 1> tbl{};
+    for (uint16_t i = 0; i <= TABLE_SIZE; i++)
+        tbl[i] = static_cast<uint32_t>(expSeries(LN2_D * i / TABLE_SIZE) * EASE_ONE + 0.5);
+    return tbl;
+}
+
+static constexpr auto sineTable = makeSineTable();
+static constexpr auto exp2Table = makeExp2Table();
+
+// back easing constants, Q12 such that constant*Q15 fits 32 bits
+static constexpr int32_t BACK_C1 = static_cast<int32_t>(1.70158 * 4096 + 0.5);
+static constexpr int32_t BACK_C2 = static_cast<int32_t>(1.70158 * 1.525 * 4096 + 0.5);
+
+static inline int32_t mul(const int32_t a, const int32_t b) {
+    return (a * b) >> 15;
+}
+
+/**
+ * Linear interpolation in a table
+ * @param tbl the table, TABLE_SIZE+1 entries
+ * @param u position, [0, EASE_ONE]
+ */
+template<typename T> static inline int32_t lerpTable(const std::array<T, TABLE_SIZE + 1> &tbl, const int32_t u) {
+    const int32_t idx = u >> SEG_BITS;
+    if (idx >= TABLE_SIZE)
+        return static_cast<int32_t>(tbl[TABLE_SIZE]);
+    const int32_t a = static_cast<int32_t>(tbl[idx]);
+    const int32_t b = static_cast<int32_t>(tbl[idx + 1]);
+    return a + (((b - a) * (u & ((1 << SEG_BITS) - 1))) >> SEG_BITS);
+}
+
+/**
+ * Sine of an angle expressed in turns
+ * @param turns angle, Q15 - EASE_ONE is a full turn; any value, including negative, is reduced modulo one turn
+ * @return sine, Q15
+ */
+static int32_t sinTurns(const int32_t turns) {
+    constexpr int32_t quarter = EASE_ONE / 4;
+    const int32_t ph = turns & (EASE_ONE - 1);
+    const int32_t q = ph & (quarter - 1);
+    switch (ph / quarter) {
+        case 0: return lerpTable(sineTable, q * 4);
+        case 1: return lerpTable(sineTable, EASE_ONE - q * 4);
+        case 2: return -lerpTable(sineTable, q * 4);
+        default: return -lerpTable(sineTable, EASE_ONE - q * 4);
+    }
+}
+
+/**
+ * Power of two for non-positive exponents
+ * @param e exponent, Q15, at most 0
+ * @return 2^e, Q15
+ */
+static int32_t exp2Neg(const int32_t e) {
+    const int32_t whole = -(e >> 15);   //arithmetic shift floors towards negative infinity
+    if (whole >= 31)
+        return 0;
+    return lerpTable(exp2Table, e & (EASE_ONE - 1)) >> whole;
+}
+
+/**
+ * Integer square root, rounded down
+ */
+static uint32_t isqrt(uint32_t v) {
+    uint32_t res = 0;
+    for (uint32_t bit = 1u << 30; bit; bit >>= 2) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else
+            res >>= 1;
+    }
+    return res;
+}
+
+static int32_t backIn(const int32_t t, const int32_t c) {
+    // t^2*((c+1)*t - c) = t^2*(t + c*(t-1))
+    return mul(mul(t, t), t + ((c * (t - EASE_ONE)) >> 12));
+}
+
+static int32_t bounceOut(const int32_t t) {
+    // the segment boundaries are at 4/11, 8/11, 10/11 - with x = 22*t - k, 7.5625*(x/22)^2 = (x/8)^2
+    const int32_t t22 = t * 22;
+    int32_t x, y;
+    if (t22 < 8 * EASE_ONE) {
+        x = t22;
+        y = 0;
+    } else if (t22 < 16 * EASE_ONE) {
+        x = t22 - 12 * EASE_ONE;
+        y = EASE_ONE * 3 / 4;
+    } else if (t22 < 20 * EASE_ONE) {
+        x = t22 - 18 * EASE_ONE;
+        y = EASE_ONE * 15 / 16;
+    } else {
+        x = t22 - 21 * EASE_ONE;
+        y = EASE_ONE * 63 / 64;
+    }
+    return y + mul(x >> 3, x >> 3);
+}
+
+/**
+ * The ease-in variant of the curve. Every curve other than elastic derives its ease-out as 1-in(1-t) and its ease-in-out from
+ * two halves of ease-in
+ */
+static int32_t easeIn(const EaseCurve curve, const int32_t t) {
+    switch (curve) {
+        case EaseSine: return EASE_ONE - lerpTable(sineTable, EASE_ONE - t);
+        case EaseQuad: return mul(t, t);
+        case EaseCubic: return mul(mul(t, t), t);
+        case EaseQuart: {
+            const int32_t t2 = mul(t, t);
+            return mul(t2, t2);
+        }
+        case EaseQuint: {
+            const int32_t t2 = mul(t, t);
+            return mul(mul(t2, t2), t);
+        }
+        case EaseExpo: return t == 0 ? 0 : exp2Neg(10 * t - 10 * EASE_ONE);
+        case EaseCirc: return EASE_ONE - static_cast<int32_t>(isqrt((1u << 30) - static_cast<uint32_t>(t * t)));
+        case EaseBack: return backIn(t, BACK_C1);
+        case EaseBounce: return EASE_ONE - bounceOut(EASE_ONE - t);
+        default: return t;
+    }
+}
+
+/**
+ * Elastic easing - its variants have different frequencies and do not derive from each other
+ */
+static int32_t easeElastic(const EaseMode mode, const int32_t t) {
+    if (t == 0 || t == EASE_ONE)
+        return t;
+    switch (mode) {
+        case EaseIn:        // -2^(10t-10) * sin((10t-10.75) * 2PI/3)
+            return -mul(exp2Neg(10 * t - 10 * EASE_ONE), sinTurns((10 * t - EASE_ONE * 43 / 4) / 3));
+        case EaseOut:       // 2^(-10t) * sin((10t-0.75) * 2PI/3) + 1
+            return mul(exp2Neg(-10 * t), sinTurns((10 * t - EASE_ONE * 3 / 4) / 3)) + EASE_ONE;
+        default: {          // sin((20t-11.125) * 2PI/4.5) scaled by 2^(20t-10)/2, mirrored for the second half
+            const int32_t s = sinTurns((40 * t - EASE_ONE * 89 / 4) / 9);
+            if (t < EASE_ONE / 2)
+                return -mul(exp2Neg(20 * t - 10 * EASE_ONE), s) / 2;
+            return mul(exp2Neg(10 * EASE_ONE - 20 * t), s) / 2 + EASE_ONE;
+        }
+    }
+}
+
+/**
+ * Evaluates an easing curve
+ * @param curve easing curve
+ * @param mode easing mode - in, out, in-out
+ * @param t progress, Q15 in [0, EASE_ONE] - values outside are clamped
+ * @return eased progress, Q15 - 0 at t=0 and EASE_ONE at t=EASE_ONE
+ */
+int32_t easeQ15(const EaseCurve curve, const EaseMode mode, int32_t t) {
+    if (t <= 0)
+        return 0;
+    if (t >= EASE_ONE)
+        return EASE_ONE;
+    if (curve == EaseElastic)
+        return easeElastic(mode, t);
+    switch (mode) {
+        case EaseIn:
+            return easeIn(curve, t);
+        case EaseOut:
+            return EASE_ONE - easeIn(curve, EASE_ONE - t);
+        default:
+            if (t < EASE_ONE / 2)
+                return (curve == EaseBack ? backIn(2 * t, BACK_C2) : easeIn(curve, 2 * t)) / 2;
+            return EASE_ONE - (curve == EaseBack ? backIn(2 * (EASE_ONE - t), BACK_C2) : easeIn(curve, 2 * (EASE_ONE - t))) / 2;
+    }
+}
+
+/**
+ * Evaluates an easing curve over an integer range
+ * @param curve easing curve
+ * @param mode easing mode - in, out, in-out
+ * @param x input value, [0, lim]
+ * @param lim high limit of the range
+ * @return the eased value in [0, lim] (truncated towards zero), overshooting the range for back and elastic curves
+ */
+int32_t ease(const EaseCurve curve, const EaseMode mode, const uint16_t x, const uint16_t lim) {
+    if (lim == 0)
+        return 0;
+    const int32_t t = static_cast<int32_t>((static_cast<uint32_t>(x) << 15) / lim);
+    const int32_t e = easeQ15(curve, mode, t);
+    //unsigned products - the overshooting curves peak above 1.0, where e*lim no longer fits a signed 32-bit value
+    if (e >= 0)
+        return static_cast<int32_t>((static_cast<uint32_t>(e) * lim) >> 15);
+    return -static_cast<int32_t>((static_cast<uint32_t>(-e) * lim) >> 15);
+}
+
+/**
+ * Evaluates an easing curve over 8 bit values, FastLED style
+ * @param curve easing curve
+ * @param mode easing mode - in, out, in-out
+ * @param x input value, 0 to 255
+ * @return the eased value, clamped to 0 to 255
+ */
+uint8_t ease8(const EaseCurve curve, const EaseMode mode, const uint8_t x) {
+    const int32_t e = ease(curve, mode, x, 255);
+    return e < 0 ? 0 : e > 255 ? 255 : e;
+}
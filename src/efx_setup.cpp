@@ -8,12 +8,17 @@
 #include "FxSchedule.h"
 #include "transition.h"
 #include "util.h"
+#include "fx_bench.h"
+#include "fx_stats.h"
+#include "loop_span.h"
+#include "pixel_kernels.h"
+#include "entropy_pool.h"
+#include "hardware/timer.h"
 #if LOGGING_ENABLED == 1
 #include "stringutils.h"
 #endif
 
 //~ Global variables definition
-constexpr setupFunc categorySetup[] = {FxA::fxRegister, FxB::fxRegister, FxC::fxRegister, FxD::fxRegister, FxE::fxRegister, FxF::fxRegister, FxH::fxRegister, FxI::fxRegister, FxJ::fxRegister, FxK::fxRegister};
 constexpr CRGB BKG = CRGB::Black;
 
 volatile bool fxBump = false;
@@ -21,10 +26,10 @@ volatile uint16_t speed = 100;
 volatile uint16_t curPos = 0;
 
 EffectRegistry fxRegistry;
-CRGB leds[NUM_PIXELS];                                    //the main LEDs array of CRGB type
-CRGBSet ledSet(leds, NUM_PIXELS);                     //the entire leds CRGB array as a CRGBSet
+alignas(4) CRGB leds[NUM_PIXELS];                         //the main LEDs array of CRGB type - word aligned for frameHash
+CRGBSet ledSet(leds, NUM_PIXELS);                     //the entire leds CRGB array as a CRGBSet - see logicalSet for the pixels shown
 CRGBSet tpl(leds, FRAME_SIZE);                        //array length, indexes go from 0 to length-1
-CRGBSet others(leds, tpl.size(), NUM_PIXELS-1);  //start and end indexes are inclusive
+CRGBSet others(leds, tpl.size(), NUM_PIXELS-1);  //start and end indexes are inclusive - replications into it are clipped to the logical pixels
 CRGBArray<PIXEL_BUFFER_SPACE> frame;                      //side LED buffer for preparing/saving state/etc. with main LEDs array
 CRGBPalette16 palette;
 CRGBPalette16 targetPalette;
@@ -38,7 +43,7 @@ uint8_t hue = 50;
 uint8_t delta = 1;
 uint8_t saturation = 100;
 uint8_t dotBpm = 30;
-uint16_t stripShuffleIndex[NUM_PIXELS];
+IndexPermutation stripShuffle;
 uint16_t hueDiff = 256;
 uint16_t totalAudioBumps = 0;
 int32_t dist = 1;
@@ -48,12 +53,87 @@ EffectTransition transEffect;
 
 //~ Support functions -----------------
 /**
- * Setup the strip LED lights to be controlled by FastLED library
+ * Setup the strip LED lights to be controlled by FastLED library - FastLED drives the double buffered strip output, whose frames
+ * the output LUT has already color corrected and scaled
  */
 void ledStripInit() {
-    CFastLED::addLeds<CHIPSET, LED_PIN, COLOR_ORDER>(leds, NUM_PIXELS).setCorrection(TypicalSMD5050).setTemperature(Tungsten100W);
+    outputLut.begin(OUTPUT_GAMMA, TypicalSMD5050, Tungsten100W);
+    frameOutput.begin(CFastLED::addLeds<CHIPSET, LED_PIN, COLOR_ORDER>(frameOutput.back(), NUM_PIXELS));
     FastLED.setBrightness(BRIGHTNESS);
-    FastLED.clear(true);
+    FastLED.setDither(DISABLE_DITHER);
+    clearStrip(true);
+}
+
+/**
+ * Hash of the LED buffer contents, read a word at a time - cheap enough to run on every show, used to detect unchanged frames
+ * @return hash of the current LED buffer
+ */
+uint32_t frameHash() {
+    constexpr size_t words = sizeof(leds) / sizeof(uint32_t);
+    const auto *p = reinterpret_cast<const uint8_t *>(leds);
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < words; i++) {
+        uint32_t w;
+        memcpy(&w, p + i * sizeof(uint32_t), sizeof(w));
+        h = (h ^ w) * 0x9E3779B1u;
+        h ^= h >> 15;
+    }
+    for (size_t i = words * sizeof(uint32_t); i < sizeof(leds); i++)
+        h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+/**
+ * Pushes the LED buffer to the strip, timing the operation - all effects and transitions show their frames through this function.
+ * The frame is transformed through the output LUT at the brightness given into the back buffer of the strip output, gathering the
+ * replicated region from the logical frame (see OutputMapper), and handed over to be pushed asynchronously - the LED buffer is free
+ * to be changed as soon as this returns.
+ * A frame identical to the one last pushed, with the same output LUT (brightness, color adjustments), the same mapping and no layer changes, is not pushed again - unless
+ * it has been held for longer than <code>SHOW_KEEPALIVE_MS</code>; the skipped shows are counted in the timing statistics.
+ * While crossfading, the effects' shows are captured instead - see EffectCrossfade. Overlay layers, if any, are composited over the
+ * frame on its way out - see LayerStack.
+ * @param scale the brightness to show the strip at
+ */
+void showStrip(const uint8_t scale) {
+    static uint32_t lastHash = 0;
+    static uint32_t lastShowMs = 0;
+    static uint16_t lastGen = 0;        //output LUT generation starts past 0 - the first frame is always pushed
+    static uint32_t lastMapGen = 0;
+    const uint32_t start = time_us_32();
+    if (crossfade.isCapturing())
+        return;     //an effect frame while crossfading - only the composited frames are shown
+    if (fxLayers.isCapturing()) {
+        fxLayers.frameCaptured();
+        return;     //a layer effect frame - composited over the running effect's frames
+    }
+    outputLut.setBrightness(scale);
+    const uint32_t hash = frameHash();
+    const uint32_t now = millis();
+    if (hash == lastHash && outputLut.generation() == lastGen && outputMap.generation() == lastMapGen && !fxLayers.isDirty() &&
+        (now - lastShowMs) < SHOW_KEEPALIVE_MS) {
+        fxTiming.recordSkip(time_us_32() - start);
+        return;
+    }
+    lastHash = hash;
+    lastGen = outputLut.generation();
+    lastMapGen = outputMap.generation();
+    lastShowMs = now;
+    //a composited frame comes out of the layers already mapped
+    const CRGB *out = fxLayers.compose(leds);
+    outputLut.apply(out, frameOutput.back(), out == leds ? outputMap.gather(topology.gather()) : topology.gather());
+    frameOutput.submit();
+    fxTiming.recordShow(time_us_32() - start);
+}
+
+/**
+ * Turns off all pixels in the LED buffer
+ * @param flush whether to also show the strip
+ */
+void clearStrip(const bool flush) {
+    outputMap.cancel();
+    fill_solid(leds, NUM_PIXELS, BKG);
+    if (flush)
+        showStrip(stripBrightness);
 }
 
 void readFxState() {
@@ -82,7 +162,7 @@ void readFxState() {
         else
             fxRegistry.enableSleep(false);      //this doesn't invoke effect changing because sleep state is initialized with false
         //we need the sleep mode flag setup first to properly advance to next effect
-        if (const uint16_t sleepFxIndex = fxRegistry.findEffect(FX_SLEEPLIGHT_ID)->getRegistryIndex(); fx == sleepFxIndex && !fxRegistry.isAsleep())
+        if (fx == fxRegistry.sleepEffect && !fxRegistry.isAsleep())
             fxRegistry.lastEffectRun = fxRegistry.currentEffect = random16(fxRegistry.effectsCount);
         else
             fxRegistry.lastEffectRun = fxRegistry.currentEffect = fx;
@@ -124,12 +204,13 @@ void resetGlobals() {
     //turn off the LEDs on the strip and the frame buffer - flush to the LED strip if we have the time and not in sleep time
     //flushing to strip may cause a short blink if called mid-effect, like an audio effect bump would do for the same effect when sleeping
     const bool flushStrip = sysInfo->isSysStatus(SYS_STATUS_NTP) && !fxRegistry.isAsleep();
-    FastLED.clear(flushStrip);
+    clearStrip(flushStrip);
     FastLED.setBrightness(BRIGHTNESS);
     frame.fill_solid(BKG);
 
     palette = paletteFactory.mainPalette();
     targetPalette = paletteFactory.secondaryPalette();
+    syncPaletteCaches();
     mode = Chase;
     brightness = 224;
     colorIndex = lastColorIndex = 0;
@@ -144,51 +225,6 @@ void resetGlobals() {
     dist = 1;
     dirFwd = true;
     fxBump = false;
-
-    //shuffle led indexes - when engaging secureRandom functions, each call is about 30ms. Shuffling a 320 items array (~200 swaps and secure random calls) takes about 6 seconds!
-    //commented in favor of regular shuffle (every 5 minutes) - see fxRun
-    //shuffleIndexes(stripShuffleIndex, NUM_PIXELS);
-}
-
-/**
- * Ease Out Bounce implementation - leverages the double precision original implementation converted to int in a range
- * @param x input value
- * @param lim high limit range
- * @return the result in [0,lim] inclusive range
- * @see https://easings.net/#easeOutBounce
- */
-uint16_t easeOutBounce(const uint16_t x, const uint16_t lim) {
-    static constexpr float d1 = 2.75f;
-    static constexpr float n1 = 7.5625f;
-
-    const float xf = ((float)x)/(float)lim;
-    float res = 0;
-    if (xf < 1/d1) {
-        res = n1*xf*xf;
-    } else if (xf < 2/d1) {
-        const float xf1 = xf - 1.5f/d1;
-        res = n1*xf1*xf1 + 0.75f;
-    } else if (xf < 2.5f/d1) {
-        const float xf1 = xf - 2.25f/d1;
-        res = n1*xf1*xf1 + 0.9375f;
-    } else {
-        const float xf1 = xf - 2.625f/d1;
-        res = n1*xf1*xf1 + 0.984375f;
-    }
-    return (uint16_t )(res * (float)lim);
-}
-
-/**
- * Ease Out Quad implementation - leverages the double precision original implementation converted to int in a range
- * @param x input value
- * @param lim high limit range
- * @return the result in [0,lim] inclusive range
- * @see https://easings.net/#easeOutQuad
- */
-uint16_t easeOutQuad(const uint16_t x, const uint16_t lim) {
-    auto limf = float(lim);
-    const float xf = float(x)/limf;
-    return uint16_t((1 - (1-xf)*(1-xf))*limf);
 }
 
 /**
@@ -210,6 +246,14 @@ void shiftRight(CRGBSet &set, const CRGB feedLeft, Viewport vwp, const uint16_t
         return;
     }
     const uint16_t hiMark = capu(vwp.high, set.size());
+    if (!set.reversed()) {
+        //block move - same outcome as moving the pixels one by one starting from the high end
+        if (const uint16_t from = max(vwp.low, pos); hiMark > from)
+            memmove(&set[from], &set[from-pos], (hiMark-from)*sizeof(CRGB));
+        for (uint16_t y = vwp.low; y < min(pos, hiMark); y++)
+            set[y] = feedLeft;
+        return;
+    }
     //don't use >= as the indexer is unsigned and always >=0 --> infinite loop
     for (uint16_t x = hiMark; x > vwp.low; x--) {
         const uint16_t y = x - 1;
@@ -230,14 +274,11 @@ void loopRight(CRGBSet &set, Viewport vwp, uint16_t pos) {
     if (vwp.size() == 0)
         vwp = (Viewport)set.size();
     const uint16_t hiMark = capu(vwp.high, set.size());
-    pos = pos % vwp.size();
-    CRGB buf[pos];
-    for (uint16_t x = hiMark; x > vwp.low; x--) {
-        const uint16_t y = x - 1;
-        if (hiMark-x < pos)
-            buf[hiMark-x] = set[y];
-        set[y] = y < pos ? buf[pos-y-1] : set[y-pos];
-    }
+    if (hiMark <= vwp.low)
+        return;
+    //rotate the viewport in place - no temporary buffer needed. A reversed set has its viewport start at the highest address
+    const uint16_t szLoop = hiMark - vwp.low;
+    loopSpan(set.reversed() ? &set[hiMark-1] : &set[vwp.low], szLoop, pos, set.reversed());
 }
 
 /**
@@ -258,6 +299,17 @@ void shiftLeft(CRGBSet &set, const CRGB feedRight, Viewport vwp, const uint16_t
         set(vwp.low, hiMark) = feedRight;
         return;
     }
+    if (!set.reversed()) {
+        //block move - same outcome as moving the pixels one by one starting from the low end
+        uint16_t x = vwp.low;
+        if (const int32_t last = min(static_cast<int32_t>(hiMark), static_cast<int32_t>(set.size() - 1 - pos)); last >= vwp.low) {
+            memmove(&set[vwp.low], &set[vwp.low+pos], (last-vwp.low+1)*sizeof(CRGB));
+            x = last + 1;
+        }
+        for (; x <= hiMark; x++)
+            set[x] = feedRight;
+        return;
+    }
     for (uint16_t x = vwp.low; x <= hiMark; x++) {
         const uint16_t y = x + pos;
         set[x] = y < set.size() ? set[y] : feedRight;
@@ -315,17 +367,21 @@ bool moveBlend(CRGBSet &target, const CRGBSet &segment, const fract8 overlay, co
     const uint16_t newPosTargetStart = qsuba(toPos, segSize);
     const uint16_t newPosTargetEnd = capu(toPos, target.size() - 1);
     if (toPos > fromPos) {
-        if (isOldStartSegmentWithinTarget || isNewStartSegmentWithinTarget)
-            target(qsuba(fromPos, segSize), qsuba(newPosTargetStart, 1)).nblend(bkg, overlay);
+        if (isOldStartSegmentWithinTarget || isNewStartSegmentWithinTarget) {
+            CRGBSet trail = target(qsuba(fromPos, segSize), qsuba(newPosTargetStart, 1));
+            blendSet(trail, bkg, overlay);
+        }
     } else {
-        if (isOldEndSegmentWithinTarget || isNewEndSegmentWithinTarget)
-            target(capu(fromPos, target.size()-1), qsuba(newPosTargetEnd, 1)).nblend(bkg, overlay);
+        if (isOldEndSegmentWithinTarget || isNewEndSegmentWithinTarget) {
+            CRGBSet trail = target(capu(fromPos, target.size()-1), qsuba(newPosTargetEnd, 1));
+            blendSet(trail, bkg, overlay);
+        }
     }
     const uint16_t startIndexSeg = isNewStartSegmentWithinTarget ? 0 : segSize - toPos;
     const uint16_t endIndexSeg = isNewEndSegmentWithinTarget ? segSize - 1 : maxSize - toPos - 1;
     CRGBSet sliceTarget((CRGB*)target, newPosTargetStart, newPosTargetEnd);
     const CRGBSet sliceSeg((CRGB*)segment, startIndexSeg, endIndexSeg);
-    sliceTarget.nblend(sliceSeg, overlay);
+    blendSet(sliceTarget, sliceSeg, overlay);
     return areSame(sliceTarget, sliceSeg);
 }
 
@@ -345,60 +401,83 @@ bool areSame(const CRGBSet &lhs, const CRGBSet &rhs) {
     return true;
 }
 
+/**
+ * Source index for the replication position given, per output rule - the destination continues the source, same as the output
+ * mapping lays it out (see OutputMapping::source): mirrored starts with the reversed source
+ * @param x replication position, modulo twice the source size
+ * @param srcSize source size
+ * @param rule output rule
+ * @return index in the source set
+ */
+static uint16_t ruleIndex(const uint16_t x, const uint16_t srcSize, const OutputRule rule) {
+    const bool second = x >= srcSize;
+    const uint16_t pos = second ? x - srcSize : x;
+    switch (rule) {
+        case Mirror: return second ? pos : srcSize - 1 - pos;
+        case Reverse: return srcSize - 1 - pos;
+        default: return pos;
+    }
+}
+
 /**
  * Replicate the source set into destination, repeating it as necessary to fill the entire destination
  * <p>Any overlaps between source and destination are skipped from replication - source set backing array is guaranteed unchanged</p>
+ * <p>When the destination immediately follows the source in the LED buffer (e.g. <code>tpl</code> and <code>others</code>) the
+ * replication is deferred to the output stage - see OutputMapper - and the destination is gathered from the source when the strip is
+ * shown, never written</p>
+ * <p>LED buffer pixels past the logical ones of the strip topology are not shown, hence not replicated into</p>
  * @param src source set
  * @param dest destination set
+ * @param rule how the source is laid out in the destination - repeated as is (default), mirrored or reversed
  */
-void replicateSet(const CRGBSet& src, CRGBSet& dest) {
+void replicateSet(const CRGBSet& src, CRGBSet& dest, const OutputRule rule) {
+    //the common case of a frame followed by its replication region is deferred to the output stage
+    if (outputMap.map(src, dest, rule))
+        return;
+    //the replicated region of a frame mapped is virtual - materialized when read or written here
+    if (outputMap.overlaps(src) || outputMap.overlaps(dest))
+        outputMap.apply();
     const uint16_t srcSize = abs(src.len);    //src.size() would be more appropriate, but function is not marked const
     CRGB* normSrcStart = src.len < 0 ? src.end_pos : src.leds;     //src.reversed() would have been consistent, but function is not marked const
     CRGB* normSrcEnd = src.len < 0 ? src.leds : src.end_pos;
     CRGB* normDestStart = dest.reversed() ? dest.end_pos : dest.leds;
     CRGB* normDestEnd = dest.reversed() ? dest.leds : dest.end_pos;
+    const CRGB* hidden = leds + topology.logicalSize();
+    const CRGB* ledsEnd = leds + NUM_PIXELS;
     uint16_t x = 0;
     if (max(normSrcStart, normDestStart) < min(normSrcEnd, normDestEnd)) {
         //we have overlap - account for it
         for (auto & y : dest) {
             if (CRGB* yPtr = &y; (yPtr < normSrcStart) || (yPtr >= normSrcEnd)) {
-                (*yPtr) = src[x];
-                incr(x, 1, srcSize);
+                if (yPtr < hidden || yPtr >= ledsEnd)
+                    (*yPtr) = src[ruleIndex(x, srcSize, rule)];
+                incr(x, 1, srcSize*2);
             }
         }
     } else {
         //no overlap - simpler assignment code
         for (auto & y : dest) {
-            y = src[x];
-            incr(x, 1, srcSize);
+            if (&y < hidden || &y >= ledsEnd)
+                y = src[ruleIndex(x, srcSize, rule)];
+            incr(x, 1, srcSize*2);
         }
     }
 }
 
 /**
- * Populates and shuffles randomly an array of numbers in the range of 0-szArray (array indexes)
- * @param array array of indexes
- * @param szArray size of the array
+ * Seed for a shuffle - an <code>IndexPermutation</code> key
+ * <p>Randomness is drawn from the secure entropy pool, falling back to pseudo random values if the pool runs dry</p>
+ * @return random 32 bit seed
  */
-void shuffleIndexes(uint16_t array[], uint16_t szArray) {
-    //populates the indexes in ascending order
-    for (uint16_t x = 0; x < szArray; x++)
-        array[x] = x;
-    //shuffle indexes
-    const uint16_t swIter = (szArray >> 1) + (szArray >> 3);
-    for (uint16_t x = 0; x < swIter; x++) {
-        const uint16_t r = random16(0, szArray);
-        const uint16_t tmp = array[x];
-        array[x] = array[r];
-        array[r] = tmp;
-    }
+uint32_t shuffleSeed() {
+    return static_cast<uint32_t>(entropyPool.random16()) << 16 | entropyPool.random16();
 }
 
 void shuffle(CRGBSet &set) {
-    //perform a number of swaps with random elements of the array - randomness provided by ECC608 secure random number generator
+    //perform a number of swaps with random elements of the array - randomness provided by ECC608 secure random number generator (entropy pool)
     const uint16_t swIter = (set.size() >> 1) + (set.size() >> 4);
     for (uint16_t x = 0; x < swIter; x++) {
-        const uint16_t r = random16(0, set.size());
+        const uint16_t r = entropyPool.random16(set.size());
         const CRGB tmp = set[x];
         set[x] = set[r];
         set[r] = tmp;
@@ -453,18 +532,31 @@ void fillArray(const CRGB *src, const uint16_t srcLength, CRGB *array, const uin
     }
 }
 
+/**
+ * Mirrors the low half of the set onto its high half - through the output mapping when the halves are adjacent (even size, set in
+ * the LED buffer), such that the high half is gathered at output rather than written
+ * @param set the set to mirror, not reversed
+ */
 void mirrorLow(CRGBSet &set) {
-    const int swaps = set.size()/2;
-    for (int x = 0; x < swaps; x++) {
-        set[set.size() - x - 1] = set[x];
-    }
+    const int half = set.size()/2;
+    if (half == 0)
+        return;
+    CRGBSet low = set(0, half - 1);
+    CRGBSet high = set(set.size() - half, set.size() - 1);
+    replicateSet(low, high, Mirror);
 }
 
+/**
+ * Mirrors the high half of the set onto its low half
+ * @param set the set to mirror, not reversed
+ */
 void mirrorHigh(CRGBSet &set) {
-    const int swaps = set.size()/2;
-    for (int x = 0; x < swaps; x++) {
-        set[x] = set[set.size() - x - 1];
-    }
+    const int half = set.size()/2;
+    if (half == 0)
+        return;
+    CRGBSet low = set(0, half - 1);
+    CRGBSet high = set(set.size() - half, set.size() - 1);
+    replicateSet(high, low, Reverse);
 }
 
 /**
@@ -495,6 +587,73 @@ CRGB adjustBrightness(const CRGB color, uint8_t bright) {
     return {r, g, b};
 }
 
+/**
+ * Start of the memory block backing the first n pixels of a set, regardless of the set direction - a reversed set
+ * runs from high to low addresses, hence its first n pixels are backed by the n pixels ending at <code>leds</code>
+ * @param set pixel set
+ * @param n number of pixels, at most the set size
+ * @return the lowest address byte of the first n pixels of the set
+ */
+static uint8_t *setBytes(const CRGBSet &set, const uint16_t n) {
+    return reinterpret_cast<uint8_t*>(set.len < 0 ? set.leds - n + 1 : set.leds);
+}
+
+/**
+ * Whether two sets run in the same direction - pixel i of one set and pixel i of the other are then at the same offset
+ * in their respective memory blocks, and the sets can be processed as flat byte arrays
+ */
+static bool isSameDirection(const CRGBSet &a, const CRGBSet &b) {
+    return (a.len < 0) == (b.len < 0);
+}
+
+/**
+ * Scales down the brightness of all pixels in the set - same result as <code>CPixelView::nscale8</code>, computed 4 channels
+ * at a time with the packed kernels
+ * @param set pixel set
+ * @param scale scale factor, 255 leaves the pixels unchanged
+ */
+void scaleSet(CRGBSet &set, const uint8_t scale) {
+    const uint16_t n = abs(set.len);
+    scaleBytes(setBytes(set, n), n*3, scale);
+}
+
+/**
+ * Fades all pixels in the set towards black - same result as <code>CPixelView::fadeToBlackBy</code>
+ * @param set pixel set
+ * @param fadeBy how much to fade, 0 leaves the pixels unchanged
+ */
+void fadeSet(CRGBSet &set, const uint8_t fadeBy) {
+    scaleSet(set, 255 - fadeBy);
+}
+
+/**
+ * Blends a color into all pixels of the set - same result as <code>CPixelView::nblend(const CRGB&, fract8)</code>
+ * @param set pixel set, receives the result
+ * @param overlay color to blend in
+ * @param amount amount of overlay, 0 leaves the pixels unchanged, 255 fills the set with the overlay color
+ */
+void blendSet(CRGBSet &set, const CRGB &overlay, const fract8 amount) {
+    const uint16_t n = abs(set.len);
+    blendColorBytes(setBytes(set, n), n, overlay.raw, amount);
+}
+
+/**
+ * Blends the overlay set into the target set - same result as <code>CPixelView::nblend(const CPixelView&, fract8)</code>, except it
+ * stops at the end of the shorter set. The sets must not partially overlap.
+ * @param set pixel set, receives the result
+ * @param overlay pixels to blend in
+ * @param amount amount of overlay, 0 leaves the pixels unchanged, 255 copies the overlay
+ */
+void blendSet(CRGBSet &set, const CRGBSet &overlay, const fract8 amount) {
+    if (isSameDirection(set, overlay)) {
+        const uint16_t n = min(abs(set.len), abs(overlay.len));
+        blendBytes(setBytes(set, n), setBytes(overlay, n), n*3, amount);
+        return;
+    }
+    for (auto st = set.begin(), ov = overlay.begin(), stEnd = set.end(), ovEnd = overlay.end(); st != stEnd && ov != ovEnd; ++st, ++ov)
+        nblend(*st, *ov, amount);
+}
+
 /**
  * Blend multiply 2 colors
  * @param blendRGB base color, which is also the target (the one receiving the result)
@@ -516,6 +675,11 @@ void blendMultiply(CRGB &blendRGB, const CRGB &topRGB) {
  * @see https://en.wikipedia.org/wiki/Blend_modes
  */
 void blendMultiply(CRGBSet &blendLayer, const CRGBSet &topLayer) {
+    if (isSameDirection(blendLayer, topLayer)) {
+        const uint16_t n = min(abs(blendLayer.len), abs(topLayer.len));
+        multiplyBytes(setBytes(blendLayer, n), setBytes(topLayer, n), n*3);
+        return;
+    }
     for (auto bt = blendLayer.begin(), tp=topLayer.begin(), btEnd = blendLayer.end(), tpEnd = topLayer.end(); bt != btEnd && tp != tpEnd; ++bt, ++tp)
         blendMultiply(*bt, *tp);
 }
@@ -540,6 +704,11 @@ void blendScreen(CRGB &blendRGB, const CRGB &topRGB) {
  * @see https://en.wikipedia.org/wiki/Blend_modes
  */
 void blendScreen(CRGBSet &blendLayer, const CRGBSet &topLayer) {
+    if (isSameDirection(blendLayer, topLayer)) {
+        const uint16_t n = min(abs(blendLayer.len), abs(topLayer.len));
+        screenBytes(setBytes(blendLayer, n), setBytes(topLayer, n), n*3);
+        return;
+    }
     for (auto bt = blendLayer.begin(), tp=topLayer.begin(), btEnd = blendLayer.end(), tpEnd = topLayer.end(); bt != btEnd && tp != tpEnd; ++bt, ++tp)
         blendScreen(*bt, *tp);
 }
@@ -565,6 +734,11 @@ void blendOverlay(CRGB &blendRGB, const CRGB &topRGB) {
  * @see https://en.wikipedia.org/wiki/Blend_modes
  */
 void blendOverlay(CRGBSet &blendLayer, const CRGBSet &topLayer) {
+    if (isSameDirection(blendLayer, topLayer)) {
+        const uint16_t n = min(abs(blendLayer.len), abs(topLayer.len));
+        overlayBytes(setBytes(blendLayer, n), setBytes(topLayer, n), n*3);
+        return;
+    }
     for (auto bt = blendLayer.begin(), tp=topLayer.begin(), btEnd = blendLayer.end(), tpEnd = topLayer.end(); bt != btEnd && tp != tpEnd; ++bt, ++tp)
         blendOverlay(*bt, *tp);
 }
@@ -642,45 +816,56 @@ uint8_t adjustStripBrightness() {
     return FastLED.getBrightness();
 }
 
-/**
- *
- * @param rgb
- * @param br
- * @return
- */
-CRGB& setBrightness(CRGB &rgb, const uint8_t br) {
-    CHSV hsv = toHSV(rgb);
-    hsv.val = br;
-    rgb = toRGB(hsv);
-    return rgb;
+void adjustCurrentEffect(const time_t time) {
+    fxRegistry.invalidateSelection();   //time boundary - effect weights may have changed
+    fxRegistry.setSleepState(!isAwakeTime(time));
 }
 
+// EffectRegistry
 /**
- * Approximate brightness - leverages <code>rgb2hsv_approximate</code>
- * @param rgb color
- * @return approximate brightness on HSV scale
+ * Loads the effects catalog - no effect is instantiated at this time, only the slots for their instances are reserved
  */
-uint8_t getBrightness(const CRGB &rgb) {
-    //compare with rgb.getLuma() ?
-    return toHSV(rgb).val;
+void EffectRegistry::begin() {
+    effectsCount = effectCatalogSize;
+    effects = std::vector<std::atomic<LedEffect*>>(effectsCount);   //value initialized - all slots nullptr
+    for (uint16_t i = 0; i < effectsCount; ++i)
+        if (effectCatalog[i].flags & FxFlagSleep)
+            sleepEffect = i;
+    invalidateSelection();
+    log_info(F("Effects catalog loaded - %hu effects, sleep effect at index %hu"), effectsCount, sleepEffect);
 }
 
-void adjustCurrentEffect(const time_t time) {
-    fxRegistry.setSleepState(!isAwakeTime(time));
+/**
+ * The effect instance at the catalog index given - created through the catalog factory when first needed.
+ * Effects can be switched from other tasks (e.g. web server), hence the creation is guarded; the instance is published with
+ * release ordering once fully constructed, such that a reader loading the slot (acquire) never sees a partially built effect
+ * @param index catalog index, must be less than the catalog size
+ * @return the effect instance
+ */
+LedEffect *EffectRegistry::instance(const uint16_t index) const {
+    LedEffect *fx = effects[index].load(std::memory_order_acquire);
+    if (fx == nullptr) {
+        CoreMutex coreMutex(&mutex);
+        fx = effects[index].load(std::memory_order_relaxed);
+        if (fx == nullptr) {
+            fx = effectCatalog[index].factory();
+            fx->registryIndex = index;
+            effects[index].store(fx, std::memory_order_release);
+            log_info(F("Effect [%s] instantiated at index %hu"), fx->name(), index);
+        }
+    }
+    return fx;
 }
 
-// EffectRegistry
 LedEffect *EffectRegistry::getCurrentEffect() const {
-    return effects[currentEffect];
+    return instance(currentEffect);
 }
 
 uint16_t EffectRegistry::nextEffectPos(const char *id) {
-    for (size_t x = 0; x < effects.size(); x++) {
-        if (strcmp(id, effects[x]->name()) == 0) {
-            currentEffect = x;
-            transitionEffect();
-            return lastEffectRun;
-        }
+    if (const uint16_t x = fxCatalogIndex(id); x != FX_NOT_FOUND) {
+        currentEffect = x;
+        transitionEffect();
+        return lastEffectRun;
     }
     return 0;
 }
@@ -708,47 +893,120 @@ uint16_t EffectRegistry::curEffectPos() const {
 
 uint16_t EffectRegistry::nextRandomEffectPos() {
     if (autoSwitch && !sleepState) {
-        //weighted randomization of the next effect index
-        uint16_t totalSelectionWeight = 0;
-        for (auto const *fx:effects)
-            totalSelectionWeight += fx->selectionWeight();  //this allows each effect's weight to vary with time, holiday, etc.
-        uint16_t rnd = random16(0, totalSelectionWeight);
-        for (uint16_t i = 0; i < effectsCount; ++i) {
-            rnd = qsuba(rnd, effects[i]->selectionWeight());
-            if (rnd == 0) {
-                currentEffect = i;  //sleep effect weight is 0, so it cannot be chosen randomly
-                break;
-            }
-        }
+        currentEffect = randomEffectIndex();    //sleep effect weight is 0, so it cannot be chosen randomly
         transitionEffect();
     }
     return currentEffect;
 }
 
-void EffectRegistry::transitionEffect() const {
-    if (currentEffect != lastEffectRun) {
-        effects[lastEffectRun]->desiredState(Idle);
-        transEffect.setup();
+/**
+ * Builds the Walker alias table (Vose's variant, integer arithmetic) from the current selection weights of all effects.
+ * Each column stands for one effect and carries an equal share of the total weight: the column keeps its own effect with
+ * the probability given by its threshold, the remainder of its share is the excess weight of its alternate effect.
+ * Effects with weight 0 have a 0 threshold and are never anyone's alternate, hence they are never selected.
+ */
+void EffectRegistry::buildAliasTable() {
+    aliasIndex.resize(effectsCount);
+    aliasThreshold.resize(effectsCount);
+    aliasHoliday = paletteFactory.getHoliday();
+    aliasValid = true;
+    //scaled weights - weight * count, compared against the total weight (the share of one column)
+    std::vector<uint32_t> scaled(effectsCount);
+    std::vector<uint16_t> small, large;
+    small.reserve(effectsCount);
+    large.reserve(effectsCount);
+    aliasTotalWeight = 0;
+    for (uint16_t i = 0; i < effectsCount; ++i) {
+        const uint8_t weight = selectionWeight(i);  //read from the catalog - no effect instance needed
+        scaled[i] = weight * effectsCount;
+        aliasTotalWeight += weight;
+    }
+    for (uint16_t i = 0; i < effectsCount; ++i)
+        (scaled[i] < aliasTotalWeight ? small : large).push_back(i);
+    while (!small.empty() && !large.empty()) {
+        const uint16_t s = small.back();
+        small.pop_back();
+        const uint16_t l = large.back();
+        aliasThreshold[s] = static_cast<uint16_t>((static_cast<uint64_t>(scaled[s]) << 16) / aliasTotalWeight);
+        aliasIndex[s] = l;
+        //the large effect fills up the rest of the small effect's column
+        scaled[l] -= aliasTotalWeight - scaled[s];
+        if (scaled[l] < aliasTotalWeight) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    //leftover columns are full (exactly, or within rounding) - always select their own effect
+    for (const uint16_t i : large) {
+        aliasThreshold[i] = UINT16_MAX;
+        aliasIndex[i] = i;
+    }
+    for (const uint16_t i : small) {
+        aliasThreshold[i] = UINT16_MAX;
+        aliasIndex[i] = i;
     }
-    effects[currentEffect]->desiredState(Running);
 }
 
-uint16_t EffectRegistry::registerEffect(LedEffect *effect) {
-    effects.push_back(effect);  //pushing from the back to preserve the order or insertion during iteration
-    effectsCount = effects.size();
-    const uint16_t fxIndex = effectsCount - 1;
-    if (strcmp(FX_SLEEPLIGHT_ID, effect->name()) == 0)
-        sleepEffect = fxIndex;
-    log_info(F("Effect [%s] registered successfully at index %hu"), effect->name(), fxIndex);
-    return fxIndex;
+/**
+ * Weighted random selection of an effect - O(1) lookup in the alias table. The table is rebuilt only when the effect weights
+ * may have changed: catalog loaded, holiday changed, or explicitly invalidated (see <code>invalidateSelection</code>)
+ * @return index of the selected effect; the current effect if no effect is eligible for random selection (all weights are 0)
+ */
+uint16_t EffectRegistry::randomEffectIndex() {
+    if (!aliasValid || aliasHoliday != paletteFactory.getHoliday())
+        buildAliasTable();
+    if (aliasTotalWeight == 0)
+        return currentEffect;
+    const uint16_t column = random16(effectsCount);
+    return random16() < aliasThreshold[column] ? column : aliasIndex[column];
+}
+
+/**
+ * Moves the current effect towards running - the change from the last effect run is carried out by the FX task, either as a crossfade
+ * or by turning the strip off first (see <code>loop</code>)
+ */
+void EffectRegistry::transitionEffect() {
+    instance(currentEffect)->desiredState(Running);
+    switchPending = true;
 }
 
 LedEffect *EffectRegistry::findEffect(const char *id) const {
-    for (auto &fx : effects) {
-        if (strcmp(id, fx->name()) == 0)
-            return fx;
-    }
-    return nullptr;
+    const uint16_t index = fxCatalogIndex(id);
+    return index == FX_NOT_FOUND ? nullptr : instance(index);
+}
+
+const char *EffectRegistry::effectName(const uint16_t index) const {
+    return effectCatalog[capu(index, effectsCount-1)].id;
+}
+
+/**
+ * What weight does an effect have when random selection is engaged - per the effects catalog, reshaped by the current holiday
+ * @param index catalog index
+ * @return the selection weight; 0 removes the effect from random selection
+ */
+uint8_t EffectRegistry::selectionWeight(const uint16_t index) const {
+    const EffectDesc &desc = effectCatalog[capu(index, effectsCount-1)];
+    return paletteFactory.getHoliday() == Halloween ? desc.halloweenWeight : desc.weight;
+}
+
+uint16_t EffectRegistry::instancesCount() const {
+    uint16_t count = 0;
+    for (const auto &fx : effects)
+        if (fx.load(std::memory_order_acquire) != nullptr)
+            count++;
+    return count;
+}
+
+/**
+ * Describes an effect from its catalog entry - no effect instance needed
+ * @param index catalog index
+ * @param json the JSON object to populate
+ */
+void EffectRegistry::describeEffect(const uint16_t index, JsonObject &json) const {
+    json["description"] = effectCatalog[index].description;
+    json["name"] = effectCatalog[index].id;
+    json["registryIndex"] = index;
+    json["palette"] = holidayToString(paletteFactory.getHoliday());
 }
 
 void EffectRegistry::setSleepState(const bool sleepFlag) {
@@ -778,35 +1036,66 @@ void EffectRegistry::enableSleep(const bool bSleep) {
 }
 
 /**
- * Sets the desired state for all effects to setup. It will essentially make each effect ready to run if invoked - the state machine will ensure the setup() is called first
+ * Sets the desired state for all instantiated effects to setup. It will essentially make each effect ready to run if invoked - the state machine will ensure the setup() is called first.
+ * Effects instantiated later start in Idle state, which moves to Setup as well when the effect is selected to run
  */
 void EffectRegistry::setup() const {
-    for (auto &fx : effects)
-        fx->desiredState(Setup);
+    for (const auto &slot : effects)
+        if (LedEffect *fx = slot.load(std::memory_order_acquire); fx != nullptr)
+            fx->desiredState(Setup);
     transEffect.setup();
 }
 
+/**
+ * Records the current effect as the effect running - from the last effect run
+ */
+void EffectRegistry::effectChanged() {
+    log_info(F("Effect change: from index %d [%s] to %d [%s]"),
+            lastEffectRun, effectCatalog[lastEffectRun].description, currentEffect, effectCatalog[currentEffect].description);
+    lastEffectRun = currentEffect;
+    lastEffects.push(lastEffectRun);
+    postFxChangeEvent(lastEffectRun);
+}
+
 void EffectRegistry::loop() {
-    //if effect has changed, re-run the effect's setup
-    if ((lastEffectRun != currentEffect) && (effects[lastEffectRun]->getState() == Idle)) {
-        log_info(F("Effect change: from index %d [%s] to %d [%s]"),
-                lastEffectRun, effects[lastEffectRun]->description(), currentEffect, effects[currentEffect]->description());
-        lastEffectRun = currentEffect;
-        lastEffects.push(lastEffectRun);
-        postFxChangeEvent(lastEffectRun);
+    //effect change requested - crossfade into the new effect; if not possible, turn the strip off and run the new effect's setup after
+    if (switchPending) {
+        switchPending = false;
+        if (lastEffectRun != currentEffect) {
+            crossfade.finish();     //a change during a crossfade cuts it short
+            if (crossfade.begin(instance(lastEffectRun), instance(currentEffect)))
+                effectChanged();
+            else {
+                instance(lastEffectRun)->desiredState(Idle);
+                transEffect.setup();
+            }
+        }
+    }
+    if (crossfade.isActive()) {
+        crossfade.loop();
+        return;
     }
-    effects[lastEffectRun]->loop();
+    if ((lastEffectRun != currentEffect) && (instance(lastEffectRun)->getState() == Idle))
+        effectChanged();
+    instance(lastEffectRun)->loop();
 }
 
+/**
+ * Describes all effects - instantiated effects add their own configuration, the others are described from the catalog
+ * @param json the JSON array to populate
+ */
 void EffectRegistry::describeConfig(const JsonArray &json) const {
-    for (auto & effect : effects) {
+    for (uint16_t i = 0; i < effectsCount; ++i) {
         auto fxJson = json.add<JsonObject>();
-        effect->baseConfig(fxJson);
+        if (const LedEffect *fx = effects[i].load(std::memory_order_acquire); fx != nullptr)
+            fx->baseConfig(fxJson);
+        else
+            describeEffect(i, fxJson);
     }
 }
 
 LedEffect *EffectRegistry::getEffect(const uint16_t index) const {
-    return effects[capu(index, effectsCount-1)];
+    return instance(capu(index, effectsCount-1));
 }
 
 void EffectRegistry::autoRoll(const bool switchType) {
@@ -831,7 +1120,7 @@ uint16_t EffectRegistry::size() const {
 
 void EffectRegistry::pastEffectsRun(const JsonArray &json) {
     for (const auto &fxIndex: lastEffects)
-        json.add(getEffect(fxIndex)->name());
+        json.add(effectName(fxIndex));
 }
 
 // LedEffect
@@ -840,33 +1129,28 @@ uint16_t LedEffect::getRegistryIndex() const {
 }
 
 void LedEffect::baseConfig(JsonObject &json) const {
-    json["description"] = description();
-    json["name"] = name();
-    json["registryIndex"] = getRegistryIndex();
-    json["palette"] = holidayToString(paletteFactory.getHoliday());
+    fxRegistry.describeEffect(registryIndex, json);
 }
 
-LedEffect::LedEffect(const char *description) : state(Idle), desc(description) {
-    //copy into id field the prefix of description (e.g. for a description 'FxA1: awesome lights', copies 'FxA1' into id)
-    for (uint8_t i=0; i<LED_EFFECT_ID_SIZE; i++) {
-        if (description[i] == ':' || description[i] == '\0') {
-            id[i] = '\0';
-            break;
-        }
-        id[i] = description[i];
-    }
-    //in case the prefix in description is larger, ensure id is null terminated (i.e. truncate)
-    id[LED_EFFECT_ID_SIZE-1] = '\0';
-    //register the effect
-    registryIndex = fxRegistry.registerEffect(this);
-}
+/**
+ * Effects are created by the effect registry, through their factory in the effects catalog - the registry assigns the catalog index
+ */
+LedEffect::LedEffect() : state(Idle) {}
 
 const char *LedEffect::name() const {
-    return id;
+    return effectCatalog[registryIndex].id;
 }
 
 const char *LedEffect::description() const {
-    return desc;
+    return effectCatalog[registryIndex].description;
+}
+
+/**
+ * What weight does this effect have when random selection is engaged - see the effects catalog
+ * @return a value between 1 and 255. If returning 0, this effectively removes the effect from random selection.
+ */
+uint8_t LedEffect::selectionWeight() const {
+    return fxRegistry.selectionWeight(registryIndex);
 }
 
 /**
@@ -890,7 +1174,7 @@ bool LedEffect::transitionBreak() {
  * Called only once as the effect transitions into TransitionBreak state, before the loop calls to <code>transitionBreak</code>
  */
 void LedEffect::transitionBreakPrep() {
-    //nothing for now
+    frameOutput.fence();    //the last wind down frame is on the strip before the break
 }
 
 /**
@@ -901,13 +1185,24 @@ bool LedEffect::windDown() {
     return transEffect.transition();
 }
 
+/**
+ * Renders a span of the current frame across both cores, through the effect's <code>renderSpan</code> range kernel - for effects whose
+ * frame rendering is span parallel; all others render from <code>run</code> on the FX task alone
+ * @param lo first element of the span
+ * @param hi end of the span (exclusive)
+ * @param callerShare share of the span rendered by the FX task, out of 256 - see <code>SpanRenderer::render</code>
+ */
+void LedEffect::renderSpans(const uint16_t lo, const uint16_t hi, const uint8_t callerShare) {
+    spanRender.render([](void *fx, const uint16_t l, const uint16_t h) { static_cast<LedEffect *>(fx)->renderSpan(l, h); }, this, lo, hi, callerShare);
+}
+
 /**
  * Called only once as the effect transitions into WindDown state, before the loop calls to <code>windDown</code>
  */
 void LedEffect::windDownPrep() {
     CRGBSet strip(leds, NUM_PIXELS);
-    strip.nblend(ColorFromPalette(targetPalette, random8(), 72, LINEARBLEND), 80);
-    FastLED.show(stripBrightness);
+    blendSet(strip, ColorFromPalette(targetPalette, random8(), 72, LINEARBLEND), 80);
+    showStrip(stripBrightness);
     transEffect.prepare(random8());
 }
 
@@ -915,21 +1210,36 @@ void LedEffect::windDownPrep() {
  * Re-entrant looping function
  */
 void LedEffect::loop() {
+    if (state == Idle)
+        return;
+    const EffectState loopState = state;
+    const uint32_t start = time_us_32();
+    fxTiming.loopStart();
     switch (state) {
         case Setup:
+            fxArena.reset();        //scratch state left behind by an effect that did not complete its wind down
+            outputMap.cancel();     //nor does the mapping of the frame the previous effect rendered carry over
             setup();
+            fxTiming.recordArena(registryIndex, fxArena.size());
+            if (fxArena.size() > 0 && !(effectCatalog[registryIndex].flags & FxFlagArena))
+                log_error(F("Effect %s [%d] allocates %zu bytes of scratch arena but is not flagged as an arena user in the catalog"), name(), getRegistryIndex(), fxArena.size());
             log_info(F("Effect %s [%d] completed setup, moving to running state"), name(), getRegistryIndex());
             nextState();
             break;    //one blocking step, non repeat
-        case Running: run(); break;                 //repeat, called multiple times to achieve the light effects designed
+        case Running:
+            syncPaletteCaches();    //palettes blended or replaced during the previous step are expanded once, ahead of this frame
+            run();
+            break;                  //repeat, called multiple times to achieve the light effects designed
         case WindDownPrep:
+            outputMap.apply();      //the wind down transitions work on the whole LED buffer - the replicated region is materialized
             windDownPrep();
             log_info(F("Effect %s [%d] completed WindDown Prep"), name(), getRegistryIndex());
             nextState();
             break;
         case WindDown:
+            outputMap.apply();
             if (windDown()) {
-                log_info(F("Effect %s [%d] completed WindDown"), name(), getRegistryIndex());
+                log_info(F("Effect %s [%d] completed WindDown, released %zu bytes of scratch arena"), name(), getRegistryIndex(), fxArena.reset());
                 nextState();
             }
             break;           //repeat, called multiple times to achieve the fade out for the current light effect
@@ -946,6 +1256,9 @@ void LedEffect::loop() {
             break; //repeat, called multiple times to achieve the transition off for the current light effect
         case Idle: break;                           //no-op
     }
+    if (loopState != WindDown)
+        litMap.invalidate();    //effects write pixels freely - only the wind down transitions keep the lit map bounds valid
+    fxTiming.recordLoop(registryIndex, loopState, transEffect.type(), time_us_32() - start);
 }
 
 /**
@@ -1056,16 +1369,22 @@ uint16_t Viewport::size() const {
 //Setup all effects -------------------
 void fx_setup() {
     ledStripInit();
+    topology.load(topologyFileName);
+    litMap.resize(topology.logicalSize());
     //instantiate effect categories
-    for (const auto x : categorySetup)
-        x();
+    fxRegistry.begin();
+    fxTiming.begin(fxRegistry.size());
+#if FX_BENCH_ENABLED == 1
+    fxBenchmark();
+#endif
     //strip brightness adjustment needs the time, that's why it is done in fxRun periodically. At the beginning we'll use the value from saved state
     readFxState();
     transEffect.setup();
 
-    shuffleIndexes(stripShuffleIndex, NUM_PIXELS);
+    stripShuffle.reset(topology.logicalSize(), shuffleSeed());
     //ensure the current effect is moved to setup state
     fxRegistry.getCurrentEffect()->desiredState(Setup);
+    fxScheduler.begin();
 
     //generate and cache the FX config data
     JsonDocument doc;
@@ -1084,15 +1403,60 @@ void fx_setup() {
                fxRegistry.getCurrentEffect()->getRegistryIndex(), Setup);
 }
 
+/**
+ * Reacts to the audio bumps, at most once every <code>AUDIO_BUMP_DEBOUNCE_MS</code> - bumps within that window are dropped.
+ * By default the audio bump effect is screen blended over the running effect on the top layer for <code>AUDIO_BUMP_FLASH_MS</code>,
+ * provided the layer is free, the bump effect is not the one running and the board is not asleep. The layer is removed at the
+ * end of the flash, unless it has been configured otherwise since. With <code>AUDIO_BUMP_ADVANCE</code> set, a bump advances
+ * to the next effect instead.
+ */
+static void audioBumpFlash() {
+    static uint32_t flashStart = 0;
+    static uint32_t lastBump = 0;
+    static bool bumped = false;
+    static LedEffect *flashFx = nullptr;
+    if (flashFx != nullptr && millis() - flashStart >= AUDIO_BUMP_FLASH_MS) {
+        if (fxLayers.effect(AUDIO_BUMP_LAYER) == flashFx)
+            fxLayers.configure(AUDIO_BUMP_LAYER, LayerConfig {});      //opacity 0 removes the layer
+        flashFx = nullptr;
+    }
+    if (!fxBump)
+        return;
+    fxBump = false;
+    totalAudioBumps++;
+    if (bumped && millis() - lastBump < AUDIO_BUMP_DEBOUNCE_MS)
+        return;
+#if AUDIO_BUMP_ADVANCE
+    if (fxRegistry.isAsleep())
+        return;
+    bumped = true;
+    lastBump = millis();
+    log_info(F("Audio triggered effect incremental change"));
+    fxRegistry.nextEffectPos();
+#else
+    const uint16_t fxIndex = fxCatalogIndex(FX_AUDIO_BUMP_ID);
+    if (flashFx != nullptr || fxRegistry.isAsleep() || fxLayers.effect(AUDIO_BUMP_LAYER) != nullptr || fxIndex == FX_NOT_FOUND ||
+        fxIndex == fxRegistry.curEffectPos())
+        return;
+    LayerConfig cfg;
+    cfg.fxIndex = fxIndex;
+    cfg.mode = BlendScreen;
+    cfg.opacity = 255;
+    cfg.hi = NUM_PIXELS;
+    fxLayers.configure(AUDIO_BUMP_LAYER, cfg);
+    flashFx = fxRegistry.getEffect(fxIndex);
+    flashStart = lastBump = millis();
+    bumped = true;
+    log_info(F("Audio bump flashed over the running effect - %s on layer %d"), FX_AUDIO_BUMP_ID, AUDIO_BUMP_LAYER);
+#endif
+}
+
 //Run currently selected effect -------
 void fx_run() {
+    //block until the earliest frame deadline requested by the current effect
+    fxScheduler.waitNextFrame();
+    audioBumpFlash();
     EVERY_N_SECONDS(30) {
-        if (fxBump) {
-            log_info(F("Audio triggered effect incremental change"));
-            fxRegistry.nextEffectPos();
-            fxBump = false;
-            totalAudioBumps++;
-        }
         const uint8_t oldBrightness = stripBrightness;
         stripBrightness = adjustStripBrightness();
         if (oldBrightness != stripBrightness)
@@ -1101,12 +1465,14 @@ void fx_run() {
     EVERY_N_MINUTES(7) {
         log_info(F("Switching effect to a new random one"));
         fxRegistry.nextRandomEffectPos();
-        shuffleIndexes(stripShuffleIndex, NUM_PIXELS);
+        stripShuffle.reseed(shuffleSeed());
         saveFxState();
     }
 
     fxRegistry.loop();
+    fxLayers.loop();
     watchdogPing();
+    fxScheduler.loopDone();
 }
 
 // FxSchedule functions
@@ -0,0 +1,100 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include <ArduinoECCX08.h>
+#include <FastLED.h>
+#include "entropy_pool.h"
+#include "util.h"
+#include "sysinfo.h"
+#include "log.h"
+
+EntropyPool entropyPool;
+
+/**
+ * Adds a block of secure random values to the pool - one ECC608 random command, about 25ms of I2C traffic.
+ * Must be called from the diagnostic task only, as it owns the I2C bus.
+ * @return true if the block has been added; false if the pool does not have room for a block, or the secure element is
+ * not available or has failed the command
+ */
+bool EntropyPool::refill() {
+    if (!needsRefill() || !sysInfo->isSysStatus(SYS_STATUS_ECC))
+        return false;
+    uint16_t block[ENTROPY_BLOCK_SIZE];
+    if (!ECCX08.random(reinterpret_cast<byte *>(block), sizeof(block))) {
+        refillErrors = refillErrors + 1;
+        log_warn(F("ECC608 random command failed - entropy pool level %hu"), level());
+        return false;
+    }
+    uint16_t h = head.load(std::memory_order_relaxed);
+    for (const uint16_t v : block)
+        ring[h++ & (ENTROPY_POOL_SIZE - 1)] = v;
+    //publishes the values written above to the consumer
+    head.store(h, std::memory_order_release);
+    refills = refills + 1;
+    return true;
+}
+
+/**
+ * Takes the next secure random value from the pool, O(1). Must be called from the FX task only (single consumer).
+ * @param val receives the random value
+ * @return true if a value has been taken; false if the pool is empty
+ */
+bool EntropyPool::draw(uint16_t &val) {
+    const uint16_t t = tail.load(std::memory_order_relaxed);
+    const uint16_t lvl = head.load(std::memory_order_acquire) - t;
+    if (lvl == 0)
+        return false;
+    val = ring[t & (ENTROPY_POOL_SIZE - 1)];
+    tail.store(t + 1, std::memory_order_release);
+    if (lvl == ENTROPY_POOL_SIZE)
+        primed = true;
+    if (primed && lvl - 1 < lowLevel)
+        lowLevel = lvl - 1;
+    drawn = drawn + 1;
+    return true;
+}
+
+/**
+ * Random 16-bit value - secure when the pool has values, FastLED's pseudo random otherwise
+ * @return random value in [0, 65535]
+ */
+uint16_t EntropyPool::random16() {
+    uint16_t val;
+    if (draw(val))
+        return val;
+    fallbacks = fallbacks + 1;
+    return ::random16();
+}
+
+/**
+ * Random value in a range, same semantics as FastLED's <code>random16(lim)</code>
+ * @param lim upper limit, exclusive
+ * @return random value in [0, lim)
+ */
+uint16_t EntropyPool::random16(const uint16_t lim) {
+    return (static_cast<uint32_t>(random16()) * lim) >> 16;
+}
+
+/**
+ * Random value in a range, same semantics as FastLED's <code>random16(min, lim)</code>
+ * @param min lower limit, inclusive
+ * @param lim upper limit, exclusive
+ * @return random value in [min, lim)
+ */
+uint16_t EntropyPool::random16(const uint16_t min, const uint16_t lim) {
+    return random16(lim - min) + min;
+}
+
+/**
+ * Pool fill level and usage counters
+ * @param json object to populate
+ */
+void EntropyPool::stats(const JsonObject &json) const {
+    json["level"] = level();
+    json["capacity"] = ENTROPY_POOL_SIZE;
+    json["lowLevel"] = lowLevel;
+    json["refills"] = refills;
+    json["refillErrors"] = refillErrors;
+    json["drawn"] = drawn;
+    json["fallbacks"] = fallbacks;
+}
@@ -0,0 +1,122 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include "fire_sim.h"
+#include "fx_arena.h"
+
+/**
+ * Allocates the heat cells of all fire segments from the scratch arena - call from the effect setup. All cells start cold.
+ * @param fires array of fire segments, the caller keeps it alive while the simulation runs
+ * @param numFires number of fire segments
+ * @param cool how much the air cools as it rises - less cooling means taller flames. Suggested range 20-100
+ * @param spark chance (out of 255) a new spark is lit at the base of a fire - higher chance means a more roaring fire. Suggested range 50-200
+ * @return true if the simulation has been allocated; false if the arena is exhausted - the simulation then has no segments
+ */
+bool FireSim::begin(CRGBSet *fires, const uint8_t numFires, const uint8_t cool, const uint8_t spark) {
+    numSegs = 0;
+    segs = fires;
+    cooling = cool;
+    sparking = spark;
+    ofs = fxArena.makeArray<uint16_t>(numFires + 1);
+    if (ofs == nullptr)
+        return false;
+    for (uint8_t k = 0; k < numFires; k++)
+        ofs[k+1] = ofs[k] + fires[k].size();
+    heat = fxArena.makeArray<uint8_t>(ofs[numFires]);
+    rnd = fxArena.makeArray<uint8_t>(ofs[numFires]);
+    if (heat == nullptr || rnd == nullptr)
+        return false;
+    numSegs = numFires;
+    return true;
+}
+
+/**
+ * Draws a batch of random numbers - same sequence and values as calling <code>random8(lim)</code> count times, with the generator
+ * state kept in a register for the whole batch
+ * @param dest destination of the random numbers
+ * @param count how many numbers to draw
+ * @param lim upper limit of the random numbers (exclusive)
+ */
+void FireSim::random8Batch(uint8_t *dest, const uint16_t count, const uint8_t lim) {
+    uint16_t seed = rand16seed;
+    for (uint16_t i = 0; i < count; i++) {
+        seed = static_cast<uint16_t>(seed * FASTLED_RAND16_2053 + FASTLED_RAND16_13849);
+        const uint8_t r = static_cast<uint8_t>(seed) + static_cast<uint8_t>(seed >> 8);
+        dest[i] = (r * lim) >> 8;
+    }
+    rand16seed = seed;
+}
+
+/**
+ * Advances the heat simulation of one fire segment - cooling, drifting up and sparking
+ * @param seg fire segment
+ */
+void FireSim::step(const uint8_t seg) {
+    uint8_t *h = heat + ofs[seg];
+    uint8_t *r = rnd + ofs[seg];
+    const uint16_t n = ofs[seg+1] - ofs[seg];
+    if (n == 0)
+        return;
+
+    // Step 1.  Cool down every cell a little
+    random8Batch(r, n, static_cast<uint8_t>((cooling * 10) / n + 2));
+    for (uint16_t i = 0; i < n; i++)
+        h[i] = qsub8(h[i], r[i]);
+
+    // Step 2.  Heat from each cell drifts 'up' and diffuses a little
+    for (uint16_t k = n - 1; k >= 2; k--)
+        h[k] = (h[k - 1] + h[k - 2] + h[k - 2]) / 3;
+
+    // Step 3.  Randomly ignite new 'sparks' of heat near the bottom
+    if (random8() < sparking) {
+        const uint8_t y = random8(7);
+        const uint8_t sparkHeat = random8(160, 255);
+        if (y < n)
+            h[y] = qadd8(h[y], sparkHeat);
+    }
+}
+
+/**
+ * Advances the heat simulation of all fire segments, in order, and draws the flicker heights their rendering uses - the random draws
+ * follow the same sequence as simulating and rendering each segment in turn
+ */
+void FireSim::advance() {
+    for (uint8_t s = 0; s < numSegs; s++) {
+        step(s);
+        random8Batch(rnd + ofs[s], ofs[s+1] - ofs[s], 4);
+    }
+}
+
+/**
+ * Maps a range of heat cells to colors - the flame above a random height of 5 to 8 pixels is dimmed to the brightness given. The cells
+ * of all segments are indexed back to back, the range may span several segments. Writes only the pixels of the cells in range.
+ * @param colors expanded palette - the heat scaled down to 0-240 is the palette index, for best results with color palettes
+ * @param brightness brightness of the flame above the base
+ * @param lo first cell of the range
+ * @param hi end of the range (exclusive)
+ */
+void FireSim::renderCells(const PaletteCache &colors, const uint8_t brightness, const uint16_t lo, const uint16_t hi) {
+    for (uint8_t s = 0; s < numSegs; s++) {
+        if (ofs[s+1] <= lo || ofs[s] >= hi)
+            continue;
+        const uint8_t *h = heat + ofs[s];
+        const uint8_t *r = rnd + ofs[s];
+        CRGBSet &fire = segs[s];
+        const uint16_t jEnd = min(hi, ofs[s+1]) - ofs[s];
+        for (uint16_t j = max(lo, ofs[s]) - ofs[s]; j < jEnd; j++) {
+            fire[j] = colors.color(scale8(h[j], 240));
+            if (j > r[j] + 5)
+                fire[j].nscale8(brightness);
+        }
+    }
+}
+
+/**
+ * Runs a simulation frame for all fire segments on the calling core
+ * @param colors expanded palette
+ * @param brightness brightness of the flames above the base
+ */
+void FireSim::update(const PaletteCache &colors, const uint8_t brightness) {
+    advance();
+    renderCells(colors, brightness, 0, cells());
+}
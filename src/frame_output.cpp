@@ -0,0 +1,132 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include "hardware/timer.h"
+#include "frame_output.h"
+#include "log.h"
+
+FrameOutput frameOutput;
+
+/**
+ * Binds the output to the strip controller and readies the hand over semaphore - call from the FX task setup, before the first frame
+ * @param ctl the LED strip controller
+ */
+void FrameOutput::begin(CLEDController &ctl) {
+    controller = &ctl;
+    controller->setLeds(buffers[front], NUM_PIXELS);
+    idle = xSemaphoreCreateBinary();
+    xSemaphoreGive(idle);
+}
+
+/**
+ * Attaches the calling task as the Show task - frames are pushed asynchronously from now on
+ */
+void FrameOutput::attach() {
+    worker = xTaskGetCurrentTaskHandle();
+    log_info(F("Strip output attached to task %s - frames pushed asynchronously"), pcTaskGetName(worker));
+}
+
+/**
+ * Pushes the front buffer to the strip - the output LUT has already applied all color adjustments, hence shown unscaled. The
+ * interval since the previous push is recorded.
+ */
+void FrameOutput::push() {
+    const uint32_t start = time_us_32();
+    controller->setLeds(buffers[front], NUM_PIXELS);
+    FastLED.show(255);
+    const uint32_t elapsed = time_us_32() - start;
+    pushUs = elapsed;
+    if (elapsed > pushMaxUs)
+        pushMaxUs = elapsed;
+    if (pushes > 0) {
+        CoreMutex coreMutex(&mutex);
+        interval.add(start - lastPushStart);
+    }
+    lastPushStart = start;
+    pushes = pushes + 1;
+}
+
+/**
+ * Waits for the frame in flight, if any, to be pushed - the wait is accounted for in the statistics
+ * @return true if the output is ready for a new frame; false if not yet set up
+ */
+bool FrameOutput::acquire() {
+    if (idle == nullptr)
+        return false;
+    if (xSemaphoreTake(idle, 0) == pdTRUE)
+        return true;
+    const uint32_t start = time_us_32();
+    xSemaphoreTake(idle, portMAX_DELAY);
+    fenceWaits++;
+    fenceWaitUs += time_us_32() - start;
+    return true;
+}
+
+/**
+ * Hands the back buffer over to be pushed to the strip - waits for the previous frame to be pushed first. The back buffer must not
+ * be written again until the next call, which will then find it free.
+ */
+void FrameOutput::submit() {
+    if (!acquire())
+        return;
+    front ^= 1;
+    if (worker == nullptr) {
+        push();
+        xSemaphoreGive(idle);
+        return;
+    }
+    xTaskNotifyGive(worker);
+}
+
+/**
+ * Waits for the frame handed over last to be on the strip
+ */
+void FrameOutput::fence() {
+    if (acquire())
+        xSemaphoreGive(idle);
+}
+
+/**
+ * Show task step - waits for a frame to be handed over and pushes it
+ */
+void FrameOutput::run() {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    push();
+    xSemaphoreGive(idle);
+}
+
+/**
+ * Marshals the strip output statistics into the JSON object provided
+ * @param json JSON object to add the statistics to
+ */
+void FrameOutput::stats(const JsonObject &json) const {
+    TimeHistogram intervalCopy;
+    {
+        CoreMutex coreMutex(&mutex);
+        intervalCopy = interval;
+    }
+    json["async"] = worker != nullptr;
+    json["pushed"] = pushes;
+    json["lastPush"] = pushUs;
+    json["maxPush"] = pushMaxUs;
+    json["waits"] = fenceWaits;
+    json["avgWait"] = fenceWaits > 0 ? static_cast<uint32_t>(fenceWaitUs / fenceWaits) : 0;
+    //frame rate from the median interval; frames held unchanged are not pushed, hence it reads low on static effects
+    const uint32_t p50 = intervalCopy.percentile(50);
+    json["fps"] = p50 > 0 ? 1000000 / p50 : 0;
+    intervalCopy.toJson(json["interval"].to<JsonObject>());
+}
+
+/**
+ * Show task setup - attaches the task to the strip output
+ */
+void show_setup() {
+    frameOutput.attach();
+}
+
+/**
+ * Show task loop
+ */
+void show_run() {
+    frameOutput.run();
+}
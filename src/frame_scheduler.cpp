@@ -0,0 +1,146 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include "hardware/timer.h"
+#include "frame_scheduler.h"
+
+FrameScheduler fxScheduler;
+
+// FrameTimer
+FrameTimer::FrameTimer(const uint32_t period) : prevTrigger(GET_MILLIS()), period(period) {}
+
+/**
+ * Checks whether the timer period has elapsed; either way the next deadline of this timer is reported to the frame scheduler
+ * @return true if the timer period has elapsed, false otherwise
+ */
+bool FrameTimer::ready() {
+    //not polled during the previous loop - resuming after a pause, the first trigger is neither a miss nor a jitter sample
+    const uint32_t loop = fxScheduler.loopCount();
+    if (loop - prevPollLoop > 1)
+        prevTriggerUs = 0;
+    prevPollLoop = loop;
+    const uint32_t now = GET_MILLIS();
+    const uint32_t due = prevTrigger + period;
+    if (static_cast<int32_t>(now - due) < 0) {
+        fxScheduler.request(due);
+        return false;
+    }
+    const uint32_t nowUs = time_us_32();
+    if ((now - due) < period) {
+        //phase locked - next deadline follows from the current one
+        prevTrigger = due;
+        if (prevTriggerUs > 0) {
+            const int32_t dev = static_cast<int32_t>(nowUs - prevTriggerUs - period * 1000);
+            fxScheduler.frameTriggered(abs(dev));
+        }
+    } else {
+        //fell behind more than a period - re-synchronize with current time
+        prevTrigger = now;
+        if (prevTriggerUs > 0)
+            fxScheduler.frameMissed();
+    }
+    prevTriggerUs = nowUs;
+    fxScheduler.request(prevTrigger + period);
+    return true;
+}
+
+/**
+ * Restarts the timer period from current time
+ */
+void FrameTimer::reset() {
+    prevTrigger = GET_MILLIS();
+    prevTriggerUs = 0;
+    prevPollLoop = fxScheduler.loopCount();
+}
+
+// FrameScheduler
+/**
+ * Initializes the scheduler time references - called once from the FX task setup
+ */
+void FrameScheduler::begin() {
+    wakeTick = xTaskGetTickCount();
+    wakeMs = GET_MILLIS();
+    wakeUs = time_us_32();
+    earliest = wakeMs;
+    requests = 0;
+    resetStats();
+}
+
+/**
+ * Records a deadline requested by a frame timer during current loop - only the earliest one is retained
+ * @param deadline deadline time in ms
+ */
+void FrameScheduler::request(const uint32_t deadline) {
+    if (requests == 0 || static_cast<int32_t>(deadline - earliest) < 0)
+        earliest = deadline;
+    requests++;
+}
+
+/**
+ * Records a frame timer trigger and its deviation from the ideal frame period
+ * @param jitterUs absolute deviation from the timer period, in microseconds
+ */
+void FrameScheduler::frameTriggered(const uint32_t jitterUs) {
+    frames++;
+    jitterSumUs += jitterUs;
+    jitterMaxUs = max(jitterMaxUs, jitterUs);
+}
+
+/**
+ * Records a frame timer that has fallen behind its schedule by more than a period
+ */
+void FrameScheduler::frameMissed() {
+    missed++;
+}
+
+/**
+ * Blocks the FX task until the earliest deadline requested during previous loop, at most <code>FX_SCHED_MAX_SLEEP_MS</code>.
+ * The sleep is relative to the previous wake-up time, hence the time spent rendering does not delay the next frame.
+ * When no deadlines have been requested there is no blocking here - the task wrapper already gives up the CPU for one tick
+ * between loops.
+ */
+void FrameScheduler::waitNextFrame() {
+    if (requests > 0) {
+        const int32_t ahead = static_cast<int32_t>(earliest - wakeMs);
+        if (const uint32_t waitMs = constrain(ahead, 0, FX_SCHED_MAX_SLEEP_MS); static_cast<int32_t>(wakeMs + waitMs - GET_MILLIS()) > 0) {
+            vTaskDelayUntil(&wakeTick, pdMS_TO_TICKS(waitMs));
+            sleeps++;
+        }
+    } else
+        polls++;
+    wakeTick = xTaskGetTickCount();
+    wakeMs = GET_MILLIS();
+    wakeUs = time_us_32();
+    requests = 0;
+    loops++;
+}
+
+/**
+ * Marks the end of the FX task loop processing - accounts for the busy time since the last wake-up
+ */
+void FrameScheduler::loopDone() {
+    busyUs += time_us_32() - wakeUs;
+}
+
+void FrameScheduler::resetStats() {
+    statsStartUs = time_us_64();
+    busyUs = 0;
+    frames = missed = sleeps = polls = 0;
+    jitterSumUs = 0;
+    jitterMaxUs = 0;
+}
+
+/**
+ * Marshals the frame pacing statistics into the JSON object provided
+ * @param json JSON object to add the statistics to
+ */
+void FrameScheduler::stats(const JsonObject &json) const {
+    const uint64_t elapsedUs = time_us_64() - statsStartUs;
+    json["frames"] = frames;
+    json["missedFrames"] = missed;
+    json["avgJitterUs"] = frames > 0 ? static_cast<uint32_t>(jitterSumUs / frames) : 0;
+    json["maxJitterUs"] = jitterMaxUs;
+    json["sleeps"] = sleeps;
+    json["polls"] = polls;
+    json["busyPct"] = elapsedUs > 0 ? static_cast<float>(busyUs) * 100.0f / static_cast<float>(elapsedUs) : 0.0f;
+}
@@ -8,25 +8,8 @@
 using namespace FxA;
 using namespace colTheme;
 
-//~ Effect description strings stored in flash
-constexpr auto fxa1Desc PROGMEM = "FXA1: Multiple Tetris segments";
-constexpr auto fxa2Desc PROGMEM = "FXA2: Randomly sized and spaced segments moving on entire strip";
-constexpr auto fxa3Desc PROGMEM = "FXA3: Moving variable dot size back and forth";
-constexpr auto fxa4Desc PROGMEM = "FXA4: pixel segments moving opposite directions";
-constexpr auto fxa5Desc PROGMEM = "FXA5: Moving a color swath on top of another";
-constexpr auto fxa6Desc PROGMEM = "FXA6: Sleep Light";
-
 uint16_t FxA::szStack = 0;
 
-void FxA::fxRegister() {
-    new FxA1();
-    new FxA2();
-    new FxA3();
-    new FxA4();
-    new FxA5();
-    new SleepLight();
-}
-
 void FxA::resetStack() {
     szStack = 0;
     curPos = 0;
@@ -61,13 +44,13 @@ uint16_t FxA::fxa_stackAdjust(CRGBSet &set, const uint16_t szStackSeg) {
 // Effect Definitions - setup and loop
 ///////////////////////////////////////
 //FX A1
-FxA1::FxA1() : LedEffect(fxa1Desc), dot(frame(0, FRAME_SIZE-1)) {
+FxA1::FxA1() : dot(frame(0, FRAME_SIZE-1)) {
     dot.fill_solid(BKG);
 }
 
 void FxA1::setup() {
     LedEffect::setup();
-    makeDot(ColorFromPalette(palette, colorIndex, random8(dimmed + 50, brightness), LINEARBLEND), szSegment);
+    makeDot(paletteCache.color(colorIndex, random8(dimmed + 50, brightness)), szSegment);
 }
 
 void FxA1::makeDot(const CRGB color, const uint16_t szDot) const {
@@ -85,7 +68,7 @@ void FxA1::run() {
             resetStack();
         return;
     }
-    EVERY_N_MILLISECONDS_I(a1Timer, speed) {
+    FRAME_EVERY_N_MILLIS_I(a1Timer, speed) {
         const uint16_t upLimit = tpl.size() - szStack;
         const uint16_t movLimit = upLimit + szSegment - szStackSeg;
         shiftRight(tpl, curPos < szSegment ? dot[curPos] : BKG, (Viewport) upLimit);
@@ -94,9 +77,9 @@ void FxA1::run() {
         replicateSet(tpl, others);
 
         if (paletteFactory.getHoliday() == Halloween)
-            FastLED.show(random8(32, stripBrightness)); //add a flicker
+            showStrip(random8(32, stripBrightness)); //add a flicker
         else
-            FastLED.show(stripBrightness);
+            showStrip(stripBrightness);
 
         incr(curPos, 1, movLimit);
         if (curPos == 0) {
@@ -109,7 +92,7 @@ void FxA1::run() {
             //save the color
             lastColorIndex = colorIndex;
             colorIndex = random8();
-            makeDot(ColorFromPalette(palette, colorIndex, random8(dimmed + 60, brightness), LINEARBLEND),
+            makeDot(paletteCache.color(colorIndex, random8(dimmed + 60, brightness)),
                     szSegment);
             speed = random16(40, 81);
             a1Timer.setPeriod(speed);
@@ -122,12 +105,8 @@ void FxA1::baseConfig(JsonObject &json) const {
     json["segmentSize"] = szSegment;
 }
 
-uint8_t FxA1::selectionWeight() const {
-    return 3;
-}
-
 // FX A2
-FxA2::FxA2() : LedEffect(fxa2Desc), dot(frame(0, FRAME_SIZE-1)) {
+FxA2::FxA2() : dot(frame(0, FRAME_SIZE-1)) {
 }
 
 void FxA2::setup() {
@@ -138,11 +117,11 @@ void FxA2::setup() {
 void FxA2::makeDot() const {
     const uint8_t brdIndex = beatsin8(11);
     const uint8_t brdBright = brdIndex % 2 ? BRIGHTNESS : dimmed;
-    dot[szSegment - 1] = ColorFromPalette(palette, brdIndex, brdBright, LINEARBLEND);
+    dot[szSegment - 1] = paletteCache.color(brdIndex, brdBright);
     for (uint16_t x = 1; x < (szSegment - 1); x++) {
-        dot[x] = ColorFromPalette(palette, colorIndex + random8(32), brightness, LINEARBLEND);
+        dot[x] = paletteCache.color(colorIndex + random8(32), brightness);
     }
-    dot[0] = ColorFromPalette(palette, brdIndex, brdBright, LINEARBLEND);
+    dot[0] = paletteCache.color(brdIndex, brdBright);
 }
 
 void FxA2::run() {
@@ -151,7 +130,7 @@ void FxA2::run() {
             resetStack();
         return;
     }
-    EVERY_N_MILLISECONDS_I(a2Timer, speed) {
+    FRAME_EVERY_N_MILLIS_I(a2Timer, speed) {
         static CRGB feed = BKG;
         switch (movement) {
             case forward:
@@ -169,9 +148,9 @@ void FxA2::run() {
         }
         replicateSet(tpl, others);
         if (paletteFactory.getHoliday() == Halloween)
-            FastLED.show(random8(32, stripBrightness)); //add a flicker
+            showStrip(random8(32, stripBrightness)); //add a flicker
         else
-            FastLED.show(stripBrightness);
+            showStrip(stripBrightness);
         incr(curPos, 1, tpl.size());
         if (const uint8_t ss = curPos % (szSegment + spacing); ss == 0) {
             //change segment, space sizes
@@ -181,7 +160,7 @@ void FxA2::run() {
             makeDot();
         } else if (ss < szSegment)
             feed = movement == backward ? dot[ss] :
-                    ColorFromPalette(palette, colorIndex, beatsin8(6, dimmed << 2, brightness, curPos), LINEARBLEND);
+                    paletteCache.color(colorIndex, beatsin8(6, dimmed << 2, brightness, curPos));
         else
             feed = BKG;
 
@@ -205,17 +184,13 @@ void FxA2::baseConfig(JsonObject &json) const {
     json["segmentSize"] = szSegment;
 }
 
-uint8_t FxA2::selectionWeight() const {
-    return 10;
-}
-
 // Fx A3
-FxA3::FxA3() : LedEffect(fxa3Desc), dot(frame(0, FRAME_SIZE-1)) {
+FxA3::FxA3() : dot(frame(0, FRAME_SIZE-1)) {
 }
 
 void FxA3::setup() {
     LedEffect::setup();
-    makeDot(ColorFromPalette(palette, colorIndex, brightness, LINEARBLEND), szSegment);
+    makeDot(paletteCache.color(colorIndex, brightness), szSegment);
     bFwd = true;
     transEffect.prepare(random8());
 }
@@ -230,16 +205,16 @@ void FxA3::makeDot(const CRGB color, const uint16_t szDot) const {
 }
 
 void FxA3::run() {
-    EVERY_N_MILLISECONDS_I(a3Timer, speed) {
+    FRAME_EVERY_N_MILLIS_I(a3Timer, speed) {
         if (bFwd)
             shiftRight(tpl, curPos < szSegment ? dot[curPos] : BKG);
         else
             shiftLeft(tpl, curPos < szSegment ? dot[curPos] : BKG);
         replicateSet(tpl, others);
         if (paletteFactory.isHolidayLimitedHue())
-            FastLED.show(random8(32, stripBrightness)); //add a flicker
+            showStrip(random8(32, stripBrightness)); //add a flicker
         else
-            FastLED.show(stripBrightness);
+            showStrip(stripBrightness);
 
         incr(curPos, 1, tpl.size());
         if (curPos == 0) {
@@ -249,7 +224,7 @@ void FxA3::run() {
             speed = random8(40, 171);
             a3Timer.setPeriod(speed);
             szSegment = random8(2, 8);
-            makeDot(ColorFromPalette(palette, colorIndex, random8(dimmed << 2, brightness), LINEARBLEND),
+            makeDot(paletteCache.color(colorIndex, random8(dimmed << 2, brightness)),
                     szSegment);
         }
     }
@@ -259,12 +234,8 @@ void FxA3::baseConfig(JsonObject &json) const {
     LedEffect::baseConfig(json);
 }
 
-uint8_t FxA3::selectionWeight() const {
-    return 20;
-}
-
 // FX A4
-FxA4::FxA4() : LedEffect(fxa4Desc), dot(frame(0, FRAME_SIZE-1)), frL(frame(FRAME_SIZE, FRAME_SIZE*2-1)),
+FxA4::FxA4() : dot(frame(0, FRAME_SIZE-1)), frL(frame(FRAME_SIZE, FRAME_SIZE*2-1)),
                frR(frame(FRAME_SIZE*2, FRAME_SIZE*3-1)), curBkg(BKG) {
 }
 
@@ -274,12 +245,12 @@ void FxA4::setup() {
     szStackSeg = 2;
     curBkg = BKG;
     brightness = 192;
-    makeDot(ColorFromPalette(palette, colorIndex, brightness, LINEARBLEND), szSegment);
+    makeDot(paletteCache.color(colorIndex, brightness), szSegment);
 }
 
 void FxA4::makeDot(const CRGB color, const uint16_t szDot) {
     const CRGB c1 = color;
-    const CRGB c2 = ColorFromPalette(targetPalette, colorIndex, brightness, LINEARBLEND);
+    const CRGB c2 = targetPaletteCache.color(colorIndex, brightness);
     dot(0, szDot).fill_gradient_RGB(c1, c2);
 }
 
@@ -290,21 +261,21 @@ void FxA4::run() {
         return;
     }
 
-    EVERY_N_MILLISECONDS_I(a4Timer, speed) {
-        curBkg = ColorFromPalette(palette, beatsin8(11), 3, LINEARBLEND);
+    FRAME_EVERY_N_MILLIS_I(a4Timer, speed) {
+        curBkg = paletteCache.color(beatsin8(11), 3);
         const uint8_t ss = curPos % (szSegment + spacing);
         shiftRight(frR, ss < szSegment ? dot[ss] : curBkg);
         shiftLeft(frL,
-                  curPos < szStackSeg ? ColorFromPalette(targetPalette, colorIndex, brightness, LINEARBLEND) : BKG);
+                  curPos < szStackSeg ? targetPaletteCache.color(colorIndex, brightness) : BKG);
         for (uint16_t x = 0; x < tpl.size(); x++) {
             tpl[x] = frR[x];
             tpl[x] += (frR[x] > curBkg) && frL[x] ? CRGB::White : frL[x];
         }
         replicateSet(tpl, others);
         if (paletteFactory.getHoliday() == Halloween)
-            FastLED.show(random8(32, stripBrightness)); //add a flicker
+            showStrip(random8(32, stripBrightness)); //add a flicker
         else
-            FastLED.show(stripBrightness);
+            showStrip(stripBrightness);
 
         incr(curPos, 1, FRAME_SIZE);
         if (curPos == 0) {
@@ -313,7 +284,7 @@ void FxA4::run() {
             spacing = beatsin8(15, szStackSeg + 4, 22);
             speed = random16(40, 171);
             a4Timer.setPeriod(speed);
-            makeDot(ColorFromPalette(palette, colorIndex, brightness, LINEARBLEND), szSegment);
+            makeDot(paletteCache.color(colorIndex, brightness), szSegment);
         }
     }
 
@@ -329,12 +300,8 @@ void FxA4::baseConfig(JsonObject &json) const {
     LedEffect::baseConfig(json);
 }
 
-uint8_t FxA4::selectionWeight() const {
-    return 20;
-}
-
 // Fx A5
-FxA5::FxA5() : LedEffect(fxa5Desc), ovr(frame(0, FRAME_SIZE-1)) {
+FxA5::FxA5() : ovr(frame(0, FRAME_SIZE-1)) {
 }
 
 void FxA5::setup() {
@@ -348,9 +315,9 @@ void FxA5::makeFrame() {
     const uint8_t halfBright = brightness >> 1;
     const uint8_t rndBright = random8(halfBright);
     const bool mainPal = ovr[0].getParity();
-    const CRGBPalette16 &pal = mainPal ? palette : targetPalette;
-    ovr.fill_solid(ColorFromPalette(pal, lastColorIndex, halfBright + rndBright, LINEARBLEND));
-    const CRGB newClr = ColorFromPalette(pal, colorIndex, halfBright + rndBright, LINEARBLEND);
+    const PaletteCache &pc = mainPal ? paletteCache : targetPaletteCache;
+    ovr.fill_solid(pc.color(lastColorIndex, halfBright + rndBright));
+    const CRGB newClr = pc.color(colorIndex, halfBright + rndBright);
     const uint16_t seg = 5;
     for (uint16_t x = 0; x < seg; x++) {
         nblend(ovr[x], newClr, (seg-x-1)*50);
@@ -365,10 +332,10 @@ void FxA5::run() {
         return;
     }
 
-    EVERY_N_MILLISECONDS_I(a5Timer, speed) {
+    FRAME_EVERY_N_MILLIS_I(a5Timer, speed) {
         shiftRight(tpl, ovr[capu(curPos, ovr.size()-1)]);
         replicateSet(tpl, others);
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
 
         incr(curPos, 1, tpl.size()+4);
         if (curPos == 0) {
@@ -380,8 +347,10 @@ void FxA5::run() {
         } else if (curPos == 1) {
             speed = random16(40, 131);
             a5Timer.setPeriod(speed);
-        } else
-            tpl(tpl.size()-1, capu(curPos+1, tpl.size()-1)).fadeToBlackBy(12);
+        } else {
+            CRGBSet trail = tpl(tpl.size()-1, capu(curPos+1, tpl.size()-1));
+            fadeSet(trail, 12);
+        }
     }
 
     EVERY_N_SECONDS(127) {
@@ -396,13 +365,9 @@ void FxA5::baseConfig(JsonObject &json) const {
     LedEffect::baseConfig(json);
 }
 
-uint8_t FxA5::selectionWeight() const {
-    return 20;
-}
-
 // SleepLight
-SleepLight::SleepLight() : LedEffect(fxa6Desc), state(Fade), refPixel(&ledSet[0]) {
-    for (int x = 5; x < ledSet.size(); x += 10) {
+SleepLight::SleepLight() : state(Fade), refPixel(&ledSet[0]) {
+    for (int x = 5; x < topology.logicalSize(); x += 10) {
         slOffSegs.push_front(ledSet(x, x+4));
     }
 }
@@ -415,8 +380,8 @@ uint8_t excludeActiveColors(const uint8_t hue) {
 
 void SleepLight::setup() {
     LedEffect::setup();
-    FastLED.setTemperature(ColorTemperature::Tungsten40W);
-    fill_solid(leds, NUM_PIXELS, colorBuf);
+    outputLut.setTemperature(ColorTemperature::Tungsten40W);
+    fill_solid(leds, topology.logicalSize(), colorBuf);
     timer=0;
     state = FadeColorTransition;
     hue = colorBuf.hue = excludeActiveColors(0);
@@ -453,9 +418,9 @@ void SleepLight::run() {
 //            log_info(F("SleepLight parameters: state=%d, colorBuf=%r HSV=(%d,%d,%d), refPixel=%r"), state, (CRGB)colorBuf, colorBuf.hue, colorBuf.sat, colorBuf.val, *refPixel);
         }
     }
-    EVERY_N_MILLIS(125) {
+    FRAME_EVERY_N_MILLIS(125) {
         if (const SleepLightState oldState = step(); !(oldState == state && state == Sleep))
-            FastLED.show(); //overall brightness is managed through color's value of HSV structure, which stabilizes at minBrightness, hence no need to scale with stripBrightness here
+            showStrip(FastLED.getBrightness()); //overall brightness is managed through color's value of HSV structure, which stabilizes at minBrightness, hence no need to scale with stripBrightness here
     }
 
 }
@@ -472,7 +437,7 @@ SleepLight::SleepLightState SleepLight::step() {
             timer = ++timer%12;
             if (timer == 0) {
                 for (auto &seg : slOffSegs)
-                    seg.fadeToBlackBy(1);
+                    fadeSet(seg, 1);
                 if (slOffSegs.front()[0] == CRGB::Black)
                     state = Sleep;
             }
@@ -485,10 +450,6 @@ SleepLight::SleepLightState SleepLight::step() {
     return oldState;
 }
 
-uint8_t SleepLight::selectionWeight() const {
-    return 0;   //we don't want this effect part of the random selection of entertaining light effects
-}
-
 void SleepLight::windDownPrep() {
     transEffect.prepare(SELECTOR_FADE);
 }
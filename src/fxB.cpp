@@ -8,33 +8,10 @@
 using namespace FxB;
 using namespace colTheme;
 
-//~ Effect description strings stored in flash
-constexpr auto fxb1Desc PROGMEM = "FXB1: rainbow";
-constexpr auto fxb2Desc PROGMEM = "FXB2: rainbow with glitter";
-constexpr auto fxb3Desc PROGMEM = "FXB3: confetti B";
-constexpr auto fxb4Desc PROGMEM = "FXB4: sinelon";
-constexpr auto fxb5Desc PROGMEM = "FXB5: juggle short segments";
-constexpr auto fxb6Desc PROGMEM = "FXB6: bpm";
-constexpr auto fxb7Desc PROGMEM = "FXB7: ease";
-constexpr auto fxb8Desc PROGMEM = "FXB8: fadein";
-constexpr auto fxb9Desc PROGMEM = "FXB9: juggle long segments";
-
 uint16_t FxB::szStack = 0;
 
-void FxB::fxRegister() {
-    new FxB1();
-    new FxB2();
-    new FxB3();
-    new FxB4();
-    new FxB5();
-    new FxB6();
-    new FxB7();
-    new FxB8();
-    new FxB9();
-}
-
 //FXB1
-FxB1::FxB1() : LedEffect(fxb1Desc) {}
+FxB1::FxB1() = default;
 
 void FxB1::setup() {
     LedEffect::setup();
@@ -44,9 +21,9 @@ void FxB1::setup() {
 }
 
 void FxB1::run() {
-    EVERY_N_MILLISECONDS(60) {
+    FRAME_EVERY_N_MILLIS(60) {
         rainbow();
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
         hue += 2;
     }
 }
@@ -58,7 +35,7 @@ void FxB::rainbow() {
                               ColorFromPalette(palette, 255 - hue, brightness));
     else {
         tpl.fill_rainbow(hue, 7);
-        tpl.nscale8(brightness);
+        scaleSet(tpl, brightness);
     }
     replicateSet(tpl, others);
 }
@@ -68,12 +45,8 @@ void FxB1::baseConfig(JsonObject &json) const {
     json["brightness"] = brightness;
 }
 
-uint8_t FxB1::selectionWeight() const {
-    return 15;
-}
-
 //FXB2
-FxB2::FxB2() : LedEffect(fxb2Desc) {}
+FxB2::FxB2() = default;
 
 void FxB2::setup() {
     LedEffect::setup();
@@ -83,9 +56,9 @@ void FxB2::setup() {
 }
 
 void FxB2::run() {
-    EVERY_N_MILLISECONDS(60) {
+    FRAME_EVERY_N_MILLIS(60) {
         rainbowWithGlitter();
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
         hue += 2;
     }
 }
@@ -100,16 +73,12 @@ void FxB::rainbowWithGlitter() {
 
 void FxB::addGlitter(const fract8 chanceOfGlitter) {
     if (random8() < chanceOfGlitter) {
-        leds[random16(NUM_PIXELS)] += CRGB::White;
+        leds[random16(topology.logicalSize())] += CRGB::White;
     }
 }
 
-uint8_t FxB2::selectionWeight() const {
-    return 40;
-}
-
 //FXB3
-FxB3::FxB3() : LedEffect(fxb3Desc) {}
+FxB3::FxB3() = default;
 
 void FxB3::setup() {
     LedEffect::setup();
@@ -126,7 +95,7 @@ void FxB3::run() {
             return;
     }
 
-    EVERY_N_MILLISECONDS(50) {
+    FRAME_EVERY_N_MILLIS(50) {
         fxb_confetti();
     }
     EVERY_N_SECONDS(133) {
@@ -137,14 +106,14 @@ void FxB3::run() {
 
 void FxB::fxb_confetti() {
     // Random colored speckles that blink in and fade smoothly.
-    tpl.fadeToBlackBy(10);
+    fadeSet(tpl, 10);
     const uint16_t pos = random16(tpl.size());
     if (paletteFactory.isHolidayLimitedHue())
         tpl[pos] += ColorFromPalette(palette, hue + random8(64));
     else
         tpl[pos] += CHSV(hue + random8(64), 200, 255);
     replicateSet(tpl, others);
-    FastLED.show(stripBrightness);
+    showStrip(stripBrightness);
     hue += 2;
 }
 
@@ -153,12 +122,8 @@ void FxB3::baseConfig(JsonObject &json) const {
     json["brightness"] = brightness;
 }
 
-uint8_t FxB3::selectionWeight() const {
-    return 24;
-}
-
 //FXB4
-FxB4::FxB4() : LedEffect(fxb4Desc) {}
+FxB4::FxB4() = default;
 
 void FxB4::setup() {
     LedEffect::setup();
@@ -168,16 +133,16 @@ void FxB4::setup() {
 }
 
 void FxB4::run() {
-    EVERY_N_MILLISECONDS(60) {
+    FRAME_EVERY_N_MILLIS(60) {
         sinelon();
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
         hue += 3;
     }
 }
 
 void FxB::sinelon() {
     // A colored dot sweeping back and forth, with fading trails.
-    tpl.fadeToBlackBy(20);
+    fadeSet(tpl, 20);
     const uint16_t pos = beatsin16(14, 0, tpl.size() - 1);
     if (paletteFactory.isHolidayLimitedHue())
         tpl[pos] += ColorFromPalette(palette, hue, brightness);
@@ -191,12 +156,8 @@ void FxB4::baseConfig(JsonObject &json) const {
     json["brightness"] = brightness;
 }
 
-uint8_t FxB4::selectionWeight() const {
-    return 20;
-}
-
 //FXB5
-FxB5::FxB5() : LedEffect(fxb5Desc) {}
+FxB5::FxB5() = default;
 
 void FxB5::setup() {
     LedEffect::setup();
@@ -209,7 +170,7 @@ void FxB5::run() {
         nblendPaletteTowardPalette(palette, targetPalette, maxChanges);
     }
 
-    EVERY_N_MILLIS(50) {
+    FRAME_EVERY_N_MILLIS(50) {
         juggle_short();
     }
 }
@@ -220,7 +181,7 @@ void FxB5::run() {
  */
 void FxB::juggle_short() {
     constexpr uint16_t segSize = 8;
-    tpl.fadeToBlackBy(20);
+    fadeSet(tpl, 20);
 
     for (uint16_t i = 0; i < segSize; i++) {
         // leds[beatsin16(i + 7, 0, NUM_PIXELS - 1)] |= CHSV(dothue, 200, 255);
@@ -231,7 +192,7 @@ void FxB::juggle_short() {
         hue += 32;
     }
     replicateSet(tpl, others);
-    FastLED.show(stripBrightness);
+    showStrip(stripBrightness);
 }
 
 void FxB5::baseConfig(JsonObject &json) const {
@@ -239,12 +200,8 @@ void FxB5::baseConfig(JsonObject &json) const {
     json["brightness"] = brightness;
 }
 
-uint8_t FxB5::selectionWeight() const {
-    return 30;
-}
-
 //FXB6
-FxB6::FxB6() : LedEffect(fxb6Desc) {}
+FxB6::FxB6() = default;
 
 void FxB6::setup() {
     LedEffect::setup();
@@ -254,7 +211,7 @@ void FxB6::setup() {
 }
 
 void FxB6::run() {
-    EVERY_N_MILLISECONDS(50) {
+    FRAME_EVERY_N_MILLIS(50) {
         bpm();
     }
 }
@@ -269,15 +226,11 @@ void FxB::bpm() {
     }
     replicateSet(tpl, others);
     hue += 8;  // slowly cycle the "base color" through the rainbow
-    FastLED.show(stripBrightness);
-}
-
-uint8_t FxB6::selectionWeight() const {
-    return 20;
+    showStrip(stripBrightness);
 }
 
 //FXB7
-FxB7::FxB7() : LedEffect(fxb7Desc) {}
+FxB7::FxB7() = default;
 
 void FxB7::setup() {
     LedEffect::setup();
@@ -287,7 +240,7 @@ void FxB7::setup() {
 }
 
 void FxB7::run() {
-    EVERY_N_MILLISECONDS(75) {
+    FRAME_EVERY_N_MILLIS(75) {
         ease();
     }
 }
@@ -304,14 +257,14 @@ void FxB::ease() {
         if (lerpVal > curPos)
             tpl(curPos, lerpVal) = ColorFromPalette(palette, hue + easeInVal / 4, max(40, (uint8_t) easeOutVal));
         else
-            tpl.fadeToBlackBy(49);
+            fadeSet(tpl, 49);
         curPos = lerpVal;
     }
     szStack = lerpVal;
     hue += 2;
-    tpl.fadeToBlackBy(24);                          // 8 bit, 1 = slow fade, 255 = fast fade
+    fadeSet(tpl, 24);                               // 8 bit, 1 = slow fade, 255 = fast fade
     replicateSet(tpl, others);
-    FastLED.show(stripBrightness);
+    showStrip(stripBrightness);
 
 }
 
@@ -320,12 +273,8 @@ void FxB7::baseConfig(JsonObject &json) const {
     json["brightness"] = brightness;
 }
 
-uint8_t FxB7::selectionWeight() const {
-    return 10;
-}
-
 //FXB8
-FxB8::FxB8() : LedEffect(fxb8Desc) {}
+FxB8::FxB8() = default;
 
 void FxB8::setup() {
     LedEffect::setup();
@@ -339,7 +288,7 @@ void FxB8::run() {
         nblendPaletteTowardPalette(palette, targetPalette, maxChanges);
     }
 
-    EVERY_N_MILLISECONDS(60) {
+    FRAME_EVERY_N_MILLIS(60) {
         fadein();
     }
 
@@ -359,7 +308,7 @@ void FxB::fadein() {
         tpl[i] = ColorFromPalette(palette, i * 20, fader, LINEARBLEND);       // Now, let's run it through the palette lookup.
     }
     replicateSet(tpl, others);
-    FastLED.show(stripBrightness);
+    showStrip(stripBrightness);
 
     random16_set_seed(hueDiff);                                                      // Re-randomizing the random number seed for other routines.
 }
@@ -369,10 +318,6 @@ void FxB8::baseConfig(JsonObject &json) const {
     json["brightness"] = brightness;
 }
 
-uint8_t FxB8::selectionWeight() const {
-    return 15;
-}
-
 // FxB9
 void FxB9::setup() {
     LedEffect::setup();
@@ -413,9 +358,9 @@ void FxB::juggle_long() {
         }
         secSlot = inc(secSlot, 1, 3);   //change the modulo value for changing the duration of the loop
     }
-    EVERY_N_MILLIS(60) {
+    FRAME_EVERY_N_MILLIS(60) {
         uint8_t curHue = hue;                                           // Reset the hue values.
-        tpl.fadeToBlackBy(fade);
+        fadeSet(tpl, fade);
 
         for (uint16_t i = 0; i < numDots; i++) {
             //  note the += operator may lead to colors outside the palette (less evident than |= operator) - for limited hues palettes (like Halloween) this may not be ideal
@@ -425,12 +370,9 @@ void FxB::juggle_long() {
         }
         hue += numDots * 2;
         replicateSet(tpl, others);
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
 }
 
-FxB9::FxB9() : LedEffect(fxb9Desc) {}
+FxB9::FxB9() = default;
 
-uint8_t FxB9::selectionWeight() const {
-    return 14;
-}
@@ -8,23 +8,6 @@
 using namespace FxC;
 using namespace colTheme;
 
-//~ Effect description strings stored in flash
-constexpr auto fxc1Desc PROGMEM = "FXC1: blend between two concurrent animations";
-constexpr auto fxc2Desc PROGMEM = "FXC2: blur function";
-constexpr auto fxc3Desc PROGMEM = "FXC3: Perlin Noise for moving up and down the strand";
-constexpr auto fxc4Desc PROGMEM = "FxC4: lightnings";
-constexpr auto fxc5Desc PROGMEM = "FXC5: matrix";
-constexpr auto fxc6Desc PROGMEM = "FXC6: one sine";
-
-void FxC::fxRegister() {
-    new FxC1();
-    new FxC2();
-    new FxC3();
-    new FxC4();
-    new FxC5();
-    new FxC6();
-}
-
 /**
  * aanimations
  * By: Can't recall where I found this. Maybe Stefan Petrick.
@@ -33,7 +16,7 @@ void FxC::fxRegister() {
  * Date: January, 2017
  * This sketch demonstrates how to blend between two animations running at the same time.
  */
-FxC1::FxC1() : LedEffect(fxc1Desc), setA(frame(0, FRAME_SIZE-1)), setB(leds, FRAME_SIZE) {
+FxC1::FxC1() : setA(frame(0, FRAME_SIZE-1)), setB(leds, FRAME_SIZE) {
 }
 
 void FxC1::setup() {
@@ -44,7 +27,7 @@ void FxC1::setup() {
 void FxC1::run() {
     animationA();
     animationB();
-    CRGBSet others(leds, setB.size(), NUM_PIXELS);
+    CRGBSet others(leds, setB.size(), topology.logicalSize()-1);
 
     //combine all into setB (it is backed by the strip)
     const uint8_t ratio = beatsin8(2);
@@ -53,7 +36,7 @@ void FxC1::run() {
     }
     replicateSet(setB, others);
 
-    FastLED.show(stripBrightness);
+    showStrip(stripBrightness);
 }
 
 void FxC1::animationA() {
@@ -76,9 +59,6 @@ bool FxC1::windDown() {
     return transEffect.offWipe(true);
 }
 
-uint8_t FxC1::selectionWeight() const {
-    return 35;
-}
 //Fx C2
 /**
  * blur
@@ -91,7 +71,7 @@ uint8_t FxC1::selectionWeight() const {
  *
  */
 
-FxC2::FxC2() : LedEffect(fxc2Desc) {}
+FxC2::FxC2() = default;
 
 //void FxC2::setup() {
 //    LedEffect::setup();
@@ -113,17 +93,13 @@ void FxC2::run() {
     leds[(k+i+j)/3] = paletteFactory.isHolidayLimitedHue() ? ColorFromPalette(palette, ms/53) : CHSV( ms / 53, 200, 255);
 
     replicateSet(tpl, others);
-    FastLED.show(stripBrightness);
+    showStrip(stripBrightness);
 }
 
 void FxC2::windDownPrep() {
     transEffect.prepare(SELECTOR_SPOTS);
 }
 
-uint8_t FxC2::selectionWeight() const {
-    return 5;
-}
-
 //Fx C3
 /**
  * inoise8_mover
@@ -136,7 +112,7 @@ uint8_t FxC2::selectionWeight() const {
 constexpr uint32_t xscale = 8192;                                         // Wouldn't recommend changing this on the fly, or the animation will be really blocky.
 constexpr uint32_t yscale = 7680;                                         // Wouldn't recommend changing this on the fly, or the animation will be really blocky.
 
-FxC3::FxC3() : LedEffect(fxc3Desc) {}
+FxC3::FxC3() = default;
 
 void FxC3::setup() {
     LedEffect::setup();
@@ -147,16 +123,16 @@ void FxC3::setup() {
 }
 
 void FxC3::run() {
-    EVERY_N_MILLISECONDS(35) {
+    FRAME_EVERY_N_MILLIS(35) {
         const uint16_t locn = inoise16(xscale, dist+yscale) % 0xFFFF;           // Get a new pixel location from moving noise.
         const uint16_t pixlen = map(locn, 0, 0xFFFF, 0, tpl.size());                     // Map that to the length of the strand.
         leds[pixlen] = ColorFromPalette(palette, pixlen, brightness, LINEARBLEND);   // Use that value for both the location as well as the palette index colour for the pixel.
 
         dist += beatsin16(10,128,8192);             // Moving along the distance (that random number we started out with). Vary it a bit with a sine wave.
-        tpl.fadeToBlackBy(4);
+        fadeSet(tpl, 4);
 
         replicateSet(tpl, others);
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
     EVERY_N_SECONDS(5) {
         nblendPaletteTowardPalette(palette, targetPalette, maxChanges);
@@ -179,12 +155,8 @@ bool FxC3::windDown() {
     return transEffect.offSpots();
 }
 
-uint8_t FxC3::selectionWeight() const {
-    return 4;
-}
-
 // Fx C4
-FxC4::FxC4() : LedEffect(fxc4Desc) {}
+FxC4::FxC4() = default;
 
 void FxC4::setup() {
     LedEffect::setup();
@@ -195,8 +167,8 @@ void FxC4::setup() {
 
 void FxC4::run() {
     EVERY_N_SECONDS_I(fxc4Timer, 1+random8(frequency)) {
-        const uint16_t start = random16(NUM_PIXELS - 8);                               // Determine starting location of flash
-        const uint16_t len = random16(4, NUM_PIXELS - start);                     // Determine length of flash (not to go beyond NUM_LEDS-1)
+        const uint16_t start = random16(topology.logicalSize() - 8);                               // Determine starting location of flash
+        const uint16_t len = random16(4, topology.logicalSize() - start);                     // Determine length of flash (not to go beyond NUM_LEDS-1)
         const uint8_t flashRound = random8(3, flashes);
         CRGBSet flash(leds, start, start+len);
 
@@ -205,10 +177,10 @@ void FxC4::run() {
             const uint8_t dimmer = flashCounter == 0 ? 5 : random8(1, 3);
             const CRGB color = ColorFromPalette(palette, random8(), brightness / dimmer, LINEARBLEND);
             flash = color;
-            FastLED.show(stripBrightness);                       // Show a section of LED's
+            showStrip(stripBrightness);                       // Show a section of LED's
             taskDelay(random8(4, 10));                                     // each flash only lasts 4-10 milliseconds
             flash = BKG;
-            FastLED.show(stripBrightness);
+            showStrip(stripBrightness);
 
             if (flashCounter == 0) taskDelay(250);                       // longer speed until next flash after the leader
 
@@ -222,12 +194,8 @@ bool FxC4::windDown() {
     return true;
 }
 
-uint8_t FxC4::selectionWeight() const {
-    return paletteFactory.getHoliday() == Halloween ? 20 : 2;
-}
-
 // Fx C5
-FxC5::FxC5() : LedEffect(fxc5Desc) {}
+FxC5::FxC5() = default;
 
 void FxC5::setup() {
     LedEffect::setup();
@@ -245,10 +213,10 @@ void FxC5::run() {
         nblendPaletteTowardPalette(palette, targetPalette, maxChanges);
     }
 
-    EVERY_N_MILLISECONDS_I(c5Timer, speed) {
+    FRAME_EVERY_N_MILLIS_I(c5Timer, speed) {
         matrix();
         c5Timer.setPeriod(speed);
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
 
 }
@@ -290,12 +258,8 @@ bool FxC5::windDown() {
     return transEffect.offWipe(false);
 }
 
-uint8_t FxC5::selectionWeight() const {
-    return 20;
-}
-
 // Fx C6
-FxC6::FxC6() : LedEffect(fxc6Desc) {}
+FxC6::FxC6() = default;
 
 void FxC6::setup() {
     LedEffect::setup();
@@ -307,9 +271,9 @@ void FxC6::setup() {
 void FxC6::run() {
     static uint8_t secSlot = 0;
 
-    EVERY_N_MILLISECONDS_I(c6Timer, delay) {
+    FRAME_EVERY_N_MILLIS_I(c6Timer, delay) {
         one_sine_pal(millis()>>4);
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
         c6Timer.setPeriod(delay);
     }
 
@@ -346,6 +310,3 @@ bool FxC6::windDown() {
     return transEffect.offWipe(true);
 }
 
-uint8_t FxC6::selectionWeight() const {
-    return 20;
-}
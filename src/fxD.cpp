@@ -7,23 +7,8 @@
 using namespace FxD;
 using namespace colTheme;
 
-//~ Effect description strings stored in flash
-constexpr auto fxd1Desc PROGMEM = "FXD1: Confetti D";
-constexpr auto fxd2Desc PROGMEM = "FXD2: dot beat";
-constexpr auto fxd3Desc PROGMEM = "FXD3: plasma";
-constexpr auto fxd4Desc PROGMEM = "FXD4: rainbow marching";
-constexpr auto fxd5Desc PROGMEM = "FXD5: ripples";
-
 int8_t FxD::rot = 1;
 
-void FxD::fxRegister() {
-    new FxD1();
-    new FxD2();
-    new FxD3();
-    new FxD4();
-    new FxD5();
-}
-
 /**
  * Confetti
  * By: Mark Kriegsman
@@ -32,7 +17,7 @@ void FxD::fxRegister() {
  *
  * Confetti flashes colours within a limited hue. It's been modified from Mark's original to support a few variables. It's a simple, but great looking routine.
  */
-FxD1::FxD1() : LedEffect(fxd1Desc) {}
+FxD1::FxD1() = default;
 
 void FxD1::setup() {
     LedEffect::setup();
@@ -49,9 +34,9 @@ void FxD1::setup() {
 void FxD1::run() {
     ChangeMe();                                                 // Check the demo loop for changes to the variables.
 
-    EVERY_N_MILLISECONDS(speed) {                           // FastLED based non-blocking speed to update/display the sequence.
+    FRAME_EVERY_N_MILLIS(speed) {                           // FastLED based non-blocking speed to update/display the sequence.
         confetti();
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
 }
 
@@ -63,7 +48,7 @@ void FxD1::baseConfig(JsonObject &json) const {
 
 void FxD1::confetti() {
     // random colored speckles that blink in and fade smoothly
-    tpl.fadeToBlackBy(fade);                    // Low values = slower fade.
+    fadeSet(tpl, fade);                         // Low values = slower fade.
     const uint16_t pos = random16(tpl.size());    // Pick an LED at random.
     //tpl[pos] += CHSV((hue + random16(hueDiff)) / 4 , saturation, localBright);  // I use 12 bits for hue so that the hue increment isn't too quick.
     tpl[pos] += ColorFromPalette(palette, hue, brightness, LINEARBLEND);
@@ -89,10 +74,6 @@ bool FxD1::windDown() {
     return transEffect.offSpots();
 }
 
-uint8_t FxD1::selectionWeight() const {
-    return 21;
-}
-
 // Fx D2
 /**
  * dots By: John Burroughs
@@ -101,7 +82,7 @@ uint8_t FxD1::selectionWeight() const {
  *
  * Similar to dots by John Burroughs, but uses the FastLED beatsin8() function instead.
  */
-FxD2::FxD2() : LedEffect(fxd2Desc) {}
+FxD2::FxD2() = default;
 
 void FxD2::setup() {
     LedEffect::setup();
@@ -110,9 +91,9 @@ void FxD2::setup() {
 }
 
 void FxD2::run() {
-    EVERY_N_MILLISECONDS(75) {
+    FRAME_EVERY_N_MILLIS(75) {
         dot_beat();
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
 }
 
@@ -131,7 +112,7 @@ void FxD2::dot_beat() {
     tpl[inner] = ColorFromPalette(palette, beatsin8(11, 0, 255, 0, 127));
     tpl[outer] = ColorFromPalette(palette, beatsin8(12, 0, 255, 0, 255));
 
-    tpl.nscale8(255-fade);                             // Fade the entire array. Or for just a few LED's, use  nscale8(&leds[2], 5, fadeVal);
+    scaleSet(tpl, 255-fade);                           // Fade the entire array. Or for just a few LED's, use  nscale8(&leds[2], 5, fadeVal);
 
     replicateSet(tpl, others);
 }
@@ -140,10 +121,6 @@ bool FxD2::windDown() {
     return transEffect.offWipe(true);
 }
 
-uint8_t FxD2::selectionWeight() const {
-    return 20;
-}
-
 // Fx D3
 void FxD3::setup() {
     LedEffect::setup();
@@ -153,9 +130,9 @@ void FxD3::setup() {
 }
 
 void FxD3::run() {
-    EVERY_N_MILLISECONDS(50) {                                  // FastLED based non-blocking delay to update/display the sequence.
+    FRAME_EVERY_N_MILLIS(50) {                                  // FastLED based non-blocking delay to update/display the sequence.
         plasma();
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
 
     EVERY_N_SECONDS(5) {
@@ -178,16 +155,27 @@ void FxD3::plasma() const {
     const uint8_t thisPhase = beatsin8(6,-64,64);                           // Setting phase change for a couple of waves.
     const uint8_t thatPhase = beatsin8(7,-64,64);
 
-    for (int k=0; k<NUM_PIXELS; k++) {                              // For each of the LED's in the strand, set a localBright based on a wave as follows:
-        uint8_t colorIndex = cubicwave8((k*23)+thisPhase)/2 + cos8((k*15)+thatPhase)/2;           // Create a wave and add a phase change and add another wave with its own phase change. Hey, you can even change the frequencies if you wish.
-        const uint8_t thisBright = qsuba(colorIndex, beatsin8(7,0,96));              // qsub gives it a bit of 'black' dead space by setting sets a minimum value. If colorIndex < current value of beatsin8(), then bright = 0. Otherwise, bright = colorIndex..
-        //plasma becomes slime during Halloween (single color morphing mass)
-        const uint8_t clr = paletteFactory.isHolidayLimitedHue() ? monoColor : colorIndex;
-        leds[k] = ColorFromPalette(palette, clr, thisBright, LINEARBLEND);  // Let's now add the foreground colour.
+    //on a matrix, the two waves run along the rows and the columns - the cells are addressed through the topology
+    const uint16_t width = topology.matrixWidth();
+    const uint16_t height = topology.matrixHeight();
+    if (width > 0 && height > 0) {
+        for (uint16_t y = 0; y < height; y++)
+            for (uint16_t x = 0; x < width; x++)
+                plasmaPixel(topology.xy(x, y), cubicwave8((x*23)+thisPhase)/2 + cos8((y*15)+thatPhase)/2);
+        return;
     }
+    for (uint16_t k=0; k<topology.logicalSize(); k++)                             // For each of the LED's in the strand, set a localBright based on a wave as follows:
+        plasmaPixel(k, cubicwave8((k*23)+thisPhase)/2 + cos8((k*15)+thatPhase)/2);   // Create a wave and add a phase change and add another wave with its own phase change. Hey, you can even change the frequencies if you wish.
+}
+
+void FxD3::plasmaPixel(const uint16_t k, const uint8_t colorIndex) const {
+    const uint8_t thisBright = qsuba(colorIndex, beatsin8(7,0,96));              // qsub gives it a bit of 'black' dead space by setting sets a minimum value. If colorIndex < current value of beatsin8(), then bright = 0. Otherwise, bright = colorIndex..
+    //plasma becomes slime during Halloween (single color morphing mass)
+    const uint8_t clr = paletteFactory.isHolidayLimitedHue() ? monoColor : colorIndex;
+    leds[k] = ColorFromPalette(palette, clr, thisBright, LINEARBLEND);  // Let's now add the foreground colour.
 }
 
-FxD3::FxD3() : LedEffect(fxd3Desc) {
+FxD3::FxD3() {
     monoColor = 0;
 }
 
@@ -195,12 +183,8 @@ void FxD3::windDownPrep() {
     transEffect.prepare(SELECTOR_WIPE + random8());
 }
 
-uint8_t FxD3::selectionWeight() const {
-    return 24;
-}
-
 // Fx D4
-FxD4::FxD4() : LedEffect(fxd4Desc) {}
+FxD4::FxD4() = default;
 
 void FxD4::setup() {
     LedEffect::setup();
@@ -217,9 +201,9 @@ void FxD4::run() {
         secSlot = inc(secSlot, 1, 15);
     }
 
-    EVERY_N_MILLISECONDS(50) {
+    FRAME_EVERY_N_MILLIS(50) {
         rainbow_march();
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
 }
 
@@ -243,7 +227,7 @@ void FxD4::rainbow_march() {
           ColorFromPalette(palette, 255-hue, brightness));
     else {
         tpl.fill_rainbow(hue, hueDiff);           // I don't change hueDiff on the fly as it's too fast near the end of the strip.
-        tpl.nscale8(brightness);
+        scaleSet(tpl, brightness);
     }
     replicateSet(tpl, others);
 }
@@ -252,41 +236,41 @@ bool FxD4::windDown() {
     return transEffect.offSpots();
 }
 
-uint8_t FxD4::selectionWeight() const {
-    return 18;
-}
-
 // Fx D5
-FxD5::FxD5() : LedEffect(fxd5Desc) {}
+FxD5::FxD5() = default;
 
 void FxD5::setup() {
     LedEffect::setup();
+    //all ripples start expired, they are spawned randomly while running
+    if (!ripplePool.begin(maxRipples))
+        log_warn(F("Effect %s [%d] - %d ripples do not fit the scratch arena (%zu bytes available), no ripples spawned"), name(), getRegistryIndex(),
+                 maxRipples, fxArena.available());
 }
 
 void FxD5::run() {
     EVERY_N_SECONDS(2) {
         nblendPaletteTowardPalette(palette, targetPalette, maxChanges);
     }
-    EVERY_N_MILLISECONDS(100) {
+    FRAME_EVERY_N_MILLIS(100) {
         ripples();
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
 }
 
 void FxD5::ripples() {
     //fadeToBlackBy(leds, NUM_PIXELS, fade);                             // 8 bit, 1 = slow, 255 = fast
-    for (auto & r : ripplesData) {
-        if (random8() > 224 && !r.Alive()) {
-            r.Init(&tpl);
-        }
+    //each expired ripple has a 1 in 8 chance to restart
+    const uint16_t expired = ripplePool.capacity() - ripplePool.count();
+    for (uint16_t i = 0; i < expired; i++) {
+        if (random8() > 224)
+            spawnRipple();
     }
 
-    for (auto & r : ripplesData) {
-        if (r.Alive()) {
-            r.Fade();
-            r.Move();
-        }
-    }
+    ripplePool.forEach([this](const uint16_t i) {
+        rippleFade(i);
+        rippleMove(i);
+    });
+    ripplePool.age();
     replicateSet(tpl, others);
 }
 
@@ -294,39 +278,42 @@ void FxD5::windDownPrep() {
     transEffect.prepare(SELECTOR_WIPE + random8());
 }
 
-// ripple structure API
-void ripple::Move() {
+// ripple particles
+/**
+ * Starts a new ripple, if a ripple particle is available
+ */
+void FxD5::spawnRipple() {
+    const int16_t i = ripplePool.spawn();
+    if (i < 0)
+        return;
+    const uint16_t sz = tpl.size();
+    ripplePool.pos[i] = ParticlePool::toFixed(random8(sz / 8, sz - sz / 8));    // Avoid spawning too close to edge.
+    ripplePool.bright[i] = random8(192, 255);                                     // upper range of localBright
+    ripplePool.hue[i] = random8();
+    ripplePool.aux[i] = random8(25, 80);
+    ripplePool.life[i] = rippleSteps;
+}
+
+void FxD5::rippleMove(const uint16_t i) const {
+    const uint16_t center = ripplePool.pixel(i);
+    const uint8_t step = rippleSteps - ripplePool.life[i];
+    const uint8_t color = ripplePool.hue[i];
+    const uint8_t rpBright = ripplePool.bright[i];
     if (step == 0) {
-        (*pSeg)[center] = ColorFromPalette(palette, color, rpBright, LINEARBLEND);
+        tpl[center] = ColorFromPalette(palette, color, rpBright, LINEARBLEND);
     } else if (step < 12) {
-        uint16_t x = (center + step) % pSeg->size();
-        x = (center + step) >= pSeg->size() ? (pSeg->size() - x - 1) : x;        // we want the "wave" to bounce back from the end, rather than start from the other end
-        (*pSeg)[x] += ColorFromPalette(palette, color + 16, rpBright*2/step, LINEARBLEND);       // Simple wrap from Marc Miller
-        x = asub(center, step) % pSeg->size();
-        (*pSeg)[x] += ColorFromPalette(palette, color + 16, rpBright*2/step, LINEARBLEND);
+        uint16_t x = (center + step) % tpl.size();
+        x = (center + step) >= tpl.size() ? (tpl.size() - x - 1) : x;        // we want the "wave" to bounce back from the end, rather than start from the other end
+        tpl[x] += ColorFromPalette(palette, color + 16, rpBright*2/step, LINEARBLEND);       // Simple wrap from Marc Miller
+        x = asub(center, step) % tpl.size();
+        tpl[x] += ColorFromPalette(palette, color + 16, rpBright*2/step, LINEARBLEND);
     }
-    step++;  // Next step.
 }
 
-void ripple::Fade() const {
-    const uint16_t lowEndRipple = qsuba(center, step);
-    const uint16_t upEndRipple = capu(center + step, pSeg->size()-1);
-    (*pSeg)(lowEndRipple, upEndRipple).fadeToBlackBy(rpFade);
+void FxD5::rippleFade(const uint16_t i) const {
+    const uint16_t center = ripplePool.pixel(i);
+    const uint8_t step = rippleSteps - ripplePool.life[i];
+    CRGBSet ripple = tpl(qsuba(center, step), capu(center + step, tpl.size()-1));
+    fadeSet(ripple, ripplePool.aux[i]);
 }
 
-bool ripple::Alive() const {
-    return step < 42;
-}
-
-void ripple::Init(CRGBSet *set) {
-    pSeg = set;
-    center = random8(pSeg->size() / 8, pSeg->size() - pSeg->size() / 8);          // Avoid spawning too close to edge.
-    rpBright = random8(192, 255);                                   // upper range of localBright
-    color = random8();
-    rpFade = random8(25, 80);
-    step = 0;
-}
-
-uint8_t FxD5::selectionWeight() const {
-    return 42;
-}
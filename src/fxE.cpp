@@ -7,24 +7,9 @@
 using namespace FxE;
 using namespace colTheme;
 
-//~ Effect description strings stored in flash
-constexpr auto fxe1Desc PROGMEM = "FXE1: twinkle";
-constexpr auto fxe2Desc PROGMEM = "FXE2: beat wave";
-constexpr auto fxe3Desc PROGMEM = "FXE3: sawtooth back/forth";
-constexpr auto fxe4Desc PROGMEM = "FXE4: serendipitous";
-constexpr auto fxe5Desc PROGMEM = "FXE5: three single color beat-waves";
-
 uint8_t FxE::twinkRate = 100;
 bool FxE::randHue = true;
 
-void FxE::fxRegister() {
-    new FxE1();
-    new FxE2();
-    new FxE3();
-    new FxE4();
-    new FxE5();
-}
-
 /**
  * Display Template for FastLED
  * By: Andrew Tuline
@@ -34,7 +19,7 @@ void FxE::fxRegister() {
  * This is a simple non-blocking FastLED display sequence template.
  *
  */
-FxE1::FxE1() : LedEffect(fxe1Desc) {}
+FxE1::FxE1() = default;
 
 void FxE1::setup() {
     LedEffect::setup();
@@ -52,9 +37,9 @@ void FxE1::run() {
         nblendPaletteTowardPalette(palette, targetPalette, maxChanges);
     }
 
-    EVERY_N_MILLISECONDS_I(fxe1Timer, speed) {                           // FastLED based non-blocking speed to update/display the sequence.
+    FRAME_EVERY_N_MILLIS_I(fxe1Timer, speed) {                           // FastLED based non-blocking speed to update/display the sequence.
         twinkle();
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
         fxe1Timer.setPeriod(speed);
     }
 
@@ -68,8 +53,8 @@ void FxE1::run() {
 
 void FxE1::twinkle() {
 
-  if (random8() < twinkRate) leds[random16(NUM_PIXELS)] += ColorFromPalette(palette, (randHue ? random8() : hue), brightness, LINEARBLEND);
-  fadeToBlackBy(leds, NUM_PIXELS, fade);
+  if (random8() < twinkRate) leds[random16(topology.logicalSize())] += ColorFromPalette(palette, (randHue ? random8() : hue), brightness, LINEARBLEND);
+  fadeToBlackBy(leds, topology.logicalSize(), fade);
   
 } // twinkle()
 
@@ -94,12 +79,8 @@ bool FxE1::windDown() {
     return transEffect.offSpots();
 }
 
-uint8_t FxE1::selectionWeight() const {
-    return 22;
-}
-
 // Fx E2
-FxE2::FxE2() : LedEffect(fxe2Desc) {}
+FxE2::FxE2() = default;
 
 void FxE2::setup() {
     LedEffect::setup();
@@ -110,9 +91,9 @@ void FxE2::setup() {
 }
 
 void FxE2::run() {
-    EVERY_N_MILLIS(100) {
+    FRAME_EVERY_N_MILLIS(100) {
         beatwave();
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
 
     EVERY_N_SECONDS(2) {
@@ -141,12 +122,8 @@ void FxE2::windDownPrep() {
     transEffect.prepare(random8());
 }
 
-uint8_t FxE2::selectionWeight() const {
-    return 17;
-}
-
 //Fx E3
-FxE3::FxE3() : LedEffect(fxe3Desc), shdOverlay(frame(0, FRAME_SIZE-1)) {
+FxE3::FxE3() : shdOverlay(frame(0, FRAME_SIZE-1)) {
 }
 
 void FxE3::setup() {
@@ -165,7 +142,7 @@ void FxE3::setup() {
  * Good thing that Nano RP2040 is powerful enough to make this fast.
  */
 void FxE3::run() {
-    EVERY_N_MILLISECONDS(60) {
+    FRAME_EVERY_N_MILLIS(60) {
         const uint16_t maxIndex = tpl.size() - 1;
         if (timerSlot == 0) {
             switch (move) {
@@ -213,7 +190,7 @@ void FxE3::run() {
         CRGBSet seg = tpl(segStart, segEnd);
         switch (move) {
             case forward: seg = ColorFromPalette(palette, colorIndex, fade, LINEARBLEND); break;
-            case backward: seg.fadeToBlackBy(fade); break;
+            case backward: fadeSet(seg, fade); break;
             case sasquatch: seg[seg.size()-1].fadeToBlackBy(252); break;
         }
 
@@ -232,7 +209,7 @@ void FxE3::run() {
         }
 
         replicateSet(tpl, others);
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
 }
 
@@ -240,12 +217,8 @@ void FxE3::windDownPrep() {
     transEffect.prepare(random8());
 }
 
-uint8_t FxE3::selectionWeight() const {
-    return 27;
-}
-
 //Fx E4
-FxE4::FxE4() : LedEffect(fxe4Desc) {}
+FxE4::FxE4() = default;
 
 void FxE4::setup() {
     LedEffect::setup();
@@ -264,9 +237,9 @@ void FxE4::run() {
         }
     }
 
-    EVERY_N_MILLISECONDS(50) {
+    FRAME_EVERY_N_MILLIS(50) {
         serendipitous();
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
 }
 
@@ -286,7 +259,7 @@ void FxE4::serendipitous() {
     const CRGB newcolor = ColorFromPalette(palette, index, map(Zn, 0, 65535, dimmed*3, brightness), LINEARBLEND);
 
     nblend(tpl[map(X, 0, 65535, 0, tpl.size()-1)], newcolor, 224);    // Try and smooth it out a bit. Higher # means less smoothing.
-    tpl.fadeToBlackBy(16);                    // 8 bit, 1 = slow, 255 = fast
+    fadeSet(tpl, 16);                         // 8 bit, 1 = slow, 255 = fast
     replicateSet(tpl, others);
 }
 
@@ -294,12 +267,8 @@ void FxE4::windDownPrep() {
     transEffect.prepare(random8());
 }
 
-uint8_t FxE4::selectionWeight() const {
-    return 36;
-}
-
 // FxE5
-FxE5::FxE5() : LedEffect(fxe5Desc), wave2(frame(0, FRAME_SIZE-1)), wave3(frame(FRAME_SIZE, 2*FRAME_SIZE-1)) {
+FxE5::FxE5() : wave2(frame(0, FRAME_SIZE-1)), wave3(frame(FRAME_SIZE, 2*FRAME_SIZE-1)) {
     clr1 = clr2 = clr3 = 0;
     pos2 = pos3 = 0;
 }
@@ -312,10 +281,10 @@ void FxE5::setup() {
 }
 
 void FxE5::run() {
-    EVERY_N_MILLIS(30) {
-        tpl.fadeToBlackBy(30);
-        wave2.fadeToBlackBy(40);
-        wave3.fadeToBlackBy(50);
+    FRAME_EVERY_N_MILLIS(30) {
+        fadeSet(tpl, 30);
+        fadeSet(wave2, 40);
+        fadeSet(wave3, 50);
 
         const CRGB col1 = ColorFromPalette(palette, clr1, brightness, LINEARBLEND);
         const CRGB col2 = ColorFromPalette(palette, clr2, brightness, LINEARBLEND);
@@ -334,7 +303,7 @@ void FxE5::run() {
         tpl += wave2;
         replicateSet(tpl, others);
 
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
 
     EVERY_N_SECONDS(27) {
@@ -349,6 +318,3 @@ void FxE5::windDownPrep() {
     transEffect.prepare(random8());
 }
 
-uint8_t FxE5::selectionWeight() const {
-    return 42;
-}
@@ -2,7 +2,6 @@
 // Copyright (c) 2023,2024,2025 by Dan Luca. All rights reserved
 //
 #include "fxF.h"
-#include <vector>
 #include <algorithm>
 #include "transition.h"
 #include "util.h"
@@ -10,23 +9,8 @@
 using namespace FxF;
 using namespace colTheme;
 
-//~ Effect description strings stored in flash
-constexpr auto fxf1Desc PROGMEM = "FXF1: beat wave";
-constexpr auto fxf2Desc PROGMEM = "FXF2: Halloween breathe with various color blends";
-constexpr auto fxf3Desc PROGMEM = "FXF3: Eye Blink";
-constexpr auto fxf4Desc PROGMEM = "FXF4: Bouncy segments";
-constexpr auto fxf5Desc PROGMEM = "FXF5: Fireworks";
-
-void FxF::fxRegister() {
-    new FxF1();
-    new FxF2();
-    new FxF3();
-    new FxF4();
-    new FxF5();
-}
-
 // FxF1
-FxF1::FxF1() : LedEffect(fxf1Desc) {}
+FxF1::FxF1() = default;
 
 void FxF1::setup() {
     LedEffect::setup();
@@ -37,9 +21,9 @@ void FxF1::setup() {
 }
 
 void FxF1::run() {
-    EVERY_N_MILLISECONDS(speed) {
+    FRAME_EVERY_N_MILLIS(speed) {
         constexpr uint8_t dotSize = 2;
-        tpl.fadeToBlackBy(fade);
+        fadeSet(tpl, fade);
 
         const uint16_t w1 = (beatsin16(12, 0, tpl.size()-dotSize-1) + beatsin16(24, 0, tpl.size()-dotSize-1))/2;
         const uint16_t w2 = beatsin16(14, 0, tpl.size()-dotSize-1, 0, beat8(10)*128);
@@ -54,7 +38,7 @@ void FxF1::run() {
         seg2 |= clr2;
 
         replicateSet(tpl, others);
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
         hue += hueDiff;
     }
 }
@@ -63,12 +47,8 @@ bool FxF1::windDown() {
     return transEffect.offSpots();
 }
 
-uint8_t FxF1::selectionWeight() const {
-    return 12;
-}
-
 // FxF2
-FxF2::FxF2() : LedEffect(fxf2Desc), pattern(frame(0, FRAME_SIZE-1)) {
+FxF2::FxF2() : pattern(frame(0, FRAME_SIZE-1)) {
 }
 
 void FxF2::setup() {
@@ -80,7 +60,7 @@ void FxF2::setup() {
 
 void FxF2::run() {
     // frame rate - 20fps
-    EVERY_N_MILLISECONDS(50) {
+    FRAME_EVERY_N_MILLIS(50) {
         const double dBreath = (exp(sin(millis()/2400.0*PI)) - 0.36787944)*108.0;//(exp(sin(millis()/2000.0*PI)) - 0.36787944)*108.0;       //(exp(sin(millis()/4000.0*PI)) - 0.36787944)*108.0;//(exp(sin(millis()/2000.0*PI)) - 0.36787944)*108.0;
         const uint8_t breathLum = map(dBreath, 0, 255, 0, BRIGHTNESS);
         const CRGB clr = ColorFromPalette(palette, hue, breathLum, LINEARBLEND);
@@ -89,7 +69,7 @@ void FxF2::run() {
                 (*p) = clr;
         }
         replicateSet(tpl, others);
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
 
         if (breathLum < 2) {
             hue += hueDiff;
@@ -117,23 +97,29 @@ bool FxF2::windDown() {
     return transEffect.offWipe(false);
 }
 
-uint8_t FxF2::selectionWeight() const {
-    return paletteFactory.getHoliday() == Halloween ? 42 : 24;
-}
-
 // FxF3
-FxF3::FxF3() : LedEffect(fxf3Desc) {}
+FxF3::FxF3() = default;
 
 void FxF3::setup() {
     LedEffect::setup();
     hue = random8();
     hueDiff = 11;
-    //reset all eyes
-    for (auto & e : eyes)
-        e.reset(0, BKG);
+    //create all eyes, reset
+    static_assert(sizeof(EyeBlink) * maxEyes <= FX_ARENA_SIZE, "FxF3 eyes do not fit the scratch arena");
+    eyes = fxArena.makeArray<EyeBlink>(maxEyes);
+    if (eyes == nullptr) {
+        //the arena is shared - e.g. while crossfading or with blocks pinned by the running effect under the layers
+        log_warn(F("Effect %s [%d] - %d eyes do not fit the scratch arena (%zu bytes available), no eyes shown"), name(), getRegistryIndex(),
+                 maxEyes, fxArena.available());
+        return;
+    }
+    for (uint8_t i = 0; i < maxEyes; i++)
+        eyes[i].reset(0, BKG);
 }
 
 void FxF3::run() {
+    if (eyes == nullptr)
+        return;
     EVERY_N_SECONDS(5) {
         //activate eyes if possible
         const uint8_t numEyes = 1 + random8(maxEyes);
@@ -148,12 +134,12 @@ void FxF3::run() {
             }
         }
     }
-    EVERY_N_MILLISECONDS(60) {
+    FRAME_EVERY_N_MILLIS(60) {
         //step advance each active eye
-        for (auto & eye : eyes)
-            eye.step();
+        for (uint8_t i = 0; i < maxEyes; i++)
+            eyes[i].step();
         replicateSet(tpl, others);
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
 }
 
@@ -162,9 +148,9 @@ void FxF3::run() {
  * @return pointer to first inactive eye, nullptr if all eyes are active
  */
 EyeBlink * FxF3::findAvailableEye() {
-    for (auto & eye : eyes) {
-        if (!eye)
-            return &eye;
+    for (uint8_t i = 0; i < maxEyes; i++) {
+        if (!eyes[i])
+            return &eyes[i];
     }
     return nullptr;
 }
@@ -175,21 +161,23 @@ EyeBlink * FxF3::findAvailableEye() {
  * @return the viewport of the largest gap; a viewport of size 0 if no gaps exists for an eye to fit in
  */
 Viewport FxF3::nextEyePos() {
-    //find active eyes
-    std::vector<EyeBlink*> actEyes;
-    for (auto & e : eyes) {
-        if (e)
-            actEyes.push_back(&e);
+    //find active eyes - fixed size list on the stack, no heap allocations while running
+    EyeBlink *actEyes[maxEyes];
+    uint8_t numActive = 0;
+    for (uint8_t i = 0; i < maxEyes; i++) {
+        if (eyes[i])
+            actEyes[numActive++] = &eyes[i];
     }
     //if no active eyes (like beginning) return the full tpl strip
-    if (actEyes.empty())
+    if (numActive == 0)
         return {0, static_cast<uint16_t>(tpl.size() - EyeBlink::size)};
 
     //sort active eyes ascending by position - notice the use of lambda expression for custom comparator (available since C++11, we're using C++14) - cool stuff!!
-    std::sort(actEyes.begin(), actEyes.end(), [](const EyeBlink *a, const EyeBlink *b) {return a->pos < b->pos;});
+    std::sort(actEyes, actEyes + numActive, [](const EyeBlink *a, const EyeBlink *b) {return a->pos < b->pos;});
     //find the gaps
     uint16_t posGap = 0, szGap = 0, prevEyeEnd = 0, curGap = 0;
-    for (const auto & actEye : actEyes) {
+    for (uint8_t i = 0; i < numActive; i++) {
+        const EyeBlink *actEye = actEyes[i];
         curGap = actEye->pos - prevEyeEnd;
         if (curGap > szGap) {
             posGap = prevEyeEnd;
@@ -210,10 +198,6 @@ bool FxF3::windDown() {
     return transEffect.offWipe(true);
 }
 
-uint8_t FxF3::selectionWeight() const {
-    return paletteFactory.getHoliday() == Halloween ? 42 : 24;
-}
-
 /**
  * Default constructor - initializes all fields with sensible values
  */
@@ -332,7 +316,7 @@ void FxF4::setup() {
 }
 
 void FxF4::run() {
-    EVERY_N_MILLISECONDS_I(fxf4Timer, 50) {
+    FRAME_EVERY_N_MILLIS_I(fxf4Timer, 50) {
         switch (fxState) {
             case Bounce:
                 if (delta > 0) {
@@ -393,7 +377,7 @@ void FxF4::run() {
         }
 
         replicateSet(tpl, others);
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
 }
 
@@ -423,10 +407,10 @@ void FxF4::offsetBounce(const CRGB &feed) const {
     }
 }
 
-FxF4::FxF4() : LedEffect(fxf4Desc), fxState(Bounce), set1(frame(0, (tpl.size() + wiggleRoom)/ 2 - 1)), set2(frame(tpl.size() + wiggleRoom - 1, (tpl.size() + wiggleRoom)/2)) {
+FxF4::FxF4() : fxState(Bounce), set1(frame(0, (tpl.size() + wiggleRoom)/ 2 - 1)), set2(frame(tpl.size() + wiggleRoom - 1, (tpl.size() + wiggleRoom)/2)) {
     ofs = wiggleRoom/2;
     for (uint16_t x = 0; x < upLim; x++)
-        bouncyCurve[x] = easeOutBounce(x, upLim - 1);
+        bouncyCurve[x] = ease(EaseBounce, EaseOut, x, upLim - 1);
 
 }
 
@@ -434,16 +418,12 @@ bool FxF4::windDown() {
     return transEffect.offWipe(true);
 }
 
-uint8_t FxF4::selectionWeight() const {
-    return paletteFactory.getHoliday() == Halloween ? 12 : 42;
-}
-
 // FxF5 - algorithm by Carl Rosendahl, adapted from code published at https://www.anirama.com/1000leds/1d-fireworks/
-// HEAVY floating point math
-FxF5::FxF5() : LedEffect(fxf5Desc) {}
+// The sparks run on the particle pool, with 15.16 fixed point kinematics - no floating point math
+FxF5::FxF5() = default;
 
 void FxF5::run() {
-    EVERY_N_MILLIS_I(fxf5Timer, 1000) {
+    FRAME_EVERY_N_MILLIS_I(fxf5Timer, 1000) {
         flare();
 
         explode();
@@ -454,50 +434,56 @@ void FxF5::run() {
 
 void FxF5::setup() {
     LedEffect::setup();
+    //the explosion has a spark for every 3 pixels of flare height; the flare goes up to explRangeHigh of the strip
+    if (!sparks.begin(max<uint16_t>(flareSparksCount, tpl.size() * explRangeHigh / 30 + 1)))
+        log_warn(F("Effect %s [%d] - sparks do not fit the scratch arena (%zu bytes available), no sparks spawned"), name(), getRegistryIndex(),
+                 fxArena.available());
 }
 
 /**
  * Send up a flare
  */
 void FxF5::flare() {
-    constexpr ushort flareSparksCount = 3;
-    float flareStep = flarePos = 0;
+    saccum1516 flareStep = 0;
+    flarePos = 0;
     bFade = random8() % 2;
     curPos = random16(tpl.size()*explRangeLow/10, tpl.size()*explRangeHigh/10);
-    float flareVel = float(random16(400, 650)) / 1000; // trial and error to get reasonable range to match the 30-80 % range of the strip height we want
-    float flBrightness = 255;
-    Spark flareSparks[flareSparksCount];
+    saccum1516 flareVel = static_cast<saccum1516>(random16(400, 650)) * 65536 / 1000; // trial and error to get reasonable range to match the 30-80 % range of the strip height we want
+    uint16_t flBrightness = 255 << 8;      // 8.8 fixed point
 
     // initialize launch sparks
-    for (auto &[pos, velocity, hue] : flareSparks) {
-        pos = 0;
-        velocity = (float(random8(180,255)) / 255) * (flareVel / 2);
+    sparks.clear();
+    for (ushort s = 0; s < flareSparksCount; s++) {
+        const int16_t i = sparks.spawn();
+        if (i < 0)
+            break;
+        sparks.pos[i] = 0;
+        sparks.vel[i] = static_cast<saccum1516>(random8(180,255)) * (flareVel / 2) / 255;
         // random around 20% of flare velocity
-        hue = uint8_t(velocity * 1000);
+        sparks.hue[i] = static_cast<uint8_t>((sparks.vel[i] * 1000) >> 16);
     }
+    const saccum1516 sparksTop = ParticlePool::toFixed(static_cast<int16_t>(curPos));
     // launch
-    while ((ushort(flarePos) < curPos) && (flareVel > 0)) {
+    while ((flarePos < curPos) && (flareVel > 0)) {
         tpl = BKG;
         // sparks
-        for (auto &spark : flareSparks) {
-            spark.pos += spark.velocity;
-            spark.limitPos(curPos);
-            spark.velocity += gravity;
-            spark.hue = capd(qsuba(spark.hue, 1), 64);
-            tpl[spark.iPos()] = HeatColor(spark.hue);
-            tpl[spark.iPos()] %= 50; // reduce brightness to 50/255
-        }
+        sparks.move(gravity, 0, sparksTop);
+        sparks.forEach([this](const uint16_t i) {
+            sparks.hue[i] = capd(qsuba(sparks.hue[i], 1), 64);
+            const uint16_t px = sparks.pixel(i);
+            tpl[px] = HeatColor(sparks.hue[i]);
+            tpl[px] %= 50; // reduce brightness to 50/255
+        });
 
         // flare
-        flarePos = easeOutQuad(ushort(flareStep), curPos);
-        tpl[ushort(flarePos)] = CHSV(0, 0, ushort(flBrightness));
+        flarePos = ease(EaseQuad, EaseOut, ParticlePool::toPixel(flareStep), curPos);
+        tpl[flarePos] = CHSV(0, 0, flBrightness >> 8);
         replicateSet(tpl, others);
         flareStep += flareVel;
-        //flarePos = constrain(flarePos, 0, curPos);
         flareVel += gravity;
-        flBrightness *= .985;
+        flBrightness = static_cast<uint32_t>(flBrightness) * 64553 >> 16;    // *= .985
 
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
         watchdogPing();
     }
 }
@@ -508,68 +494,66 @@ void FxF5::flare() {
  * Explosion happens where the flare ended.
  * Size is proportional to the height.
  */
-void FxF5::explode() const {
-    const auto nSparks = ushort(flarePos / 3); // works out to look about right
-    Spark sparks[nSparks];
+void FxF5::explode() {
+    const ushort nSparks = flarePos / 3; // works out to look about right
     //map the flare position in its range to a hue
-    const uint8_t decayHue = constrain(map(ushort(flarePos), tpl.size()*explRangeLow/10, tpl.size()*explRangeHigh/10, 0, 255), 0, 255);
+    const uint8_t decayHue = constrain(map(flarePos, tpl.size()*explRangeLow/10, tpl.size()*explRangeHigh/10, 0, 255), 0, 255);
     const uint8_t flarePosQdrnt = decayHue/64;
+    const saccum1516 origin = ParticlePool::toFixed(static_cast<int16_t>(flarePos));
+    //spark velocity scale - flarePos/1.7/tpl.size() - proportional to height
+    const int32_t velScale = static_cast<int32_t>(flarePos) * 655360 / (17 * tpl.size());
 
     // initialize sparks
-    for (auto &[pos, velocity, hue] : sparks) {
-        pos = flarePos;
-        velocity = (static_cast<float>(random16(0, 20000)) / 10000.0f) - 1.0f; // from -1 to 1
-        hue = random8(flarePosQdrnt*64, 64+flarePosQdrnt*64);   //limit the spark hues in a closer color range based on flare height
-        velocity *= flarePos/1.7f/ static_cast<float>(tpl.size()); // proportional to height
+    sparks.clear();
+    for (ushort s = 0; s < nSparks; s++) {
+        const int16_t i = sparks.spawn();
+        if (i < 0)
+            break;
+        sparks.pos[i] = origin;
+        const saccum1516 velocity = static_cast<saccum1516>(random16(0, 20000)) * 65536 / 10000 - 65536; // from -1 to 1
+        sparks.hue[i] = random8(flarePosQdrnt*64, 64+flarePosQdrnt*64);   //limit the spark hues in a closer color range based on flare height
+        sparks.vel[i] = static_cast<saccum1516>(static_cast<int64_t>(velocity) * velScale >> 16);
     }
     // the original implementation was to designate a known spark starting from a known value and iterate until it goes below a fixed threshold - c2/128
     // since they were all fixed values, the math shows the number of iterations can be precisely determined. The formula is iterCount = log(c2/128/255)/log(degFactor),
     // rounded up to nearest integer. For instance, for original values of c2=50, degFactor=0.99, we're looking at 645 loops. With some experiments, I've landed
     // at c2=30, degFactor=0.987, looping at 535 loops.
     constexpr ushort loopCount = 540;
-    float dying_gravity = gravity;
+    const saccum1516 sparksTop = ParticlePool::toFixed(static_cast<int16_t>(tpl.size()-1));
+    int32_t dyingGravity = gravity * 256;     // 8.24 fixed point - the extra precision keeps the exponential decay below accurate
     ushort iter = 0;
-    bool activeSparks = true;
-    while((iter++ < loopCount) && activeSparks) {
+    while((iter++ < loopCount) && (sparks.count() > 0)) {
         if (bFade)
-            tpl.fadeToBlackBy(9);
+            fadeSet(tpl, 9);
         else
             tpl = BKG;
-        activeSparks = false;
-        for (auto &spark : sparks) {
-            if (spark.iPos() == 0)
-                continue;   //if this spark has reached bottom, save our breath
-            activeSparks = true;
-            spark.pos += spark.velocity;
-            spark.limitPos(float(tpl.size()-1));
-            spark.velocity += dying_gravity;
-            //spark.colorFade *= .987f;       //degradation factor degFactor in formula above
-            //fade the sparks
-//            auto spDist = uint8_t(abs(spark.pos - flarePos) * 255 / flarePos);
-            const auto spDist = uint8_t(abs(spark.pos - flarePos));
-            const ushort tplPos = spark.iPos();
-            if (bFade) {
-                tpl[tplPos] += ColorFromPalette(palette, spark.hue+spDist, 255-2*spDist);
-                //tpl.blur1d();
-            } else {
-                tpl[tplPos] = blend(ColorFromPalette(palette, spark.hue), CHSV(decayHue, 224, 255-2*spDist), 3*spDist);
-            }
-        }
+        //the sparks that have reached bottom are done, save our breath
+        sparks.forEach([this](const uint16_t i) {
+            if (sparks.pixel(i) == 0)
+                sparks.kill(i);
+        });
+        sparks.move((dyingGravity + 128) >> 8, 0, sparksTop);
+        //fade the sparks
+        sparks.forEach([this, origin, decayHue](const uint16_t i) {
+            const auto spDist = static_cast<uint8_t>(abs(sparks.pos[i] - origin) >> 16);
+            const uint16_t tplPos = sparks.pixel(i);
+            if (bFade)
+                tpl[tplPos] += ColorFromPalette(palette, sparks.hue[i]+spDist, 255-2*spDist);
+            else
+                tpl[tplPos] = blend(ColorFromPalette(palette, sparks.hue[i]), CHSV(decayHue, 224, 255-2*spDist), 3*spDist);
+        });
 
-        dying_gravity *= 0.985; // as sparks burn out they fall slower
+        dyingGravity -= dyingGravity * 15 / 1000;   // as sparks burn out they fall slower - *= .985
         replicateSet(tpl, others);
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
         watchdogPing();
     }
     tpl = BKG;
     replicateSet(tpl, others);
-    FastLED.show(stripBrightness);
+    showStrip(stripBrightness);
 }
 
 bool FxF5::windDown() {
     return transEffect.offWipe(true);
 }
 
-uint8_t FxF5::selectionWeight() const {
-    return paletteFactory.getHoliday() == Halloween ? 10 : 64;
-}
@@ -7,23 +7,6 @@
 using namespace FxH;
 using namespace colTheme;
 
-//~ Effect description strings stored in flash
-constexpr auto fxh1Desc PROGMEM = "FXH1: Fire segments";
-constexpr auto fxh2Desc PROGMEM = "FXH2: confetti H";
-constexpr auto fxh3Desc PROGMEM = "FXH3: filling the strand with colours";
-constexpr auto fxh4Desc PROGMEM = "FXH4: TwinkleFox";
-constexpr auto fxh5Desc PROGMEM = "FXH5: RainbowSparkle";
-constexpr auto fxh6Desc PROGMEM = "FXH6: JustSparkle";
-
-void FxH::fxRegister() {
-    new FxH1();
-    new FxH2();
-    new FxH3();
-    new FxH4();
-    new FxH5();
-    new FxH6();
-}
-
 // Fire2012 with programmable Color Palette standard example, broken into multiple segments
 // Based on Fire2012 by Mark Kriegsman, July 2012 as part of "Five Elements" shown here: http://youtu.be/knWiGsmgycY
 // Four different static color palettes are provided here, plus one dynamic one.
@@ -47,7 +30,7 @@ void FxH::fxRegister() {
 // The dynamic palette shows how you can change the basic 'hue' of the
 // color palette every time through the loop, producing "rainbow fire".
 
-FxH1::FxH1() : LedEffect(fxh1Desc), fires{tpl(0, FRAME_SIZE / 2 - 1), tpl(FRAME_SIZE - 1, FRAME_SIZE / 2)} {
+FxH1::FxH1() : fires{tpl(0, FRAME_SIZE / 2 - 1), tpl(FRAME_SIZE - 1, FRAME_SIZE / 2)} {
 }
 
 void FxH1::setup() {
@@ -68,18 +51,14 @@ void FxH1::setup() {
     }
 
     //clear the fires
-    uint16_t maxSize = 0;
-    for (auto &fire: fires) {
+    for (auto &fire: fires)
         fire.fill_solid(BKG);
-        maxSize = max(maxSize, fire.size());
-    }
 
     //initialize the heat map
-    if (hMap.size() < maxSize) {
-        for (uint16_t x = hMap.size(); x < maxSize; x++)
-            hMap.push_back(BKG);
-    } else if (hMap.size() > maxSize)
-        hMap.erase(hMap.begin() + maxSize, hMap.end());
+    static_assert(2 * FRAME_SIZE + 2 * (numFires + 1) <= FX_ARENA_SIZE, "FxH1 heat map does not fit the scratch arena");
+    if (!fireSim.begin(fires, numFires, COOLING, SPARKING))
+        log_warn(F("Effect %s [%d] - heat map does not fit the scratch arena (%zu bytes available), fires stay dark"), name(), getRegistryIndex(),
+                 fxArena.available());
 
     // This first palette is the basic 'black body radiation' colors, which run from black to red to bright yellow to white.
     //gPal = HeatColors_p;
@@ -96,7 +75,7 @@ void FxH1::setup() {
 }
 
 void FxH1::run() {
-    EVERY_N_MILLIS(1000 / FRAMES_PER_SECOND) {
+    FRAME_EVERY_N_MILLIS(1000 / FRAMES_PER_SECOND) {
         // Add entropy to random number generator; we use a lot of it.
         // random() is a stdlib function that seems to leverage TRNG setup from mbed, unclear how is that achieved in RP2040 environment that does not
         // have native support for TRNG (however, the NanoRP2040 Connect board has a security chip ECC608B that does have a TRNG)
@@ -115,45 +94,16 @@ void FxH1::run() {
         //   CRGB lightcolor = CHSV(hue,128,255); // half 'whitened', full brightness
         //   gPal = CRGBPalette16( CRGB::Black, darkcolor, lightcolor, CRGB::White);
 
-        for (uint8_t x = 0; x < numFires; x++)
-            Fire2012WithPalette(x);  // run simulation frame 1, using palette colors
+        fireSim.advance();      // run simulation frame
+        renderSpans(0, fireSim.cells());    // map the heat to palette colors, on both cores
 
         replicateSet(tpl, others);
-        FastLED.show(stripBrightness);  // display this frame
+        showStrip(stripBrightness);  // display this frame
     }
 }
 
-void FxH1::Fire2012WithPalette(uint8_t xFire) {
-    //we only have 3 fires (numFires = 3) - abort if called for more than that
-    if (xFire >= numFires)
-        return;
-
-    // Step 1.  Cool down every cell a little
-    CRGBSet fire = fires[xFire];
-    for (uint16_t i = 0; i < fire.size(); i++) {
-        hMap[i][xFire] = qsub8(hMap[i][xFire], random8(0, ((COOLING * 10) / fire.size()) + 2));
-    }
-
-    // Step 2.  Heat from each cell drifts 'up' and diffuses a little
-    for (uint16_t k = fire.size() - 1; k >= 2; k--) {
-        hMap[k][xFire] = (hMap[k - 1][xFire] + hMap[k - 2][xFire] + hMap[k - 2][xFire]) / 3;
-    }
-
-    // Step 3.  Randomly ignite new 'sparks' of heat near the bottom
-    if (random8() < SPARKING) {
-        const uint8_t y = random8(7);
-        hMap[y][xFire] = qadd8(hMap[y][xFire], random8(160, 255));
-    }
-
-    // Step 4.  Map from heat cells to LED colors
-    for (uint16_t j = 0; j < fire.size(); j++) {
-        // Scale the heat value from 0-255 down to 0-240 for best results with color palettes.
-        const uint8_t colorIndex = scale8(hMap[j][xFire], 240);
-        const CRGB color = ColorFromPalette(palette, colorIndex);
-        fire[j] = color;
-        if (j > random8(5, 9))
-            fire[j].nscale8(brightness);
-    }
+void FxH1::renderSpan(const uint16_t lo, const uint16_t hi) {
+    fireSim.renderCells(paletteCache, brightness, lo, hi);
 }
 
 void FxH1::baseConfig(JsonObject &json) const {
@@ -166,12 +116,8 @@ void FxH1::windDownPrep() {
     transEffect.prepare(random8());
 }
 
-uint8_t FxH1::selectionWeight() const {
-    return paletteFactory.getHoliday() == Halloween ? 64 : 32;
-}
-
 // FxH2
-FxH2::FxH2() : LedEffect(fxh2Desc) {}
+FxH2::FxH2() = default;
 
 void FxH2::setup() {
     LedEffect::setup();
@@ -185,16 +131,16 @@ void FxH2::run() {
         nblendPaletteTowardPalette(palette, targetPalette, maxChanges);
     }
 
-    EVERY_N_MILLISECONDS(speed) {
+    FRAME_EVERY_N_MILLIS(speed) {
         confetti_pal();
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
 
 }
 
 void FxH2::confetti_pal() {
     // random colored speckles that blink in and fade smoothly
-    tpl.fadeToBlackBy(fade);  // Low values = slower fade.
+    fadeSet(tpl, fade);       // Low values = slower fade.
     const uint16_t pos = random16(tpl.size());             // Pick an LED at random.
     tpl[pos] = ColorFromPalette(palette, hue + random16(hueDiff) / 4, brightness, LINEARBLEND);
     hue = hue + delta;  // It increments here.
@@ -245,10 +191,6 @@ void FxH2::windDownPrep() {
     transEffect.prepare(random8());
 }
 
-uint8_t FxH2::selectionWeight() const {
-    return 24;
-}
-
 /**
  * fill_colours - TBD whether to keep, too close to rainbow march, etc.
  *
@@ -268,7 +210,7 @@ uint8_t FxH2::selectionWeight() const {
  *
  */
 // FxH3
-FxH3::FxH3() : LedEffect(fxh3Desc) {}
+FxH3::FxH3() = default;
 
 void FxH3::setup() {
     LedEffect::setup();
@@ -278,7 +220,7 @@ void FxH3::setup() {
 
 void FxH3::run() {
     // fill_rainbow section
-    EVERY_N_MILLISECONDS(speed) {
+    FRAME_EVERY_N_MILLIS(speed) {
         //below leds+1 is the same as &leds[1] - One pixel border at each end.
         if (paletteFactory.isHolidayLimitedHue())
             tpl(1, FRAME_SIZE - 2).fill_gradient_RGB(ColorFromPalette(palette, hue, brightness),
@@ -286,11 +228,11 @@ void FxH3::run() {
                                                      ColorFromPalette(palette, 255 - hue, brightness));
         else {
             tpl(1, FRAME_SIZE - 2).fill_rainbow(hue, hueDiff);
-            tpl.nscale8(brightness);
+            scaleSet(tpl, brightness);
         }
         hue += 3;
         replicateSet(tpl, others);
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
 
 }
@@ -305,10 +247,6 @@ void FxH3::windDownPrep() {
     transEffect.prepare(random8());
 }
 
-uint8_t FxH3::selectionWeight() const {
-    return 18;
-}
-
 /**
  * TwinkleFOX: Twinkling 'holiday' lights that fade in and out.
  * This December 2015 implementation improves on the December 2014 version
@@ -343,7 +281,7 @@ uint8_t FxH3::selectionWeight() const {
  * -Mark Kriegsman, December 2015
  */
 //FxH4
-FxH4::FxH4() : LedEffect(fxh4Desc) {
+FxH4::FxH4() {
 }
 
 void FxH4::setup() {
@@ -355,11 +293,11 @@ void FxH4::run() {
     EVERY_N_SECONDS(FxH4::secondsPerPalette) {
         targetPalette = PaletteFactory::selectNextPalette();
     }
-    EVERY_N_MILLISECONDS(25) {
+    FRAME_EVERY_N_MILLIS(25) {
         nblendPaletteTowardPalette(palette, targetPalette, 12);
         drawTwinkles(tpl);
         replicateSet(tpl, others);
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
 }
 
@@ -371,10 +309,6 @@ void FxH4::baseConfig(JsonObject &json) const {
     LedEffect::baseConfig(json);
 }
 
-uint8_t FxH4::selectionWeight() const {
-    return 12;
-}
-
 //  This function loops over each pixel, calculates the adjusted 'clock' that this pixel should use, and calls
 //  "CalculateOneTwinkle" on each pixel.  It then displays either the twinkle color of the background color,
 //  whichever is brighter.
@@ -490,7 +424,7 @@ void FxH4::coolLikeIncandescent(CRGB &c, uint8_t phase) {
 
 //Ref: https://github.com/Electriangle/RainbowSparkle_Main/blob/main/Rainbow_Sparkle_Main.ino
 //FxH5
-FxH5::FxH5() : LedEffect(fxh5Desc), small(leds, 7), rest(leds, small.size(), NUM_PIXELS-1) {
+FxH5::FxH5() : small(leds, 7), rest(leds, small.size(), topology.logicalSize()-1) {
     timer = 0;
     prevClr = BKG;
     pixelPos = 0;
@@ -506,7 +440,7 @@ void FxH5::setup() {
 }
 
 void FxH5::run() {
-    EVERY_N_MILLISECONDS(40) {
+    FRAME_EVERY_N_MILLIS(40) {
         //modify pixel after being shown, before the pixel index changes
         switch (fxState) {
             case Sparkle: small[pixelPos] = BKG; break;
@@ -522,7 +456,7 @@ void FxH5::run() {
                 small[pixelPos].maximizeBrightness(255);
                 break;
             case RampUp:
-                small.fadeToBlackBy(32);
+                fadeSet(small, 32);
                 small[pixelPos] |= clr;
                 break;
             case Glitter:
@@ -538,9 +472,9 @@ void FxH5::run() {
         CRGBSet segment = ledSet(0, small.size()*2-1);
         segment(small.size(), small.size()*2-1) = -small;    //mirror the small into the upper half of the segment
         replicateSet(segment, rest);
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
-    EVERY_N_MILLISECONDS(350) {
+    FRAME_EVERY_N_MILLIS(350) {
         electromagneticSpectrum(20);
         //effect phases
         FxState prevState = fxState;
@@ -562,10 +496,6 @@ void FxH5::baseConfig(JsonObject &json) const {
     LedEffect::baseConfig(json);
 }
 
-uint8_t FxH5::selectionWeight() const {
-    return 5;
-}
-
 void FxH5::electromagneticSpectrum(int transitionSpeed) {
     switch(colorStep) {
         case 0:
@@ -605,16 +535,27 @@ void FxH5::electromagneticSpectrum(int transitionSpeed) {
 static const FxH::Cycle cycles[] = {0x090100, 0x070102, 0x060103, 0x050105, 0x060202, 0x040205, 0x000208};
 
 // FxH6
-FxH6::FxH6() : LedEffect(fxh6Desc), window(leds, frameSize), rest(leds, frameSize, NUM_PIXELS-1) {
-    for (auto &p : window) {
-        sparks.push_back(new Spark(p));
-    }
+FxH6::FxH6() : window(leds, frameSize), rest(leds, frameSize, topology.logicalSize()-1) {
     timerCounter = 0;
     stage = DefinedPattern;
 }
 
 void FxH6::setup() {
     LedEffect::setup();
+    static_assert(sizeof(Spark) * frameSize <= FX_ARENA_SIZE, "FxH6 sparks do not fit the scratch arena");
+    sparks.clear();
+    activeSparks.clear();
+    for (auto &p : window) {
+        Spark *s = fxArena.make<Spark>(p);
+        if (s == nullptr) {
+            //the arena is shared - e.g. while crossfading or with blocks pinned by the running effect under the layers
+            log_warn(F("Effect %s [%d] - %d sparks do not fit the scratch arena (%zu bytes available), no sparks shown"), name(), getRegistryIndex(),
+                     frameSize, fxArena.available());
+            sparks.clear();
+            return;
+        }
+        sparks.push_back(s);
+    }
     random16_add_entropy(millis() & 0xFFFF);
     //pick a random number of active sparks to start with
     stage = DefinedPattern;
@@ -623,17 +564,16 @@ void FxH6::setup() {
 
 void FxH6::resetActivateAllSparks(uint8_t clrHint) {
     activeSparks.clear();
-    uint16_t index[frameSize];
-    shuffleIndexes(index, frameSize);
+    const IndexPermutation cycleOrder(frameSize, shuffleSeed());
     uint8_t x = 0;
     for (auto &s : sparks) {
         activeSparks.push_back(s);
         s->reset();
-        s->activate(ColorFromPalette(palette, sin8(clrHint), 255, LINEARBLEND), cycles[index[x++]]);
+        s->activate(ColorFromPalette(palette, sin8(clrHint), 255, LINEARBLEND), cycles[cycleOrder(x++)]);
     }
 }
 
-inline void activateSparkRandom(std::deque<Spark*> &active, Spark*& s, CRGB clr) {
+template<size_t N> inline void activateSparkRandom(FixedQueue<Spark*, N> &active, Spark*& s, CRGB clr) {
     active.push_back(s);
     s->activate(clr);   //no cycle pattern provided, defaults to random initialization of parameters
 }
@@ -646,7 +586,7 @@ void FxH6::activateSparks(uint8_t howMany, uint8_t clrHint) {
     }
     //in random stage, we're using a random number of sparks, this call is invoked when running low on active sparks
     //create a list of not used sparks
-    std::deque<Spark*> notUsed;
+    FixedQueue<Spark*, frameSize> notUsed;
     for (auto &s : sparks)
         if (s->state == Spark::Idle)
             notUsed.push_back(s);
@@ -668,7 +608,9 @@ void FxH6::activateSparks(uint8_t howMany, uint8_t clrHint) {
 }
 
 void FxH6::run() {
-    EVERY_N_MILLISECONDS(35) {
+    if (sparks.empty())
+        return;
+    FRAME_EVERY_N_MILLIS(35) {
         const uint8_t x = random8();
         for (auto it = activeSparks.begin(); it != activeSparks.end();)
             //if spark becomes idle, remove from list
@@ -677,7 +619,7 @@ void FxH6::run() {
         CRGBSet segment = ledSet(0, frameSize*2-1);
         segment(frameSize, frameSize*2-1) = -window;    //mirror the window into the upper half of the segment
         replicateSet(segment, rest);
-        FastLED.show(brightness);
+        showStrip(brightness);
 
         //activate more sparks if needed, in random mode; in pattern mode all sparks are active, hence the check below is always false
         if (activeSparks.size() < 2)
@@ -714,15 +656,6 @@ void FxH6::windDownPrep() {
     LedEffect::windDownPrep();
 }
 
-uint8_t FxH6::selectionWeight() const {
-    return 5;
-}
-
-FxH6::~FxH6() {
-    for (auto s: sparks)
-        delete s;
-}
-
 // FxH6 Spark
 Spark::Spark(CRGB &ref) : pixel(ref), fgClr(CRGB::White), bgClr(BKG), pattern(0), curCycle(0) {
     loop = dimBkg = false;
@@ -10,22 +10,9 @@
 using namespace FxI;
 using namespace colTheme;
 
-//~ Effect description strings stored in flash
-constexpr auto fxi1Desc PROGMEM = "FXI1: Ping Pong";
-constexpr auto fxi2Desc PROGMEM = "FXI2: Pacifica - gentle ocean waves";
-constexpr auto fxi3Desc PROGMEM = "FXI3: Three overlay segments";
-
-/**
- * Register FxI effects
- */
-void FxI::fxRegister() {
-    new FxI1();
-    new FxI2();
-}
-
 //FXI1
 
-FxI1::FxI1() : LedEffect(fxi1Desc) {
+FxI1::FxI1() {
     wallStart = 0;
     wallEnd = FRAME_SIZE;
     prevWallStart = wallStart;
@@ -82,12 +69,14 @@ static void updateWall(uint16_t &prevWall, const uint16_t wallLimit, const CRGB
 }
 
 static void blendWall(const uint16_t start, const uint16_t end, const CRGB color) {
-    if (tpl[end] != color)
-        tpl(start, end).nblend(color, 80);
+    if (tpl[end] != color) {
+        CRGBSet wall = tpl(start, end);
+        blendSet(wall, color, 80);
+    }
 }
 
 void FxI1::run() {
-    EVERY_N_MILLISECONDS_I(speed, 75) {
+    FRAME_EVERY_N_MILLIS_I(speed, 75) {
         //update the wall sizes and color
         const CRGB wallColor = ColorFromPalette(targetPalette, bgColor, 7, LINEARBLEND);
         if (forward) {
@@ -146,24 +135,11 @@ void FxI1::run() {
 
         // Display the updated LED state
         replicateSet(tpl, others);
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
 }
 
-uint8_t FxI1::selectionWeight() const {
-    return 7;
-}
-
 //FXI2 - Pacifica gentle ocean waves
-FxI2::FxI2(): LedEffect(fxi2Desc) {
-}
-
-void FxI2::setup() {
-    LedEffect::setup();
-    sCIStart1 = sCIStart2 = sCIStart3 = sCIStart4 = 0;
-    sLastMs = 0;
-}
-
 // These three custom blue-green color palettes were inspired by the colors found in
 // the waters off the southern coast of California, https: //goo.gl/maps/QQgd97jjHesHZVxQ7
 static const CRGBPalette16 pacifica_palette_1 PROGMEM = {
@@ -179,11 +155,38 @@ static const CRGBPalette16 pacifica_palette_3 PROGMEM = {
     0x000E39, 0x001040, 0x001450, 0x001860, 0x001C70, 0x002080, 0x1040BF, 0x2060FF
 };
 
+FxI2::FxI2() {
+}
+
+void FxI2::setup() {
+    LedEffect::setup();
+    waves.begin();
+}
+
+void FxI2::renderSpan(const uint16_t lo, const uint16_t hi) {
+    waves.render(tpl.leds, lo, hi);
+}
 
-void FxI2::pacifica_loop() {
+/**
+ * Resets the wave motion and expands the palettes, first time only
+ */
+void PacificaWaves::begin() {
+    sCIStart1 = sCIStart2 = sCIStart3 = sCIStart4 = 0;
+    sLastMs = 0;
+    if (!pal1.isValid()) {
+        pal1.expand(pacifica_palette_1);
+        pal2.expand(pacifica_palette_2);
+        pal3.expand(pacifica_palette_3);
+    }
+}
+
+/**
+ * Advances the wave motion to the time given and captures the parameters of each layer for this frame
+ * @param ms current time
+ */
+void PacificaWaves::advance(const uint32_t ms) {
     // Increment the four "color index start" counters, one for each wave layer.
     // Each is incremented at a different speed, and the speeds vary over time.
-    const uint32_t ms = millis();
     const uint32_t deltaMs = ms - sLastMs;
     sLastMs = ms;
     const uint16_t speedFactor1 = beatsin16(3, 179, 269);
@@ -196,63 +199,82 @@ void FxI2::pacifica_loop() {
     sCIStart3 -= (deltaMs1 * beatsin88(501, 5, 7));
     sCIStart4 -= (deltaMs2 * beatsin88(257, 4, 6));
 
+    // Four layers, with different scales and speeds, that vary over time
+    layers[0] = {&pal1, sCIStart1, beatsin16(3, 11 * 256, 14 * 256), static_cast<uint16_t>(0 - beat16(301)), beatsin8(10, 70, 130)};
+    layers[1] = {&pal2, sCIStart2, beatsin16(4, 6 * 256, 9 * 256), beat16(401), beatsin8(17, 40, 80)};
+    layers[2] = {&pal3, sCIStart3, 6 * 256, static_cast<uint16_t>(0 - beat16(503)), beatsin8(9, 10, 38)};
+    layers[3] = {&pal3, sCIStart4, 5 * 256, beat16(601), beatsin8(8, 10, 28)};
+
+    capThreshold = beatsin8(9, 55, 65);
+    capWave = beat8(7);
+}
+
+/**
+ * Renders a range of pixels of the current frame - the layers of waves, whitecaps and deepened colors
+ * @param dest pixel buffer the waves are rendered into
+ * @param lo first pixel of the range
+ * @param hi end of the range (exclusive)
+ */
+void PacificaWaves::render(CRGB *dest, const uint16_t lo, const uint16_t hi) const {
     // Clear out the LED array to a dim background blue-green
-    tpl.fill_solid(CRGB(2, 6, 10));
+    fill_solid(dest + lo, hi - lo, CRGB(2, 6, 10));
 
-    // Render each of four layers, with different scales and speeds, that vary over time
-    pacifica_one_layer(pacifica_palette_1, sCIStart1, beatsin16(3, 11 * 256, 14 * 256),
-        beatsin8(10, 70, 130), 0 - beat16(301));
-    pacifica_one_layer(pacifica_palette_2, sCIStart2, beatsin16(4, 6 * 256, 9 * 256),
-        beatsin8(17, 40, 80), beat16(401));
-    pacifica_one_layer(pacifica_palette_3, sCIStart3, 6 * 256, beatsin8(9, 10, 38), 0 - beat16(503));
-    pacifica_one_layer(pacifica_palette_3, sCIStart4, 5 * 256, beatsin8(8, 10, 28), beat16(601));
+    for (const auto &layer : layers)
+        addLayer(layer, dest, lo, hi);
 
     // Add brighter 'whitecaps' where the waves lines up more
-    pacifica_add_whitecaps();
+    addWhitecaps(dest, lo, hi);
 
     // Deepen the blues and greens a bit
-    pacifica_deepen_colors();
+    deepenColors(dest, lo, hi);
 }
 
-// Add one layer of waves into the LED array
-void FxI2::pacifica_one_layer(const CRGBPalette16 &p, const uint16_t ciStart, const uint16_t waveScale, const uint8_t bri, const uint16_t ioff) {
-    uint16_t ci = ciStart;
-    uint16_t waveAngle = ioff;
-    const uint16_t waveScale_half = (waveScale / 2) + 20;
-    for (uint16_t i = 0; i < tpl.size(); i++) {
+/**
+ * Add one layer of waves into the LED array. The color index accumulates along the strip - a range not starting at the first pixel
+ * walks the preceding pixels first, without rendering them
+ */
+void PacificaWaves::addLayer(const Layer &layer, CRGB *dest, const uint16_t lo, const uint16_t hi) {
+    uint16_t ci = layer.ciStart;
+    uint16_t waveAngle = layer.ioff;
+    const uint16_t waveScale_half = (layer.waveScale / 2) + 20;
+    for (uint16_t i = 0; i < lo; i++) {
+        waveAngle += 250;
+        const uint16_t s16 = sin16(waveAngle) + 32768;
+        ci += scale16(s16, waveScale_half) + waveScale_half;
+    }
+    for (uint16_t i = lo; i < hi; i++) {
         waveAngle += 250;
         const uint16_t s16 = sin16(waveAngle) + 32768;
         const uint16_t cs = scale16(s16, waveScale_half) + waveScale_half;
         ci += cs;
         const uint16_t sIndex16 = sin16(ci) + 32768;
         const uint8_t sIndex8 = scale16(sIndex16, 240);
-        const CRGB c = ColorFromPalette(p, sIndex8, bri, LINEARBLEND);
-        tpl[i] += c;
+        const CRGB c = layer.pal->color(sIndex8, layer.bri);
+        dest[i] += c;
     }
 }
 
 // Add extra 'white' to areas where the four layers of light have lined up brightly
-void FxI2::pacifica_add_whitecaps() {
-    const uint8_t baseThreshold = beatsin8(9, 55, 65);
-    uint8_t wave = beat8(7);
+void PacificaWaves::addWhitecaps(CRGB *dest, const uint16_t lo, const uint16_t hi) const {
+    uint8_t wave = capWave + 7 * lo;
 
-    for (uint16_t i = 0; i < tpl.size(); i++) {
-        const uint8_t threshold = scale8(sin8(wave), 20) + baseThreshold;
+    for (uint16_t i = lo; i < hi; i++) {
+        const uint8_t threshold = scale8(sin8(wave), 20) + capThreshold;
         wave += 7;
-        if (const uint8_t l = tpl[i].getAverageLight(); l > threshold) {
+        if (const uint8_t l = dest[i].getAverageLight(); l > threshold) {
             const uint8_t overage = l - threshold;
             const uint8_t overage2 = qadd8(overage, overage);
-            tpl[i] += CRGB(overage, overage2, qadd8(overage2, overage2));
+            dest[i] += CRGB(overage, overage2, qadd8(overage2, overage2));
         }
     }
 }
 
 // Deepen the blues and greens
-void FxI2::pacifica_deepen_colors() {
-    for (uint16_t i = 0; i < tpl.size(); i++) {
-        tpl[i].blue = scale8(tpl[i].blue, 145);
-        tpl[i].green = scale8(tpl[i].green, 200);
-        tpl[i] |= CRGB(2, 5, 7);
+void PacificaWaves::deepenColors(CRGB *dest, const uint16_t lo, const uint16_t hi) {
+    for (uint16_t i = lo; i < hi; i++) {
+        dest[i].blue = scale8(dest[i].blue, 145);
+        dest[i].green = scale8(dest[i].green, 200);
+        dest[i] |= CRGB(2, 5, 7);
     }
 }
 
@@ -273,15 +295,12 @@ void FxI2::pacifica_deepen_colors() {
  * Author: December 2019, Mark Kriegsman and Mary Corey March.
  */
 void FxI2::run() {
-    EVERY_N_MILLISECONDS_I(speed, 30) {
-        pacifica_loop();
+    FRAME_EVERY_N_MILLIS_I(speed, 30) {
+        waves.advance(millis());
+        renderSpans(0, tpl.size(), 160);   //the upper part of the span walks the lower part first - shifts the balance
         replicateSet(tpl, others);
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
     }
 }
 
-uint8_t FxI2::selectionWeight() const {
-    return 9;
-}
-
 //FXI3 - three segments running at different speeds & directions in sawtooth style (allows motion to look contiguous in segments)
@@ -8,7 +8,3 @@
 #include "fxJ.h"
 
 using namespace FxJ;
-
-void FxJ::fxRegister() {
-
-}
\ No newline at end of file
@@ -8,7 +8,3 @@
 #include "fxK.h"
 
 using namespace FxK;
-
-void FxK::fxRegister() {
-
-}
\ No newline at end of file
@@ -0,0 +1,54 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include "fx_arena.h"
+#include "log.h"
+
+ScratchArena fxArena;
+
+/**
+ * Carves a block out of the current end of the arena
+ * @param bytes block size
+ * @param align block alignment - power of 2, at most 8
+ * @return pointer to the block; nullptr if the arena does not have enough room left - the failure is logged
+ */
+void *ScratchArena::allocate(const size_t bytes, const size_t align) {
+    const size_t top = FX_ARENA_SIZE - used[1];
+    size_t start;
+    if (end == 0)
+        start = (used[0] + align - 1) & ~(align - 1);
+    else
+        start = bytes > top ? 0 : (top - bytes) & ~(align - 1);
+    if (start < used[0] || start + bytes > top) {
+        log_error(F("Scratch arena exhausted - %zu bytes requested, %zu bytes available"), bytes, available());
+        return nullptr;
+    }
+    if (end == 0)
+        used[0] = start + bytes;
+    else
+        used[1] = FX_ARENA_SIZE - start;
+    if (used[0] + used[1] > highWater)
+        highWater = used[0] + used[1];
+    return buf + start;
+}
+
+/**
+ * Releases all the blocks of the current end at once, but for the pinned ones - any pointer into the released blocks becomes invalid
+ * @return the number of bytes released
+ */
+size_t ScratchArena::reset() {
+    const size_t inUse = used[end] - base[end];
+    used[end] = base[end];
+    return inUse;
+}
+
+/**
+ * Releases all the blocks of the other end, pinned or not - the current end is left as the only one in use
+ * @return the number of bytes released
+ */
+size_t ScratchArena::releaseOther() {
+    const uint8_t other = end ^ 1;
+    const size_t inUse = used[other];
+    used[other] = base[other] = 0;
+    return inUse;
+}
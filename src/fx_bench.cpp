@@ -0,0 +1,668 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include "fx_bench.h"
+
+#if FX_BENCH_ENABLED == 1
+#ifndef USE_GET_MILLISECOND_TIMER
+#error "The effects benchmark requires USE_GET_MILLISECOND_TIMER build flag - FastLED timers must be driven by the bench clock"
+#endif
+
+#include "hardware/timer.h"
+#include "efx_setup.h"
+#include "transition.h"
+#include "util.h"
+#include "easing.h"
+#include "particles.h"
+#include "fire_sim.h"
+#include "fxI.h"
+#include "log.h"
+
+static bool benchActive = false;
+static uint32_t benchClock = 0;
+
+/**
+ * Millisecond time source for FastLED (see GET_MILLIS in lib8tion.h). While the benchmark is running, time is controlled
+ * by the benchmark itself - advanced one millisecond per state machine step; otherwise it is the regular <code>millis()</code>
+ * @return current time in milliseconds
+ */
+uint32_t get_millisecond_timer() {
+    return benchActive ? benchClock : millis();
+}
+
+/**
+ * Drives one effect through Setup, Running and WindDown states on the bench clock and collects timing statistics
+ * @param fx effect to benchmark
+ * @param res statistics holder
+ */
+static void benchEffect(LedEffect *fx, FxBenchResult &res) {
+    res = {};
+    fx->desiredState(Setup);
+    uint32_t start = time_us_32();
+    fx->loop();
+    res.setupUs = time_us_32() - start;
+
+    uint32_t hash = frameHash();
+    for (uint32_t t = 0; t < FX_BENCH_RUN_MS && fx->getState() == Running; ++t) {
+        benchClock++;
+        start = time_us_32();
+        fx->loop();
+        const uint32_t elapsed = time_us_32() - start;
+        if (const uint32_t newHash = frameHash(); newHash != hash) {
+            hash = newHash;
+            res.frames++;
+            res.frameUs += elapsed;
+        } else {
+            res.polls++;
+            res.pollUs += elapsed;
+        }
+        res.worstUs = max(res.worstUs, elapsed);
+        watchdogPing();
+    }
+
+    fx->desiredState(Idle);     //moves to WindDownPrep
+    for (uint32_t t = 0; t < FX_BENCH_WINDDOWN_MS && (fx->getState() == WindDownPrep || fx->getState() == WindDown); ++t) {
+        benchClock++;
+        start = time_us_32();
+        fx->loop();
+        const uint32_t elapsed = time_us_32() - start;
+        if (const uint32_t newHash = frameHash(); newHash != hash) {
+            hash = newHash;
+            res.windDownFrames++;
+        }
+        res.windDownWorstUs = max(res.windDownWorstUs, elapsed);
+        watchdogPing();
+    }
+    //skip the transition break - it is a timed pause with nothing rendered
+    fx->desiredState(Idle);
+    fx->desiredState(Idle);
+}
+
+/**
+ * Runs all the registered effects through the benchmark and logs the per-effect results: time per frame, time per pixel,
+ * worst case <code>run()</code> time. This is a blocking call - it is meant to run once, at FX task setup, in benchmark builds only.
+ * Effects that read <code>millis()</code> directly rather than through FastLED timers keep running on the real clock.
+ */
+void fxBenchmark() {
+    log_info(F("FX benchmark starting - %hu effects, %d pixels, %d ms running time per effect"), fxRegistry.size(), NUM_PIXELS, FX_BENCH_RUN_MS);
+    benchClock = millis();
+    benchActive = true;
+    transEffect.setup();
+    uint16_t overBudget = 0;
+    FxBenchResult res {};
+    for (uint16_t i = 0; i < fxRegistry.size(); ++i) {
+        const uint32_t heapBefore = rp2040.getUsedHeap();
+        LedEffect *fx = fxRegistry.getEffect(i);    //effects are instantiated when first needed - this is the first time
+        const uint32_t instanceBytes = rp2040.getUsedHeap() - heapBefore;
+        benchEffect(fx, res);
+        const uint32_t nsFrame = res.frames > 0 ? res.frameUs * 1000 / res.frames : 0;
+        const uint32_t nsPoll = res.polls > 0 ? res.pollUs * 1000 / res.polls : 0;
+        log_info(F("FX bench %s: %lu frames, %lu ns/frame, %lu ns/pixel, worst run %lu us, %lu ns/poll, setup %lu us, windDown %lu frames worst %lu us, instance %lu bytes"),
+                 fx->name(), res.frames, nsFrame, nsFrame / NUM_PIXELS, res.worstUs, nsPoll, res.setupUs, res.windDownFrames, res.windDownWorstUs, instanceBytes);
+        if (res.worstUs > FX_BENCH_FRAME_BUDGET_US) {
+            log_warn(F("FX bench %s: worst case run %lu us exceeds the frame budget of %d us"), fx->name(), res.worstUs, FX_BENCH_FRAME_BUDGET_US);
+            overBudget++;
+        }
+    }
+    benchActive = false;
+    clearStrip(true);
+    log_info(F("FX benchmark completed - %hu effects over the %d us frame budget at %d pixels"), overBudget, FX_BENCH_FRAME_BUDGET_US, NUM_PIXELS);
+    log_info(F("FX bench scratch arena peak %zu bytes of %zu"), fxArena.peak(), ScratchArena::capacity());
+    easeBenchmark();
+    paletteBenchmark();
+    kernelBenchmark();
+    selectionBenchmark();
+    particleBenchmark();
+    fireBenchmark();
+    transitionBenchmark();
+    litMapCheck();
+    renderBenchmark();
+}
+
+/**
+ * Float reference of ease out bounce - the implementation the fixed point easing replaced
+ */
+static uint16_t floatEaseOutBounce(const uint16_t x, const uint16_t lim) {
+    static constexpr float d1 = 2.75f;
+    static constexpr float n1 = 7.5625f;
+    const float xf = ((float)x)/(float)lim;
+    float res;
+    if (xf < 1/d1) {
+        res = n1*xf*xf;
+    } else if (xf < 2/d1) {
+        const float xf1 = xf - 1.5f/d1;
+        res = n1*xf1*xf1 + 0.75f;
+    } else if (xf < 2.5f/d1) {
+        const float xf1 = xf - 2.25f/d1;
+        res = n1*xf1*xf1 + 0.9375f;
+    } else {
+        const float xf1 = xf - 2.625f/d1;
+        res = n1*xf1*xf1 + 0.984375f;
+    }
+    return (uint16_t)(res * (float)lim);
+}
+
+/**
+ * Float reference of ease out quad - the implementation the fixed point easing replaced
+ */
+static uint16_t floatEaseOutQuad(const uint16_t x, const uint16_t lim) {
+    const auto limf = float(lim);
+    const float xf = float(x)/limf;
+    return uint16_t((1 - (1-xf)*(1-xf))*limf);
+}
+
+/**
+ * Times the evaluation of a range easing function over the [0, FX_BENCH_EASE_LIM] range
+ * @param fn easing function
+ * @param sum receives a checksum of the results, such that the calls are not optimized away
+ * @return nanoseconds per evaluation
+ */
+template<typename F> static uint32_t timeEase(F fn, volatile int32_t &sum) {
+    int32_t acc = 0;
+    const uint32_t start = time_us_32();
+    for (uint16_t x = 0; x <= FX_BENCH_EASE_LIM; x++)
+        acc += fn(x);
+    const uint32_t elapsed = time_us_32() - start;
+    sum = sum + acc;
+    return elapsed * 1000 / (FX_BENCH_EASE_LIM + 1);
+}
+
+/**
+ * Easing library benchmark - logs the time per evaluation for each curve and mode, and the accuracy and speed of the fixed point
+ * ease out quad and bounce against their former float implementations
+ */
+void easeBenchmark() {
+    static const char *curveNames[] = {"sine", "quad", "cubic", "quart", "quint", "expo", "circ", "back", "elastic", "bounce"};
+    volatile int32_t sum = 0;
+    for (uint8_t c = EaseSine; c <= EaseBounce; c++) {
+        const auto curve = static_cast<EaseCurve>(c);
+        const uint32_t nsIn = timeEase([curve](const uint16_t x) { return ease(curve, EaseIn, x, FX_BENCH_EASE_LIM); }, sum);
+        const uint32_t nsOut = timeEase([curve](const uint16_t x) { return ease(curve, EaseOut, x, FX_BENCH_EASE_LIM); }, sum);
+        const uint32_t nsInOut = timeEase([curve](const uint16_t x) { return ease(curve, EaseInOut, x, FX_BENCH_EASE_LIM); }, sum);
+        log_info(F("Ease bench %s: in %lu ns, out %lu ns, in-out %lu ns"), curveNames[c], nsIn, nsOut, nsInOut);
+    }
+    uint16_t maxDiffBounce = 0, maxDiffQuad = 0;
+    for (uint16_t x = 0; x <= FX_BENCH_EASE_LIM; x++) {
+        maxDiffBounce = max(maxDiffBounce, static_cast<uint16_t>(abs(ease(EaseBounce, EaseOut, x, FX_BENCH_EASE_LIM) - floatEaseOutBounce(x, FX_BENCH_EASE_LIM))));
+        maxDiffQuad = max(maxDiffQuad, static_cast<uint16_t>(abs(ease(EaseQuad, EaseOut, x, FX_BENCH_EASE_LIM) - floatEaseOutQuad(x, FX_BENCH_EASE_LIM))));
+    }
+    const uint32_t nsBounceF = timeEase([](const uint16_t x) { return floatEaseOutBounce(x, FX_BENCH_EASE_LIM); }, sum);
+    const uint32_t nsQuadF = timeEase([](const uint16_t x) { return floatEaseOutQuad(x, FX_BENCH_EASE_LIM); }, sum);
+    log_info(F("Ease bench float reference: out bounce %lu ns (max diff %hu), out quad %lu ns (max diff %hu) over [0, %d]"),
+             nsBounceF, maxDiffBounce, nsQuadF, maxDiffQuad, FX_BENCH_EASE_LIM);
+}
+
+/**
+ * Palette cache benchmark - one frame worth of palette lookups (one per pixel, the pattern of FxA and FxI2 render loops) through
+ * <code>ColorFromPalette</code> versus the palette cache, the cost of expanding the cache, and a check that the two agree on
+ * every index and brightness combination
+ */
+void paletteBenchmark() {
+    PaletteCache cache;
+    uint32_t start = time_us_32();
+    cache.expand(palette);
+    const uint32_t expandUs = time_us_32() - start;
+
+    uint32_t mismatches = 0;
+    for (uint16_t idx = 0; idx < 256; idx++)
+        for (uint16_t bri = 0; bri < 256; bri++)
+            if (cache.color(idx, bri) != ColorFromPalette(palette, idx, bri, LINEARBLEND))
+                mismatches++;
+
+    uint32_t acc = 0;
+    start = time_us_32();
+    for (uint16_t i = 0; i < NUM_PIXELS; i++) {
+        const CRGB c = ColorFromPalette(palette, i * 7, 128 + (i & 0x7F), LINEARBLEND);
+        acc += c.r + c.g + c.b;
+    }
+    const uint32_t directUs = time_us_32() - start;
+    start = time_us_32();
+    for (uint16_t i = 0; i < NUM_PIXELS; i++) {
+        const CRGB c = cache.color(i * 7, 128 + (i & 0x7F));
+        acc += c.r + c.g + c.b;
+    }
+    const uint32_t cachedUs = time_us_32() - start;
+    log_info(F("Palette bench: %d lookups per frame - ColorFromPalette %lu us, palette cache %lu us, saving %ld us/frame; cache expansion %lu us, %lu mismatches (checksum %lu)"),
+             NUM_PIXELS, directUs, cachedUs, static_cast<int32_t>(directUs - cachedUs), expandUs, mismatches, acc);
+}
+
+/**
+ * Pixel kernels benchmark - scale, fade and blend (solid color and pixel set) over the whole strip, FastLED's per pixel calls versus the
+ * packed kernels behind <code>scaleSet</code>, <code>fadeSet</code> and <code>blendSet</code>. Both run on copies of the same random
+ * frame with the same random amount, and must come out identical - the host test (test/test_pixel_kernels) covers every amount and
+ * alignment against the transcribed formulas, this checks against the FastLED build actually linked.
+ */
+void kernelBenchmark() {
+    static CRGB ref[NUM_PIXELS];
+    static CRGB overlay[NUM_PIXELS];
+    static const char *const kernelNames[] = {"scale", "fade", "blend color", "blend set"};
+    CRGBSet strip(leds, NUM_PIXELS);
+    const CRGBSet overlaySet(overlay, NUM_PIXELS);
+    for (uint8_t k = 0; k < 4; k++) {
+        uint32_t refUs = 0, packedUs = 0, mismatches = 0;
+        for (uint16_t f = 0; f < FX_BENCH_KERNEL_FRAMES; f++) {
+            for (uint16_t i = 0; i < NUM_PIXELS; i++) {
+                leds[i] = CRGB(random8(), random8(), random8());
+                overlay[i] = CRGB(random8(), random8(), random8());
+            }
+            memcpy(ref, leds, sizeof(ref));
+            const CRGB color = overlay[0];
+            const uint8_t amount = random8();
+            uint32_t start = time_us_32();
+            for (uint16_t i = 0; i < NUM_PIXELS; i++) {
+                switch (k) {
+                    case 0: ref[i].nscale8(amount); break;
+                    case 1: ref[i].fadeToBlackBy(amount); break;
+                    case 2: nblend(ref[i], color, amount); break;
+                    default: nblend(ref[i], overlay[i], amount); break;
+                }
+            }
+            refUs += time_us_32() - start;
+            start = time_us_32();
+            switch (k) {
+                case 0: scaleSet(strip, amount); break;
+                case 1: fadeSet(strip, amount); break;
+                case 2: blendSet(strip, color, amount); break;
+                default: blendSet(strip, overlaySet, amount); break;
+            }
+            packedUs += time_us_32() - start;
+            if (memcmp(ref, leds, sizeof(ref)) != 0)
+                mismatches++;
+        }
+        log_info(F("Kernel bench %s: %d pixels - FastLED per pixel %lu us/frame, packed kernel %lu us/frame; %lu of %d frames differ"),
+                 kernelNames[k], NUM_PIXELS, refUs / FX_BENCH_KERNEL_FRAMES, packedUs / FX_BENCH_KERNEL_FRAMES, mismatches, FX_BENCH_KERNEL_FRAMES);
+    }
+    clearStrip(true);
+}
+
+/**
+ * Reference weighted selection - linear walk over all effects, reading each effect's weight twice per selection;
+ * the implementation the alias table replaced
+ * @return index of the selected effect
+ */
+static uint16_t linearRandomEffectIndex() {
+    uint16_t totalSelectionWeight = 0;
+    for (uint16_t i = 0; i < fxRegistry.size(); ++i)
+        totalSelectionWeight += fxRegistry.selectionWeight(i);
+    uint16_t rnd = random16(0, totalSelectionWeight);
+    for (uint16_t i = 0; i < fxRegistry.size(); ++i) {
+        rnd = qsuba(rnd, fxRegistry.selectionWeight(i));
+        if (rnd == 0)
+            return i;
+    }
+    return 0;
+}
+
+/**
+ * Times the weighted random effect selection - linear walk versus alias table - and checks the alias table draws against the
+ * effect weights: the worst deviation between an effect's observed and expected share is reported in permille
+ */
+void selectionBenchmark() {
+    uint32_t acc = 0;
+    uint32_t start = time_us_32();
+    for (uint16_t i = 0; i < FX_BENCH_SELECTIONS; i++)
+        acc += linearRandomEffectIndex();
+    const uint32_t linearUs = time_us_32() - start;
+
+    fxRegistry.invalidateSelection();
+    start = time_us_32();
+    acc += fxRegistry.randomEffectIndex();
+    const uint32_t buildUs = time_us_32() - start;
+
+    const uint16_t count = fxRegistry.size();
+    std::vector<uint16_t> hits(count);
+    start = time_us_32();
+    for (uint16_t i = 0; i < FX_BENCH_SELECTIONS; i++)
+        hits[fxRegistry.randomEffectIndex()]++;
+    const uint32_t aliasUs = time_us_32() - start;
+
+    uint32_t totalWeight = 0;
+    for (uint16_t i = 0; i < count; i++)
+        totalWeight += fxRegistry.selectionWeight(i);
+    int32_t worstDev = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        const int32_t observed = hits[i] * 1000 / FX_BENCH_SELECTIONS;
+        const int32_t expected = fxRegistry.selectionWeight(i) * 1000 / totalWeight;
+        worstDev = max(worstDev, abs(observed - expected));
+    }
+    log_info(F("Selection bench: %d selections over %hu effects - linear walk %lu us, alias table %lu us (rebuild %lu us); worst share deviation %ld permille (checksum %lu)"),
+             FX_BENCH_SELECTIONS, count, linearUs, aliasUs, buildUs, worstDev, acc);
+}
+
+/**
+ * Float array-of-structures particle - the representation the particle pool replaced
+ */
+struct FloatParticle {
+    float pos;
+    float velocity;
+    uint8_t hue;
+};
+
+/**
+ * Times the kinematic step of the particles - float array of structures against the fixed point particle pool. The pool bookkeeping
+ * and the FxF5 explosion kinematics are checked on the host, see test/test_particles
+ */
+void particleBenchmark() {
+    static FloatParticle floatParticles[FX_BENCH_PARTICLES];
+    constexpr float gravity = -.004f;
+    for (auto &p : floatParticles) {
+        p.pos = random8(NUM_PIXELS >> 2);
+        p.velocity = (static_cast<float>(random16(0, 20000)) / 10000.0f) - 1.0f;
+    }
+    uint32_t start = time_us_32();
+    for (uint16_t s = 0; s < FX_BENCH_PARTICLE_STEPS; s++)
+        for (auto &p : floatParticles) {
+            p.pos = constrain(p.pos + p.velocity, 0, NUM_PIXELS - 1);
+            p.velocity += gravity;
+        }
+    const uint32_t floatUs = time_us_32() - start;
+
+    fxArena.reset();
+    ParticlePool pool;
+    if (!pool.begin(FX_BENCH_PARTICLES)) {
+        log_warn(F("Particle bench: %d particles do not fit the scratch arena"), FX_BENCH_PARTICLES);
+        return;
+    }
+    for (uint16_t i = 0; i < FX_BENCH_PARTICLES; i++) {
+        const int16_t x = pool.spawn();
+        pool.pos[x] = ParticlePool::toFixed(static_cast<int16_t>(floatParticles[i].pos));
+        pool.vel[x] = static_cast<ParticlePool::fixed>(random16(0, 20000)) * 65536 / 10000 - 65536;
+    }
+    start = time_us_32();
+    for (uint16_t s = 0; s < FX_BENCH_PARTICLE_STEPS; s++)
+        pool.move(-262, 0, ParticlePool::toFixed(NUM_PIXELS - 1));
+    const uint32_t poolUs = time_us_32() - start;
+    const size_t arenaBytes = fxArena.reset();
+
+    constexpr uint32_t updates = static_cast<uint32_t>(FX_BENCH_PARTICLES) * FX_BENCH_PARTICLE_STEPS;
+    log_info(F("Particle bench: %d particles x %d steps - float structures %lu ns/particle, fixed point pool %lu ns/particle; pool uses %zu arena bytes"),
+             FX_BENCH_PARTICLES, FX_BENCH_PARTICLE_STEPS, floatUs * 1000 / updates, poolUs * 1000 / updates, arenaBytes);
+}
+
+static constexpr uint8_t benchCooling = 75;         // FxH1 fire parameters
+static constexpr uint8_t benchSparking = 150;
+static constexpr uint8_t benchFlameBrightness = 216;
+
+/**
+ * Reference Fire2012 frame for one fire - the heat map interleaved as color channels, random8 drawn per cell and the palette
+ * interpolated per pixel; the implementation the fire simulation replaced
+ * @param fire fire segment
+ * @param hMap heat map shared by up to 3 fires, one color channel each
+ * @param xFire fire index - the color channel of the heat map
+ */
+static void referenceFire(CRGBSet &fire, CRGB *hMap, const uint8_t xFire) {
+    for (uint16_t i = 0; i < fire.size(); i++)
+        hMap[i][xFire] = qsub8(hMap[i][xFire], random8(0, ((benchCooling * 10) / fire.size()) + 2));
+    for (uint16_t k = fire.size() - 1; k >= 2; k--)
+        hMap[k][xFire] = (hMap[k - 1][xFire] + hMap[k - 2][xFire] + hMap[k - 2][xFire]) / 3;
+    if (random8() < benchSparking) {
+        const uint8_t y = random8(7);
+        hMap[y][xFire] = qadd8(hMap[y][xFire], random8(160, 255));
+    }
+    for (uint16_t j = 0; j < fire.size(); j++) {
+        fire[j] = ColorFromPalette(palette, scale8(hMap[j][xFire], 240));
+        if (j > random8(5, 9))
+            fire[j].nscale8(benchFlameBrightness);
+    }
+}
+
+/**
+ * FNV-1a hash of the LED buffer, chained
+ * @param hash hash so far
+ * @return hash including the current LED buffer
+ */
+static uint32_t ledsChecksum(uint32_t hash) {
+    const auto *p = reinterpret_cast<const uint8_t *>(leds);
+    for (uint16_t i = 0; i < NUM_PIXELS * sizeof(CRGB); i++)
+        hash = (hash ^ p[i]) * 16777619u;
+    return hash;
+}
+
+/**
+ * Times the fire simulation against the reference implementation over the whole strip - 3 fires, as many as the reference heat map
+ * can hold, one of them reversed. Both run from the same random seed; every frame must hash the same. This is the equivalence check
+ * of the fire simulation - the frames that differ and the first one are reported.
+ */
+void fireBenchmark() {
+    constexpr uint16_t segLen = NUM_PIXELS / 3;
+    static CRGB refMap[segLen];
+    static uint32_t refFrames[FX_BENCH_FIRE_FRAMES];
+    CRGBSet fires[] = {ledSet(0, segLen-1), ledSet(2*segLen-1, segLen), ledSet(2*segLen, 3*segLen-1)};
+    syncPaletteCaches();
+    const uint16_t seed = random16_get_seed();
+
+    uint32_t refHash = 2166136261u, refUs = 0;
+    for (uint16_t f = 0; f < FX_BENCH_FIRE_FRAMES; f++) {
+        const uint32_t start = time_us_32();
+        for (uint8_t x = 0; x < 3; x++)
+            referenceFire(fires[x], refMap, x);
+        refUs += time_us_32() - start;
+        refHash = ledsChecksum(refHash);
+        refFrames[f] = ledsChecksum(2166136261u);
+    }
+
+    fxArena.reset();
+    FireSim sim;
+    if (!sim.begin(fires, 3, benchCooling, benchSparking)) {
+        log_warn(F("Fire bench: %d pixels of heat cells do not fit the scratch arena"), NUM_PIXELS);
+        return;
+    }
+    random16_set_seed(seed);
+    uint32_t simHash = 2166136261u, simUs = 0, differ = 0;
+    int16_t firstDiff = -1;
+    for (uint16_t f = 0; f < FX_BENCH_FIRE_FRAMES; f++) {
+        const uint32_t start = time_us_32();
+        sim.update(paletteCache, benchFlameBrightness);
+        simUs += time_us_32() - start;
+        simHash = ledsChecksum(simHash);
+        if (ledsChecksum(2166136261u) != refFrames[f]) {
+            differ++;
+            if (firstDiff < 0)
+                firstDiff = static_cast<int16_t>(f);
+        }
+    }
+    fxArena.reset();
+
+    log_info(F("Fire bench: 3 fires over %d pixels, %d frames - reference %lu us/frame, fire simulation %lu us/frame; frames %s"),
+             3*segLen, FX_BENCH_FIRE_FRAMES, refUs / FX_BENCH_FIRE_FRAMES, simUs / FX_BENCH_FIRE_FRAMES, refHash == simHash ? "identical" : "DIFFERENT");
+    if (differ > 0)
+        log_warn(F("Fire check: %lu of %d frames differ from the reference Fire2012, first at frame %d"), differ, FX_BENCH_FIRE_FRAMES, firstDiff);
+}
+
+/**
+ * Times the "is any pixel still lit" check of each transition type - full strip scan versus the lit map - at every step of turning off
+ * a strip of random colors, on the bench clock. Both checks must agree at every step.
+ */
+void transitionBenchmark() {
+    benchClock = millis();
+    benchActive = true;
+    for (uint8_t type = 0; type < 6; type++) {
+        for (auto &led : leds)
+            led = CRGB(random8(), random8(), random8());
+        transEffect.prepare(type*2);
+        uint32_t scanUs = 0, mapUs = 0, steps = 0, mismatches = 0;
+        bool done = false;
+        for (uint32_t t = 0; t < FX_BENCH_WINDDOWN_MS && !done; ++t) {
+            benchClock++;
+            done = transEffect.transition();
+            uint32_t start = time_us_32();
+            const bool scanLit = isAnyLedOn(leds, topology.logicalSize(), BKG);
+            scanUs += time_us_32() - start;
+            start = time_us_32();
+            const bool mapLit = litMap.anyBrighter(BKG.getLuma());
+            mapUs += time_us_32() - start;
+            if (scanLit != mapLit)
+                mismatches++;
+            steps++;
+            watchdogPing();
+        }
+        log_info(F("Transition bench %s: %lu steps %s, lit check full scan %lu us, lit map %lu us, %lu mismatches"),
+                 EffectTransition::typeName(type), steps, done ? "completed" : "timed out", scanUs, mapUs, mismatches);
+    }
+    benchActive = false;
+    clearStrip(true);
+}
+
+/**
+ * Number of logical pixels brighter than the luma given - full scan, the reference for the lit map
+ * @param luma luma threshold
+ * @return number of pixels with a luma above the threshold
+ */
+static uint16_t scanBrighter(const uint8_t luma) {
+    uint16_t count = 0;
+    for (uint16_t i = 0; i < topology.logicalSize(); i++)
+        count += leds[i].getLuma() > luma;
+    return count;
+}
+
+/**
+ * Lit map bounds check - random strips taken down by random writes of the kinds the lit map is kept valid through: fades, blends
+ * towards black, pixels turned off, whole and half strip shifts (notified through <code>shifted</code>). After each step both queries
+ * are checked at random thresholds against full scans; any disagreement means a bound went below the pixels it covers.
+ */
+void litMapCheck() {
+    const uint16_t numPixels = topology.logicalSize();      //the lit map summarizes the logical pixels only
+    CRGBSet strip(leds, numPixels);
+    CRGBSet lowHalf(leds, numPixels / 2);
+    CRGBSet highHalf(leds, numPixels / 2, numPixels - 1);
+    uint32_t queries = 0, mismatches = 0;
+    for (uint32_t step = 0; step < FX_BENCH_LITMAP_STEPS; step++) {
+        if (step % 200 == 0) {
+            for (auto &led : leds)
+                led = random8() < 64 ? CRGB(random8(), random8(), random8()) : CRGB::Black;
+            litMap.invalidate();
+        }
+        switch (random8(6)) {
+            case 0: fadeSet(strip, random8(1, 64)); break;
+            case 1: blendSet(strip, CRGB::Black, random8(1, 64)); break;
+            case 2: leds[random16(numPixels)] = CRGB::Black; break;
+            case 3: {
+                const bool right = random8() & 0x01;
+                if (right)
+                    shiftRight(strip, BKG);
+                else
+                    shiftLeft(strip, BKG);
+                litMap.shifted(0, numPixels - 1, right ? 1 : -1);
+                break;
+            }
+            case 4: {
+                //half wipe, inward or outward
+                const bool inward = random8() & 0x01;
+                if (inward) {
+                    shiftRight(lowHalf, BKG);
+                    shiftLeft(highHalf, BKG);
+                } else {
+                    shiftLeft(lowHalf, BKG);
+                    shiftRight(highHalf, BKG);
+                }
+                litMap.shifted(0, numPixels / 2 - 1, inward ? 1 : -1);
+                litMap.shifted(numPixels / 2, numPixels - 1, inward ? -1 : 1);
+                break;
+            }
+            default: break;
+        }
+        for (uint8_t q = 0; q < 3; q++) {
+            const uint8_t luma = q == 0 ? 0 : random8();
+            const uint16_t expected = scanBrighter(luma);
+            if (litMap.anyBrighter(luma) != (expected > 0) || litMap.countBrighter(luma) != expected)
+                mismatches++;
+            queries++;
+        }
+        if (step % 1000 == 0)
+            watchdogPing();
+    }
+    clearStrip(true);
+    log_info(F("Lit map check: %d steps, %lu queries against full scans - %lu mismatches"), FX_BENCH_LITMAP_STEPS, queries, mismatches);
+}
+
+/**
+ * Kernel context of the rendering benchmark
+ */
+struct RenderBenchCtx {
+    FxI::PacificaWaves *waves;
+    FireSim *fire;
+};
+
+/**
+ * Renders the benchmark frames of Pacifica (FxI2) and Fire (FxH1 simulation, 3 fires) over the whole strip, timing them
+ * @param ctx kernel context
+ * @param pacificaHash hash of all Pacifica frames
+ * @param fireHash hash of all Fire frames
+ * @return rendering time of Pacifica (first) and Fire (second) frames in microseconds
+ */
+static std::pair<uint32_t, uint32_t> renderBenchFrames(RenderBenchCtx &ctx, uint32_t &pacificaHash, uint32_t &fireHash) {
+    const uint32_t clockStart = benchClock;
+    ctx.waves->begin();
+    uint32_t pacificaUs = 0;
+    for (uint16_t f = 0; f < FX_BENCH_RENDER_FRAMES; f++) {
+        benchClock += 30;
+        const uint32_t start = time_us_32();
+        ctx.waves->advance(benchClock);
+        spanRender.render([](void *c, const uint16_t lo, const uint16_t hi) {
+            static_cast<RenderBenchCtx *>(c)->waves->render(leds, lo, hi);
+        }, &ctx, 0, NUM_PIXELS, 160);
+        pacificaUs += time_us_32() - start;
+        pacificaHash = ledsChecksum(pacificaHash);
+        watchdogPing();
+    }
+    benchClock = clockStart;
+
+    uint32_t fireUs = 0;
+    for (uint16_t f = 0; f < FX_BENCH_RENDER_FRAMES; f++) {
+        const uint32_t start = time_us_32();
+        ctx.fire->advance();
+        spanRender.render([](void *c, const uint16_t lo, const uint16_t hi) {
+            static_cast<RenderBenchCtx *>(c)->fire->renderCells(paletteCache, benchFlameBrightness, lo, hi);
+        }, &ctx, 0, ctx.fire->cells());
+        fireUs += time_us_32() - start;
+        fireHash = ledsChecksum(fireHash);
+        watchdogPing();
+    }
+    return {pacificaUs, fireUs};
+}
+
+/**
+ * Times Pacifica and Fire rendering over the whole strip on the FX core alone versus split across both cores through the span
+ * renderer. Both modes render the same frames - from the same bench clock and random seed; the frame hashes must match.
+ */
+void renderBenchmark() {
+    if (!spanRender.isParallel()) {
+        log_warn(F("Render bench: the Render task is not attached - dual core rendering not available"));
+        return;
+    }
+    static FxI::PacificaWaves waves;
+    constexpr uint16_t segLen = NUM_PIXELS / 3;
+    CRGBSet fires[] = {ledSet(0, segLen-1), ledSet(2*segLen-1, segLen), ledSet(2*segLen, 3*segLen-1)};
+    FireSim sim;
+    RenderBenchCtx ctx {&waves, &sim};
+    syncPaletteCaches();
+    benchClock = millis();
+    benchActive = true;
+    const uint16_t seed = random16_get_seed();
+
+    uint32_t pacificaHash[2] {2166136261u, 2166136261u}, fireHash[2] {2166136261u, 2166136261u};
+    std::pair<uint32_t, uint32_t> us[2];
+    for (uint8_t mode = 0; mode < 2; mode++) {
+        spanRender.enable(mode == 1);
+        random16_set_seed(seed);
+        fxArena.reset();        //both modes start from cold fires
+        if (!sim.begin(fires, 3, benchCooling, benchSparking)) {
+            log_warn(F("Render bench: %d pixels of fire cells do not fit the scratch arena"), NUM_PIXELS);
+            spanRender.enable(true);
+            benchActive = false;
+            return;
+        }
+        us[mode] = renderBenchFrames(ctx, pacificaHash[mode], fireHash[mode]);
+    }
+    fxArena.reset();
+    spanRender.enable(true);
+    benchActive = false;
+    clearStrip(true);
+
+    log_info(F("Render bench: Pacifica over %d pixels - single core %lu us/frame, dual core %lu us/frame; frames %s"), NUM_PIXELS,
+             us[0].first / FX_BENCH_RENDER_FRAMES, us[1].first / FX_BENCH_RENDER_FRAMES, pacificaHash[0] == pacificaHash[1] ? "identical" : "DIFFERENT");
+    log_info(F("Render bench: Fire over %d pixels - single core %lu us/frame, dual core %lu us/frame; frames %s"), 3*segLen,
+             us[0].second / FX_BENCH_RENDER_FRAMES, us[1].second / FX_BENCH_RENDER_FRAMES, fireHash[0] == fireHash[1] ? "identical" : "DIFFERENT");
+}
+
+#endif
@@ -0,0 +1,115 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include "fx_catalog.h"
+#include "fxA.h"
+#include "fxB.h"
+#include "fxC.h"
+#include "fxD.h"
+#include "fxE.h"
+#include "fxF.h"
+#include "fxH.h"
+#include "fxI.h"
+
+/**
+ * The effects catalog - the position in the catalog is the effect's registry index, which is persisted in the saved state and
+ * shared with the broadcast recipients - existing entries must keep their position.
+ * <p>Columns: id, description, factory, selection weight, selection weight during Halloween, flags</p>
+ */
+constexpr EffectDesc effectCatalog[] = {
+    {"FXA1", "FXA1: Multiple Tetris segments", makeEffect<FxA::FxA1>, 3, 3, FxFlagNone},
+    {"FXA2", "FXA2: Randomly sized and spaced segments moving on entire strip", makeEffect<FxA::FxA2>, 10, 10, FxFlagNone},
+    {"FXA3", "FXA3: Moving variable dot size back and forth", makeEffect<FxA::FxA3>, 20, 20, FxFlagNone},
+    {"FXA4", "FXA4: pixel segments moving opposite directions", makeEffect<FxA::FxA4>, 20, 20, FxFlagNone},
+    {"FXA5", "FXA5: Moving a color swath on top of another", makeEffect<FxA::FxA5>, 20, 20, FxFlagNone},
+    {"FXA6", "FXA6: Sleep Light", makeEffect<FxA::SleepLight>, 0, 0, FxFlagSleep},
+
+    {"FXB1", "FXB1: rainbow", makeEffect<FxB::FxB1>, 15, 15, FxFlagNone},
+    {"FXB2", "FXB2: rainbow with glitter", makeEffect<FxB::FxB2>, 40, 40, FxFlagNone},
+    {"FXB3", "FXB3: confetti B", makeEffect<FxB::FxB3>, 24, 24, FxFlagNone},
+    {"FXB4", "FXB4: sinelon", makeEffect<FxB::FxB4>, 20, 20, FxFlagNone},
+    {"FXB5", "FXB5: juggle short segments", makeEffect<FxB::FxB5>, 30, 30, FxFlagNone},
+    {"FXB6", "FXB6: bpm", makeEffect<FxB::FxB6>, 20, 20, FxFlagNone},
+    {"FXB7", "FXB7: ease", makeEffect<FxB::FxB7>, 10, 10, FxFlagNone},
+    {"FXB8", "FXB8: fadein", makeEffect<FxB::FxB8>, 15, 15, FxFlagNone},
+    {"FXB9", "FXB9: juggle long segments", makeEffect<FxB::FxB9>, 14, 14, FxFlagNone},
+
+    {"FXC1", "FXC1: blend between two concurrent animations", makeEffect<FxC::FxC1>, 35, 35, FxFlagNone},
+    {"FXC2", "FXC2: blur function", makeEffect<FxC::FxC2>, 5, 5, FxFlagNone},
+    {"FXC3", "FXC3: Perlin Noise for moving up and down the strand", makeEffect<FxC::FxC3>, 4, 4, FxFlagNone},
+    {"FxC4", "FxC4: lightnings", makeEffect<FxC::FxC4>, 2, 20, FxFlagBlocking},
+    {"FXC5", "FXC5: matrix", makeEffect<FxC::FxC5>, 20, 20, FxFlagNone},
+    {"FXC6", "FXC6: one sine", makeEffect<FxC::FxC6>, 20, 20, FxFlagNone},
+
+    {"FXD1", "FXD1: Confetti D", makeEffect<FxD::FxD1>, 21, 21, FxFlagNone},
+    {"FXD2", "FXD2: dot beat", makeEffect<FxD::FxD2>, 20, 20, FxFlagNone},
+    {"FXD3", "FXD3: plasma", makeEffect<FxD::FxD3>, 24, 24, FxFlagNone},
+    {"FXD4", "FXD4: rainbow marching", makeEffect<FxD::FxD4>, 18, 18, FxFlagNone},
+    {"FXD5", "FXD5: ripples", makeEffect<FxD::FxD5>, 42, 42, FxFlagArena},
+
+    {"FXE1", "FXE1: twinkle", makeEffect<FxE::FxE1>, 22, 22, FxFlagNone},
+    {"FXE2", "FXE2: beat wave", makeEffect<FxE::FxE2>, 17, 17, FxFlagNone},
+    {"FXE3", "FXE3: sawtooth back/forth", makeEffect<FxE::FxE3>, 27, 27, FxFlagNone},
+    {"FXE4", "FXE4: serendipitous", makeEffect<FxE::FxE4>, 36, 36, FxFlagNone},
+    {"FXE5", "FXE5: three single color beat-waves", makeEffect<FxE::FxE5>, 42, 42, FxFlagNone},
+
+    {"FXF1", "FXF1: beat wave", makeEffect<FxF::FxF1>, 12, 12, FxFlagNone},
+    {"FXF2", "FXF2: Halloween breathe with various color blends", makeEffect<FxF::FxF2>, 24, 42, FxFlagNone},
+    {"FXF3", "FXF3: Eye Blink", makeEffect<FxF::FxF3>, 24, 42, FxFlagArena},
+    {"FXF4", "FXF4: Bouncy segments", makeEffect<FxF::FxF4>, 42, 12, FxFlagNone},
+    {"FXF5", "FXF5: Fireworks", makeEffect<FxF::FxF5>, 64, 10, FxFlagArena | FxFlagBlocking},
+
+    {"FXH1", "FXH1: Fire segments", makeEffect<FxH::FxH1>, 32, 64, FxFlagArena},
+    {"FXH2", "FXH2: confetti H", makeEffect<FxH::FxH2>, 24, 24, FxFlagNone},
+    {"FXH3", "FXH3: filling the strand with colours", makeEffect<FxH::FxH3>, 18, 18, FxFlagNone},
+    {"FXH4", "FXH4: TwinkleFox", makeEffect<FxH::FxH4>, 12, 12, FxFlagNone},
+    {"FXH5", "FXH5: RainbowSparkle", makeEffect<FxH::FxH5>, 5, 5, FxFlagNone},
+    {"FXH6", "FXH6: JustSparkle", makeEffect<FxH::FxH6>, 5, 5, FxFlagArena},
+
+    {"FXI1", "FXI1: Ping Pong", makeEffect<FxI::FxI1>, 7, 7, FxFlagNone},
+    {"FXI2", "FXI2: Pacifica - gentle ocean waves", makeEffect<FxI::FxI2>, 9, 9, FxFlagNone},
+    //{"FXI3", "FXI3: Three overlay segments", makeEffect<FxI::FxI3>, 1, 1, FxFlagNone},
+};
+constexpr uint16_t effectCatalogSize = arrSize(effectCatalog);
+
+/**
+ * Position of each category's first effect in the catalog (category letter A-Z), computed at compile time
+ */
+struct CategoryIndex {
+    uint16_t start[26];
+};
+
+static constexpr CategoryIndex buildCategoryIndex() {
+    CategoryIndex ci {};
+    for (auto &s : ci.start)
+        s = FX_NOT_FOUND;
+    for (uint16_t i = effectCatalogSize; i-- > 0;) {
+        const char c = static_cast<char>(effectCatalog[i].id[2] & ~0x20);     //upper case
+        if (c >= 'A' && c <= 'Z')
+            ci.start[c - 'A'] = i;
+    }
+    return ci;
+}
+
+static constexpr CategoryIndex categoryIndex = buildCategoryIndex();
+
+/**
+ * Catalog index of an effect - O(1) for ids following the catalog convention (category letter, effect number in category order)
+ * @param id effect id, e.g. FXA6
+ * @return the catalog index; FX_NOT_FOUND if there is no such effect
+ */
+uint16_t fxCatalogIndex(const char *id) {
+    if (strlen(id) > 3) {
+        const char c = static_cast<char>(id[2] & ~0x20);
+        const int n = atoi(id + 3);
+        if (c >= 'A' && c <= 'Z' && n > 0 && categoryIndex.start[c - 'A'] != FX_NOT_FOUND) {
+            if (const uint16_t idx = categoryIndex.start[c - 'A'] + n - 1; idx < effectCatalogSize && strcmp(id, effectCatalog[idx].id) == 0)
+                return idx;
+        }
+    }
+    //ids out of the convention
+    for (uint16_t i = 0; i < effectCatalogSize; ++i)
+        if (strcmp(id, effectCatalog[i].id) == 0)
+            return i;
+    return FX_NOT_FOUND;
+}
@@ -0,0 +1,54 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include "fx_context.h"
+#include "efx_setup.h"
+
+/**
+ * Saves the effect state held in the globals into this context
+ */
+void FxContext::save() {
+    memcpy(side, &::frame[0], sizeof(side));
+    palette = ::palette;
+    targetPalette = ::targetPalette;
+    mode = ::mode;
+    brightness = ::brightness;
+    colorIndex = ::colorIndex;
+    lastColorIndex = ::lastColorIndex;
+    fade = ::fade;
+    hue = ::hue;
+    delta = ::delta;
+    saturation = ::saturation;
+    dotBpm = ::dotBpm;
+    hueDiff = ::hueDiff;
+    speed = ::speed;
+    curPos = ::curPos;
+    dist = ::dist;
+    dirFwd = ::dirFwd;
+    mapping = outputMap.mapping();
+}
+
+/**
+ * Restores the effect state saved in this context into the globals - the palette caches are expanded again by the next running step,
+ * if the palettes differ
+ */
+void FxContext::restore() const {
+    memcpy(&::frame[0], side, sizeof(side));
+    ::palette = palette;
+    ::targetPalette = targetPalette;
+    ::mode = mode;
+    ::brightness = brightness;
+    ::colorIndex = colorIndex;
+    ::lastColorIndex = lastColorIndex;
+    ::fade = fade;
+    ::hue = hue;
+    ::delta = delta;
+    ::saturation = saturation;
+    ::dotBpm = dotBpm;
+    ::hueDiff = hueDiff;
+    ::speed = speed;
+    ::curPos = curPos;
+    ::dist = dist;
+    ::dirFwd = dirFwd;
+    outputMap.restore(mapping);
+}
@@ -0,0 +1,245 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include <algorithm>
+#include "fx_stats.h"
+#include "efx_setup.h"
+#include "transition.h"
+
+FxTimingStats fxTiming;
+
+// TimeHistogram
+/**
+ * Computes the bucket index for a duration - values under 4us have their own bucket, above that each power of two
+ * range is split in 4 equal sub-ranges
+ * @param us duration in microseconds
+ * @return bucket index
+ */
+uint8_t TimeHistogram::bucket(const uint32_t us) {
+    if (us < 4)
+        return us;
+    const uint8_t msb = 31 - __builtin_clz(us);
+    const uint16_t idx = (msb - 1) * 4 + ((us >> (msb - 2)) & 0x03);
+    return idx < TIME_HIST_BUCKETS ? idx : TIME_HIST_BUCKETS - 1;
+}
+
+/**
+ * Representative value of a bucket - the middle of its range
+ * @param idx bucket index
+ * @return the duration in microseconds the bucket stands for
+ */
+uint32_t TimeHistogram::bucketValue(const uint8_t idx) {
+    if (idx < 4)
+        return idx;
+    const uint8_t shift = idx / 4 - 1;
+    const uint32_t low = (4 + idx % 4) << shift;
+    return low + ((1 << shift) >> 1);
+}
+
+void TimeHistogram::add(const uint32_t us) {
+    if (count >= TIME_HIST_ROLL) {
+        count = 0;
+        for (auto &b : buckets) {
+            b >>= 1;
+            count += b;
+        }
+    }
+    buckets[bucket(us)]++;
+    count++;
+    total++;
+    maxUs = max(maxUs, us);
+}
+
+/**
+ * Estimates the percentile from the histogram buckets
+ * @param pct percentile to compute, 1-100
+ * @return estimated duration in microseconds at the percentile requested; 0 if there are no samples
+ */
+uint32_t TimeHistogram::percentile(const uint8_t pct) const {
+    if (count == 0)
+        return 0;
+    const uint32_t target = (static_cast<uint32_t>(count) * pct + 99) / 100;
+    uint32_t cumulative = 0;
+    for (uint8_t i = 0; i < TIME_HIST_BUCKETS; i++) {
+        cumulative += buckets[i];
+        if (cumulative >= target)
+            return min(bucketValue(i), maxUs);
+    }
+    return maxUs;
+}
+
+void TimeHistogram::reset() {
+    memset(buckets, 0, sizeof(buckets));
+    count = 0;
+    maxUs = 0;
+    total = 0;
+}
+
+void TimeHistogram::toJson(const JsonObject &json) const {
+    json["count"] = total;
+    json["p50"] = percentile(50);
+    json["p99"] = percentile(99);
+    json["max"] = maxUs;
+}
+
+// FxTimingStats
+/**
+ * Sizes the per effect statistics - must be called after all the effects have been registered
+ * @param fxCount number of effects registered
+ */
+void FxTimingStats::begin(const uint16_t fxCount) {
+    effects.resize(fxCount, nullptr);
+}
+
+EffectTiming *FxTimingStats::timing(const uint16_t fxIndex) {
+    if (fxIndex >= effects.size())
+        return nullptr;
+    if (effects[fxIndex] == nullptr)
+        effects[fxIndex] = new EffectTiming();
+    return effects[fxIndex];
+}
+
+/**
+ * Records the duration of a strip show
+ * @param us duration in microseconds
+ */
+void FxTimingStats::recordShow(const uint32_t us) {
+    CoreMutex coreMutex(&mutex);
+    show.add(us);
+    showCount++;
+    loopShowUs += us;
+}
+
+/**
+ * Records a show skipped because the frame has not changed since last pushed to the strip
+ * @param us duration of the frame change check in microseconds
+ */
+void FxTimingStats::recordSkip(const uint32_t us) {
+    CoreMutex coreMutex(&mutex);
+    skipCount++;
+    skipUs += us;
+}
+
+/**
+ * Records the duration of an effect state machine step. Only the Running and WindDown steps that have shown a frame are
+ * accounted for in the histograms, the steps that just poll the frame timers are skipped.
+ * @param fxIndex registry index of the effect
+ * @param state effect state the step has been executed for
+ * @param transitionType current transition type - see EffectTransition::type
+ * @param us duration in microseconds
+ */
+void FxTimingStats::recordLoop(const uint16_t fxIndex, const uint8_t state, const uint8_t transitionType, const uint32_t us) {
+    const uint32_t shows = showCount - loopShowMark;
+    const uint32_t skips = skipCount - loopSkipMark;
+    CoreMutex coreMutex(&mutex);
+    switch (state) {
+        case Setup:
+            if (EffectTiming *fxt = timing(fxIndex))
+                fxt->setupMaxUs = max(fxt->setupMaxUs, us);
+            break;
+        case Running:
+            if (shows == 0 && skips == 0)
+                break;
+            if (EffectTiming *fxt = timing(fxIndex)) {
+                fxt->skipped += skips;
+                if (shows == 0)
+                    break;
+                fxt->frame.add(us);
+                fxt->shows += shows;
+                fxt->showUs += loopShowUs;
+            }
+            break;
+        case WindDownPrep:
+        case WindDown:
+            if (shows > 0 && transitionType < TRANSITION_TYPES)
+                transitions[transitionType].add(us);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Records the scratch arena usage of an effect - the largest seen is kept
+ * @param fxIndex registry index of the effect
+ * @param bytes arena bytes allocated by the effect setup
+ */
+void FxTimingStats::recordArena(const uint16_t fxIndex, const size_t bytes) {
+    CoreMutex coreMutex(&mutex);
+    if (EffectTiming *fxt = timing(fxIndex))
+        fxt->arenaBytes = max(fxt->arenaBytes, static_cast<uint16_t>(bytes));
+}
+
+/**
+ * Scratch arena bytes an effect is expected to allocate in its setup - the largest recorded. For an effect that has not run yet, none
+ * unless the catalog flags it as an arena user, in which case the whole arena.
+ * @param fxIndex registry index of the effect
+ * @return the expected arena bytes
+ */
+size_t FxTimingStats::arenaNeed(const uint16_t fxIndex) const {
+    CoreMutex coreMutex(&mutex);
+    if (const EffectTiming *fxt = fxIndex < effects.size() ? effects[fxIndex] : nullptr)
+        return fxt->arenaBytes;
+    return fxIndex < effectCatalogSize && (effectCatalog[fxIndex].flags & FxFlagArena) ? ScratchArena::capacity() : 0;
+}
+
+/**
+ * Marshals the timing statistics into the JSON object provided - frame time percentiles per effect, wind down step
+ * percentiles per transition type, show time percentiles, pushed and skipped show counts, strip output, span rendering, crossfades,
+ * layers and scratch arena usage. Called from the web server task - the statistics are copied under the mutex, one effect at a time,
+ * and marshalled from the copies; the FX task keeps writing meanwhile.
+ * @param json JSON object to add the statistics to
+ */
+void FxTimingStats::stats(const JsonObject &json) const {
+    TimeHistogram showCopy;
+    TimeHistogram transCopy[TRANSITION_TYPES];
+    uint32_t shows, skips;
+    uint64_t skipTotalUs;
+    {
+        CoreMutex coreMutex(&mutex);
+        showCopy = show;
+        std::copy(transitions, transitions + TRANSITION_TYPES, transCopy);
+        shows = showCount;
+        skips = skipCount;
+        skipTotalUs = skipUs;
+    }
+    const auto jsShow = json["show"].to<JsonObject>();
+    showCopy.toJson(jsShow);
+    jsShow["pushed"] = shows;
+    jsShow["skipped"] = skips;
+    jsShow["avgSkipCheck"] = skips > 0 ? static_cast<uint32_t>(skipTotalUs / skips) : 0;
+    const auto jsOutput = json["output"].to<JsonObject>();
+    frameOutput.stats(jsOutput);
+    const auto jsRender = json["render"].to<JsonObject>();
+    spanRender.stats(jsRender);
+    const auto jsCrossfade = json["crossfade"].to<JsonObject>();
+    crossfade.stats(jsCrossfade);
+    const auto jsLayers = json["layers"].to<JsonObject>();
+    fxLayers.stats(jsLayers);
+    const auto jsFx = json["effects"].to<JsonObject>();
+    for (uint16_t i = 0; i < effects.size(); i++) {
+        EffectTiming fxt;
+        {
+            CoreMutex coreMutex(&mutex);
+            if (effects[i] == nullptr)
+                continue;
+            fxt = *effects[i];
+        }
+        const auto jsEffect = jsFx[fxRegistry.effectName(i)].to<JsonObject>();
+        fxt.frame.toJson(jsEffect);
+        jsEffect["setupMax"] = fxt.setupMaxUs;
+        jsEffect["avgShow"] = fxt.shows > 0 ? static_cast<uint32_t>(fxt.showUs / fxt.shows) : 0;
+        jsEffect["skippedShows"] = fxt.skipped;
+        jsEffect["arenaPeak"] = fxt.arenaBytes;
+    }
+    const auto jsArena = json["arena"].to<JsonObject>();
+    jsArena["size"] = ScratchArena::capacity();
+    jsArena["peak"] = fxArena.peak();
+    const auto jsTrans = json["transitions"].to<JsonObject>();
+    for (uint8_t t = 0; t < TRANSITION_TYPES; t++) {
+        if (transCopy[t].getTotal() == 0)
+            continue;
+        const auto jsType = jsTrans[EffectTransition::typeName(t)].to<JsonObject>();
+        transCopy[t].toJson(jsType);
+    }
+}
@@ -0,0 +1,71 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include "index_perm.h"
+
+IndexPermutation::IndexPermutation(const uint16_t size, const uint32_t seed) {
+    reset(size, seed);
+}
+
+/**
+ * Sets the permutation size and key
+ * @param size number of indexes permuted
+ * @param seed permutation key - the same seed always yields the same permutation
+ */
+void IndexPermutation::reset(const uint16_t size, const uint32_t seed) {
+    n = size;
+    uint8_t bits = 0;
+    while (bits < 16 && (1u << bits) < size)
+        bits++;
+    halfBits = bits > 2 ? (bits + 1) >> 1 : 1;
+    halfMask = (1u << halfBits) - 1;
+    reseed(seed);
+}
+
+/**
+ * Derives the round keys from the seed - splitmix32 style, such that close seeds give unrelated permutations
+ * @param seed permutation key
+ */
+void IndexPermutation::reseed(const uint32_t seed) {
+    uint32_t z = seed;
+    for (auto &k : keys) {
+        z += 0x9E3779B9u;
+        uint32_t v = z;
+        v = (v ^ (v >> 16)) * 0x85EBCA6Bu;
+        v = (v ^ (v >> 13)) * 0xC2B2AE35u;
+        k = v ^ (v >> 16);
+    }
+}
+
+/**
+ * One pass of the Feistel network over the 2*halfBits wide domain - a bijection of that domain
+ * @param x value to encipher
+ * @return enciphered value
+ */
+uint32_t IndexPermutation::encipher(const uint32_t x) const {
+    uint32_t left = x >> halfBits;
+    uint32_t right = x & halfMask;
+    for (const uint32_t k : keys) {
+        //round function - the high bits of a multiplicative hash of the right half and round key
+        const uint32_t f = ((right ^ k) * 0x9E3779B1u) >> (32 - halfBits);
+        const uint32_t tmp = left ^ ((f ^ (k >> 16)) & halfMask);
+        left = right;
+        right = tmp;
+    }
+    return (left << halfBits) | right;
+}
+
+/**
+ * The permuted position of an index
+ * @param i index, less than size()
+ * @return the index i is mapped to, less than size()
+ */
+uint16_t IndexPermutation::operator()(const uint16_t i) const {
+    if (n < 2)
+        return 0;
+    uint32_t y = encipher(i);
+    //cycle walking - the domain of the network is larger than the size; walking the cycle of i always reaches back within range
+    while (y >= n)
+        y = encipher(y);
+    return static_cast<uint16_t>(y);
+}
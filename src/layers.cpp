@@ -0,0 +1,366 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include <algorithm>
+#include "hardware/timer.h"
+#include "layers.h"
+#include "efx_setup.h"
+#include "util.h"
+
+LayerStack fxLayers;
+
+static const char *const modeNames[BlendModeCount] = {"normal", "add", "screen", "multiply", "overlay"};
+
+/**
+ * Mixes a range of a layer into the composed frame with the blend mode given - black layer pixels are transparent in normal mode
+ * @tparam M blend mode
+ * @param dst composed frame range
+ * @param src layer pixels of the range
+ * @param opacity layer opacity - 255 is opaque
+ * @param n number of pixels in the range
+ */
+template<BlendMode M> static void mixRange(CRGB *dst, const CRGB *src, const uint8_t opacity, const uint16_t n) {
+    for (uint16_t i = 0; i < n; i++) {
+        const CRGB &top = src[i];
+        CRGB px = dst[i];
+        switch (M) {
+            case BlendNormal:
+                if (!top)
+                    continue;
+                px = top;
+                break;
+            case BlendAdd: px += top; break;
+            case BlendScreen: blendScreen(px, top); break;
+            case BlendMultiply: blendMultiply(px, top); break;
+            case BlendOverlay: blendOverlay(px, top); break;
+            default: break;
+        }
+        dst[i] = opacity == 255 ? px : blend(dst[i], px, opacity);
+    }
+}
+
+/**
+ * Whether all pixels in a range are black
+ * @param pixels pixel buffer
+ * @param lo first pixel of the range
+ * @param hi end of the range (exclusive)
+ * @return true if no pixel in range is lit
+ */
+static bool isBlack(const CRGB *pixels, const uint16_t lo, const uint16_t hi) {
+    for (uint16_t i = lo; i < hi; i++)
+        if (pixels[i])
+            return false;
+    return true;
+}
+
+/**
+ * Requests a layer configuration - applied by the FX task at its next step, a later request for the same slot replacing an earlier one
+ * not applied yet. Safe to call from any task.
+ * @param slot layer slot, 0 is the lowest layer above the running effect
+ * @param cfg layer configuration - opacity 0 removes the layer
+ * @return sequence number of the request - see <code>waitApplied</code>; 0 if the slot is not valid
+ */
+uint32_t LayerStack::configure(const uint8_t slot, const LayerConfig &cfg) {
+    if (slot >= FX_LAYERS)
+        return 0;
+    CoreMutex coreMutex(&mutex);
+    pending[slot] = cfg;
+    pendingMask |= 1 << slot;
+    return ++requested;
+}
+
+/**
+ * Waits for the FX task to apply a configuration request - not to be called from the FX task
+ * @param seq sequence number of the request, as returned by <code>configure</code>
+ * @param timeoutMs how long to wait at most
+ * @return true if the request has been applied (the layer may have turned the effect down); false if the wait timed out
+ */
+bool LayerStack::waitApplied(const uint32_t seq, const uint32_t timeoutMs) const {
+    const uint32_t start = millis();
+    while (static_cast<int32_t>(applied - seq) < 0) {
+        if (millis() - start >= timeoutMs)
+            return false;
+        taskDelay(1);
+    }
+    return true;
+}
+
+/**
+ * Applies the configuration requested for a layer - a new layer effect is moved to setup, provided it can run as a layer and is not in
+ * use elsewhere
+ * @param slot layer slot
+ * @param cfg the configuration requested
+ */
+void LayerStack::apply(const uint8_t slot, const LayerConfig &cfg) {
+    Layer &l = layers[slot];
+    LedEffect *fx = cfg.opacity > 0 && cfg.fxIndex < fxRegistry.size() ? fxRegistry.getEffect(cfg.fxIndex) : nullptr;
+    if (fx != l.fx) {
+        release(slot);
+        if (fx != nullptr) {
+            if (!accepts(cfg.fxIndex)) {
+                log_warn(F("Effect %s [%d] uses the scratch arena, blocks or changes the output - cannot run as layer %d"), fx->name(), fx->getRegistryIndex(), slot);
+                return;
+            }
+            bool inUse = fx == fxRegistry.getCurrentEffect() || (fx->getState() != Idle && fx->getState() != Setup);
+            for (const auto &other : layers)
+                inUse |= other.fx == fx;
+            if (inUse) {
+                log_warn(F("Effect %s [%d] is in use - cannot run as layer %d"), fx->name(), fx->getRegistryIndex(), slot);
+                return;
+            }
+            l.fx = fx;
+            fill_solid(buffers[slot], NUM_PIXELS, BKG);
+            memset(lit[slot], 0, sizeof(lit[slot]));
+            fx->desiredState(Running);
+        }
+    }
+    l.mode = cfg.mode < BlendModeCount ? cfg.mode : BlendNormal;
+    l.opacity = l.fx == nullptr ? 0 : cfg.opacity;
+    l.hi = cfg.hi == 0 || cfg.hi > NUM_PIXELS ? NUM_PIXELS : cfg.hi;
+    l.lo = min(cfg.lo, l.hi);
+    dirty = true;
+    changed = true;
+    if (l.fx != nullptr)
+        log_info(F("Layer %d set to effect %s [%d] - %s mode, opacity %d, pixels %d to %d"), slot, l.fx->name(), l.fx->getRegistryIndex(),
+                 modeNames[l.mode], l.opacity, l.lo, l.hi);
+}
+
+/**
+ * Removes the effect of a layer - the effect is stopped right away
+ * @param slot layer slot
+ */
+void LayerStack::release(const uint8_t slot) {
+    Layer &l = layers[slot];
+    if (l.fx != nullptr) {
+        if (l.fx != fxRegistry.getCurrentEffect())
+            l.fx->state = Idle;
+        log_info(F("Layer %d effect %s [%d] removed"), slot, l.fx->name(), l.fx->getRegistryIndex());
+    }
+    l.fx = nullptr;
+    l.opacity = 0;
+    dirty = true;
+    changed = true;
+}
+
+/**
+ * Runs one step of a layer effect against the layer's buffer and context. The effect setup runs with the running effect's scratch
+ * arena blocks pinned; an effect allocating from the arena is removed from the layer.
+ * @param slot layer slot
+ * @return true if the effect rendered a frame
+ */
+bool LayerStack::step(const uint8_t slot) {
+    LedEffect *fx = layers[slot].fx;
+    const bool setup = fx->getState() == Setup;
+    const size_t floor = setup ? fxArena.pin() : 0;
+    contexts[slot].restore();
+    std::swap_ranges(leds, leds + NUM_PIXELS, buffers[slot]);
+    capturing = true;
+    captured = false;
+    fx->loop();
+    capturing = false;
+    std::swap_ranges(leds, leds + NUM_PIXELS, buffers[slot]);
+    contexts[slot].save();
+    if (setup) {
+        const size_t bytes = fxArena.reset();
+        fxArena.unpin(floor);
+        if (bytes > 0) {
+            log_warn(F("Effect %s [%d] allocates %zu bytes of scratch arena - cannot run as layer %d"), fx->name(), fx->getRegistryIndex(), bytes, slot);
+            release(slot);
+            return false;
+        }
+    }
+    if (captured)
+        scanLit(slot);
+    return captured;
+}
+
+/**
+ * Marks the blocks of a layer that have at least one pixel lit, as shown - through the layer's output mapping
+ * @param slot layer slot
+ */
+void LayerStack::scanLit(const uint8_t slot) {
+    const OutputMapping &mapping = contexts[slot].mapping;
+    CRGB px[LAYER_BLOCK_SIZE];
+    memset(lit[slot], 0, sizeof(lit[slot]));
+    for (uint16_t b = 0; b < numBlocks; b++) {
+        const uint16_t lo = b * LAYER_BLOCK_SIZE;
+        const uint16_t hi = min(static_cast<uint16_t>(lo + LAYER_BLOCK_SIZE), static_cast<uint16_t>(NUM_PIXELS));
+        mapping.copy(px, buffers[slot], lo, hi);
+        if (!isBlack(px, 0, hi - lo))
+            lit[slot][b >> 5] |= 1u << (b & 31);
+    }
+}
+
+/**
+ * Copies the layers for other tasks to describe
+ */
+void LayerStack::publish() {
+    CoreMutex coreMutex(&mutex);
+    std::copy(layers, layers + FX_LAYERS, published);
+    changed = false;
+}
+
+/**
+ * Layers step - applies the configuration changes requested, then steps each layer effect, with the base effect's context put aside.
+ * Layers whose effect has become the running effect are dropped. When a layer rendered a frame, the strip is shown again - unless
+ * crossfading, which composites its own frames.
+ */
+void LayerStack::loop() {
+    LayerConfig cfgs[FX_LAYERS];
+    uint8_t mask;
+    uint32_t seq;
+    {
+        CoreMutex coreMutex(&mutex);
+        mask = pendingMask;
+        pendingMask = 0;
+        seq = requested;
+        if (mask != 0)
+            std::copy(pending, pending + FX_LAYERS, cfgs);
+    }
+    for (uint8_t s = 0; s < FX_LAYERS; s++)
+        if (mask & (1 << s))
+            apply(s, cfgs[s]);
+    bool rendered = false;
+    bool stepping = false;
+    active = 0;
+    for (uint8_t s = 0; s < FX_LAYERS; s++) {
+        const Layer &l = layers[s];
+        if (l.fx == nullptr)
+            continue;
+        if (l.fx == fxRegistry.getCurrentEffect()) {
+            log_info(F("Layer %d effect %s [%d] is now the running effect"), s, l.fx->name(), l.fx->getRegistryIndex());
+            release(s);
+            continue;
+        }
+        if (!stepping) {
+            baseContext.save();
+            stepping = true;
+        }
+        rendered |= step(s);
+        if (l.opacity > 0)
+            active++;
+    }
+    if (stepping)
+        baseContext.restore();
+    if (changed)
+        publish();
+    applied = seq;
+    if (rendered) {
+        dirty = true;
+        if (!crossfade.isActive())
+            showStrip(stripBrightness);
+    }
+}
+
+/**
+ * Composites the layers over the base frame, block by block - the base block is copied, then each layer covering the block is mixed in.
+ * The base frame and the layers are read through their output mappings, hence the composed frame comes out mapped.
+ * Layer blocks that cannot change the block are skipped: all black for the normal, add and screen modes; the block black so far for
+ * multiply and overlay.
+ * @param base the base frame - the LED buffer
+ * @return the composed frame; the base frame itself when no layers are active
+ */
+const CRGB *LayerStack::compose(const CRGB *base) {
+    dirty = false;
+    if (active == 0)
+        return base;
+    const uint32_t start = time_us_32();
+    const OutputMapping &baseMapping = outputMap.mapping();
+    CRGB px[LAYER_BLOCK_SIZE];
+    for (uint16_t b = 0; b < numBlocks; b++) {
+        const uint16_t bLo = b * LAYER_BLOCK_SIZE;
+        const uint16_t bHi = min(static_cast<uint16_t>(bLo + LAYER_BLOCK_SIZE), static_cast<uint16_t>(NUM_PIXELS));
+        baseMapping.copy(composed + bLo, base, bLo, bHi);
+        for (uint8_t s = 0; s < FX_LAYERS; s++) {
+            const Layer &l = layers[s];
+            if (l.fx == nullptr || l.opacity == 0 || l.hi <= bLo || l.lo >= bHi)
+                continue;
+            const uint16_t lo = max(bLo, l.lo);
+            const uint16_t hi = min(bHi, l.hi);
+            const bool keyed = l.mode == BlendNormal || l.mode == BlendAdd || l.mode == BlendScreen;
+            if (keyed ? !isLit(s, b) : isBlack(composed, lo, hi)) {
+                blocksSkipped++;
+                continue;
+            }
+            contexts[s].mapping.copy(px, buffers[s], lo, hi);
+            switch (l.mode) {
+                case BlendNormal: mixRange<BlendNormal>(composed + lo, px, l.opacity, hi - lo); break;
+                case BlendAdd: mixRange<BlendAdd>(composed + lo, px, l.opacity, hi - lo); break;
+                case BlendScreen: mixRange<BlendScreen>(composed + lo, px, l.opacity, hi - lo); break;
+                case BlendMultiply: mixRange<BlendMultiply>(composed + lo, px, l.opacity, hi - lo); break;
+                case BlendOverlay: mixRange<BlendOverlay>(composed + lo, px, l.opacity, hi - lo); break;
+                default: break;
+            }
+            blocksMixed++;
+        }
+    }
+    composites++;
+    composeUs += time_us_32() - start;
+    return composed;
+}
+
+/**
+ * Describes the layers in effect, as last published by the FX task - safe to call from any task
+ * @param json the JSON array to populate - one object per layer slot
+ */
+void LayerStack::describe(const JsonArray &json) const {
+    Layer copy[FX_LAYERS];
+    {
+        CoreMutex coreMutex(&mutex);
+        std::copy(published, published + FX_LAYERS, copy);
+    }
+    for (const auto &l : copy) {
+        const auto jsLayer = json.add<JsonObject>();
+        if (l.fx == nullptr)
+            continue;
+        jsLayer["fx"] = l.fx->getRegistryIndex();
+        jsLayer["name"] = l.fx->name();
+        jsLayer["mode"] = modeNames[l.mode];
+        jsLayer["opacity"] = l.opacity;
+        jsLayer["lo"] = l.lo;
+        jsLayer["hi"] = l.hi;
+    }
+}
+
+/**
+ * Marshals the compositing statistics into the JSON object provided
+ * @param json JSON object to add the statistics to
+ */
+void LayerStack::stats(const JsonObject &json) const {
+    json["active"] = active;
+    json["composites"] = composites;
+    json["avgCompose"] = composites > 0 ? static_cast<uint32_t>(composeUs / composites) : 0;
+    json["blocksMixed"] = blocksMixed;
+    json["blocksSkipped"] = blocksSkipped;
+}
+
+/**
+ * Name of a blend mode
+ * @param mode blend mode
+ * @return the mode name
+ */
+const char *LayerStack::modeName(const BlendMode mode) {
+    return modeNames[mode < BlendModeCount ? mode : BlendNormal];
+}
+
+/**
+ * Parses a blend mode name
+ * @param name mode name - see <code>modeName</code>
+ * @return the blend mode; <code>BlendModeCount</code> if the name is not recognized
+ */
+BlendMode LayerStack::parseMode(const char *name) {
+    for (uint8_t m = 0; m < BlendModeCount; m++)
+        if (name != nullptr && strcmp(name, modeNames[m]) == 0)
+            return static_cast<BlendMode>(m);
+    return BlendModeCount;
+}
+
+/**
+ * Whether an effect can run as a layer - effects that allocate from the scratch arena, render in blocking loops or change the output
+ * stage (the sleep light) cannot
+ * @param fxIndex registry index of the effect
+ * @return true if the effect is known and can run as a layer
+ */
+bool LayerStack::accepts(const uint16_t fxIndex) {
+    return fxIndex < effectCatalogSize && !(effectCatalog[fxIndex].flags & (FxFlagSleep | FxFlagArena | FxFlagBlocking));
+}
@@ -0,0 +1,134 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include "lit_map.h"
+#include "efx_setup.h"
+
+LitMap litMap(leds);
+
+/**
+ * Lit map of a pixel buffer of NUM_PIXELS, summarizing all of them until resized - all blocks start unknown (possibly lit)
+ * @param pixels the pixel buffer
+ */
+LitMap::LitMap(const CRGB *pixels) : buf(pixels) {
+    invalidate();
+}
+
+/**
+ * Limits the summary to the first pixels of the buffer - pixels past those are not shown, hence never counted as lit
+ * @param count number of pixels summarized, at most NUM_PIXELS
+ */
+void LitMap::resize(const uint16_t count) {
+    pixels = min(count, static_cast<uint16_t>(NUM_PIXELS));
+    blocks = (pixels + LIT_BLOCK_SIZE - 1) / LIT_BLOCK_SIZE;
+    invalidate();
+}
+
+/**
+ * Marks all blocks as possibly lit - required after writes that may have brightened any pixel
+ */
+void LitMap::invalidate() {
+    memset(bound, 0xFF, sizeof(bound));
+}
+
+/**
+ * Marks the blocks of a pixel range as possibly lit
+ * @param lo first pixel of the range
+ * @param hi last pixel of the range (inclusive)
+ */
+void LitMap::invalidate(const uint16_t lo, const uint16_t hi) {
+    for (uint16_t b = lo / LIT_BLOCK_SIZE; b <= hi / LIT_BLOCK_SIZE && b < blocks; b++)
+        bound[b] = 0xFF;
+}
+
+/**
+ * Moves the bounds along with a shift of the pixels in range by a number of positions, the pixels fed in being black - each block
+ * bound becomes the max of the bounds of the blocks its pixels came from. Shifts by a block or more invalidate the range.
+ * @param lo first pixel of the range shifted
+ * @param hi last pixel of the range shifted (inclusive)
+ * @param by number of positions shifted - positive to the right (towards the end), negative to the left
+ */
+void LitMap::shifted(const uint16_t lo, const uint16_t hi, const int16_t by) {
+    if (by >= LIT_BLOCK_SIZE || by <= -LIT_BLOCK_SIZE) {
+        invalidate(lo, hi);
+        return;
+    }
+    const uint16_t loBlock = lo / LIT_BLOCK_SIZE;
+    if (lo >= pixels)
+        return;
+    const uint16_t hiBlock = min(static_cast<uint16_t>(hi / LIT_BLOCK_SIZE), static_cast<uint16_t>(blocks - 1));
+    if (by > 0) {
+        for (uint16_t b = hiBlock; b > loBlock; b--)
+            bound[b] = max(bound[b], bound[b-1]);
+    } else if (by < 0) {
+        for (uint16_t b = loBlock; b < hiBlock; b++)
+            bound[b] = max(bound[b], bound[b+1]);
+    }
+}
+
+/**
+ * Scans a block, tightening its bound to the exact max luma
+ * @param block block index
+ * @return the max luma of the block's pixels
+ */
+uint8_t LitMap::rescan(const uint16_t block) {
+    const uint16_t start = block * LIT_BLOCK_SIZE;
+    const uint16_t end = min(static_cast<uint16_t>(start + LIT_BLOCK_SIZE), pixels);
+    uint8_t mx = 0;
+    for (uint16_t i = start; i < end; i++)
+        mx = max(mx, buf[i].getLuma());
+    bound[block] = mx;
+    return mx;
+}
+
+/**
+ * Whether any pixel is brighter than the luma given - same result as <code>isAnyLedOn</code> over the pixels summarized where the
+ * luma is the background's. Only the blocks possibly brighter are scanned, stopping at the first one confirmed.
+ * @param luma luma threshold
+ * @return true if at least one pixel has a luma above the threshold
+ */
+bool LitMap::anyBrighter(const uint8_t luma) {
+    for (uint16_t b = 0; b < blocks; b++) {
+        if (bound[b] > luma && rescan(b) > luma)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Counts the pixels brighter than the luma given - same result as <code>countPixelsBrighter</code> over the pixels summarized.
+ * Only the blocks possibly brighter are scanned.
+ * @param luma luma threshold
+ * @return number of pixels with a luma above the threshold
+ */
+uint16_t LitMap::countBrighter(const uint8_t luma) {
+    uint16_t count = 0;
+    for (uint16_t b = 0; b < blocks; b++) {
+        if (bound[b] <= luma)
+            continue;
+        const uint16_t start = b * LIT_BLOCK_SIZE;
+        const uint16_t end = min(static_cast<uint16_t>(start + LIT_BLOCK_SIZE), pixels);
+        uint8_t mx = 0;
+        for (uint16_t i = start; i < end; i++) {
+            const uint8_t l = buf[i].getLuma();
+            mx = max(mx, l);
+            if (l > luma)
+                count++;
+        }
+        bound[b] = mx;
+    }
+    return count;
+}
+
+/**
+ * Number of blocks possibly brighter than the luma given, per the current bounds - no pixels are read
+ * @param luma luma threshold
+ * @return number of blocks whose bound is above the threshold
+ */
+uint16_t LitMap::litBlocks(const uint8_t luma) const {
+    uint16_t count = 0;
+    for (uint16_t b = 0; b < blocks; b++)
+        if (bound[b] > luma)
+            count++;
+    return count;
+}
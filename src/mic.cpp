@@ -16,14 +16,14 @@
 #define MIC_CHANNELS    1
 // default PCM output frequency - 20kHz for Nano RP2040. Max is ~24kHz.
 #define PCM_SAMPLE_FREQ 24000
-// Buffer to read samples into, each sample is 16-bits
+// Samples dropped when the ring is full, each sample is 16-bits
 short sampleBuffer[MIC_SAMPLE_SIZE];
 
-volatile size_t samplesRead;                    // Number of audio samples read
 volatile uint16_t maxAudio[10] {};              // audio max levels histogram
 volatile uint16_t audioBumpThreshold = 5000;    // the audio signal level beyond which entropy is added and an effect change is triggered
 
-CircularBuffer<short> *audioData = new CircularBuffer<short>(1024);
+SpscRing<short, 1024> audioData;                // PDM callback (producer) -> mic task (consumer)
+volatile uint32_t audioOverruns = 0;            // sample blocks dropped for lack of room in audioData
 
 
 void clearLevelHistory() {
@@ -35,14 +35,23 @@ void clearLevelHistory() {
   * Callback function to process the data from the PDM microphone.
   * NOTE: This callback is executed as part of an ISR.
   * Therefore, using `Serial` to print messages inside this function isn't supported.
+  * The samples are read straight into the audio ring; when the mic task has fallen behind and the ring is full, they are dropped.
   */
 void onPDMdata() {
-    // Query the number of available bytes
-    const size_t bytesAvailable = PDM.available();
-    // Read into the sample buffer
-    PDM.read(sampleBuffer, bytesAvailable);
-    // 16-bit, 2 bytes per sample
-    samplesRead = bytesAvailable / 2;
+    // Query the number of available bytes - 16-bit, 2 bytes per sample
+    size_t bytesAvailable = PDM.available();
+    while (bytesAvailable > 0) {
+        const RingSpan<short> span = audioData.writeSpan();
+        if (span.size == 0) {
+            PDM.read(sampleBuffer, min(bytesAvailable, sizeof(sampleBuffer)));
+            audioOverruns = audioOverruns + 1;
+            break;
+        }
+        const size_t bytes = min(bytesAvailable, span.size * sizeof(short));
+        PDM.read(span.data, static_cast<int>(bytes));
+        audioData.commit(bytes / sizeof(short));
+        bytesAvailable -= bytes;
+    }
 }
 
 void mic_setup() {
@@ -63,34 +72,31 @@ void mic_setup() {
 }
 
 void mic_run() {
-    // Wait for samples to be read
-    if (samplesRead) {
-        audioData->push_back(sampleBuffer, samplesRead);
-        //log_info(F("Audio data - added %d samples to circular buffer, size updated to %d items"), samplesRead, audioData->size());
-        short maxSample = INT16_MIN;
-        for (uint i = 0; i < samplesRead; i++) {
-            if (sampleBuffer[i] > maxSample)
-                maxSample = sampleBuffer[i];
+    // Consume the samples read since last run, in place
+    short maxSample = INT16_MIN;
+    for (RingSpan<const short> span = audioData.readSpan(); span.size > 0; span = audioData.readSpan()) {
+        for (size_t i = 0; i < span.size; i++) {
+            if (span.data[i] > maxSample)
+                maxSample = span.data[i];
         }
-        if (maxSample > audioBumpThreshold) {
-            fxBump = true;
-            random16_add_entropy(abs(maxSample));
-            log_info(F("Audio sample: %hd"), maxSample);
+        audioData.consume(span.size);
+    }
+    if (maxSample > audioBumpThreshold) {
+        fxBump = true;
+        random16_add_entropy(abs(maxSample));
+        log_info(F("Audio sample: %hd"), maxSample);
 
-            //contribute to the audio histogram - the bins are 500 units wide and tailored around audioBumpThreshold.
-            bool bFoundBin = false;
-            for (uint8_t x = 0; x < AUDIO_HIST_BINS_COUNT; x++) {
-                if (const uint16_t binThr = audioBumpThreshold + (x+1)*500; maxSample <= binThr) {
-                    maxAudio[x]++;
-                    bFoundBin = true;
-                    break;
-                }
+        //contribute to the audio histogram - the bins are 500 units wide and tailored around audioBumpThreshold.
+        bool bFoundBin = false;
+        for (uint8_t x = 0; x < AUDIO_HIST_BINS_COUNT; x++) {
+            if (const uint16_t binThr = audioBumpThreshold + (x+1)*500; maxSample <= binThr) {
+                maxAudio[x]++;
+                bFoundBin = true;
+                break;
             }
-            //if a bin not found, it means it's higher than max bin given the number of bins, place it in the last bin
-            if (!bFoundBin)
-                maxAudio[AUDIO_HIST_BINS_COUNT-1]++;
         }
-        // Clear the read count
-        samplesRead = 0;
+        //if a bin not found, it means it's higher than max bin given the number of bins, place it in the last bin
+        if (!bFoundBin)
+            maxAudio[AUDIO_HIST_BINS_COUNT-1]++;
     }
 }
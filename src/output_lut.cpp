@@ -0,0 +1,108 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include "output_lut.h"
+#include "topology.h"
+
+OutputLut outputLut;
+
+/**
+ * Computes the gamma curve and sets the color adjustments - call once, before the first show
+ * @param gamma gamma exponent - 1.0 leaves the values linear (same as FastLED scaling), 2.2 is a typical perceptual curve
+ * @param ledCorrection color correction of the LED chip, e.g. <code>TypicalSMD5050</code>
+ * @param colorTemperature color temperature, e.g. <code>Tungsten100W</code>
+ */
+void OutputLut::begin(const float gamma, const CRGB ledCorrection, const CRGB colorTemperature) {
+    for (uint16_t v = 0; v < 256; v++)
+        gammaCurve[v] = gamma == 1.0f ? v << 8 : static_cast<uint16_t>(lroundf(powf(v / 255.0f, gamma) * 255.0f * 256.0f));
+    correction = ledCorrection;
+    temperature = colorTemperature;
+    changed();
+}
+
+/**
+ * Marks the tables for rebuild - lazily, ahead of the next frame transformed
+ */
+void OutputLut::changed() {
+    stale = true;
+    gen++;
+}
+
+/**
+ * Sets the color correction of the LED chip
+ * @param ledCorrection color correction, e.g. <code>TypicalSMD5050</code>
+ */
+void OutputLut::setCorrection(const CRGB ledCorrection) {
+    if (ledCorrection != correction) {
+        correction = ledCorrection;
+        changed();
+    }
+}
+
+/**
+ * Sets the color temperature
+ * @param colorTemperature color temperature, e.g. <code>Tungsten40W</code>
+ */
+void OutputLut::setTemperature(const CRGB colorTemperature) {
+    if (colorTemperature != temperature) {
+        temperature = colorTemperature;
+        changed();
+    }
+}
+
+/**
+ * Sets the brightness the strip is shown at - cheap when unchanged, hence suitable to call for every frame
+ * @param scale brightness, 0-255
+ */
+void OutputLut::setBrightness(const uint8_t scale) {
+    if (scale != brightness) {
+        brightness = scale;
+        changed();
+    }
+}
+
+/**
+ * Rebuilds the lookup tables - per channel, the gamma curve scaled by correction, temperature and brightness combined into a 0.16
+ * fixed point factor, rounded once to 8 bits. Any input at 0 turns the channel off, same as FastLED.
+ */
+void OutputLut::rebuild() {
+    constexpr uint32_t fullScale = 255u * 255u * 255u;
+    for (uint8_t c = 0; c < 3; c++) {
+        const uint64_t factors = static_cast<uint64_t>(correction.raw[c] * temperature.raw[c] * brightness) << 16;
+        const auto k = static_cast<uint32_t>((factors + fullScale / 2) / fullScale);
+        uint8_t *t = lut[c];
+        for (uint16_t v = 0; v < 256; v++)
+            t[v] = (gammaCurve[v] * k + 0x800000u) >> 24;
+    }
+    stale = false;
+}
+
+/**
+ * Transforms a frame into an output buffer
+ * @param src the LED buffer, NUM_PIXELS long
+ * @param dest the output buffer, NUM_PIXELS long
+ * @param gather for each output pixel, the LED buffer pixel it shows - TOPOLOGY_DARK for none; nullptr maps pixels one to one
+ */
+void OutputLut::apply(const CRGB *src, CRGB *dest, const uint16_t *gather) {
+    if (stale)
+        rebuild();
+    const uint8_t *r = lut[0], *g = lut[1], *b = lut[2];
+    if (gather != nullptr) {
+        for (uint16_t i = 0; i < NUM_PIXELS; i++) {
+            if (gather[i] == TOPOLOGY_DARK) {
+                dest[i] = CRGB::Black;
+                continue;
+            }
+            const CRGB &px = src[gather[i]];
+            dest[i].r = r[px.r];
+            dest[i].g = g[px.g];
+            dest[i].b = b[px.b];
+        }
+        return;
+    }
+    for (uint16_t i = 0; i < NUM_PIXELS; i++) {
+        dest[i].r = r[src[i].r];
+        dest[i].g = g[src[i].g];
+        dest[i].b = b[src[i].b];
+    }
+}
@@ -0,0 +1,190 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include "output_map.h"
+#include "efx_setup.h"
+#include "topology.h"
+
+OutputMapper outputMap;
+
+/**
+ * The pixel a position of the LED buffer shows, per the mapping
+ * @param i LED buffer position
+ * @return the LED buffer position the pixel is taken from - itself outside the replicated region, or when the mapping is not active
+ */
+uint16_t OutputMapping::source(const uint16_t i) const {
+    if (!active || i < start + frameLen || i >= start + totalLen)
+        return i;
+    const uint16_t k = i - start;
+    switch (rule) {
+        case Mirror: {
+            //frame, reversed frame, frame, reversed frame...
+            const uint16_t m = k % (frameLen * 2);
+            return start + (m < frameLen ? m : frameLen * 2 - 1 - m);
+        }
+        case Reverse:
+            //frame, reversed frame, reversed frame...
+            return start + frameLen - 1 - (k - frameLen) % frameLen;
+        default:
+            return start + k % frameLen;
+    }
+}
+
+/**
+ * Copies a range of a pixel buffer through the mapping - the range comes out as it is shown
+ * @param dest destination, <code>hi - lo</code> pixels long
+ * @param src pixel buffer laid out as the LED buffer
+ * @param lo first pixel of the range
+ * @param hi end of the range (exclusive)
+ */
+void OutputMapping::copy(CRGB *dest, const CRGB *src, const uint16_t lo, const uint16_t hi) const {
+    if (!active || hi <= start + frameLen || lo >= start + totalLen) {
+        memcpy(dest, src + lo, (hi - lo) * sizeof(CRGB));
+        return;
+    }
+    for (uint16_t i = lo; i < hi; i++)
+        dest[i - lo] = src[source(i)];
+}
+
+bool OutputMapping::operator==(const OutputMapping &other) const {
+    if (!active || !other.active)
+        return active == other.active;
+    return start == other.start && frameLen == other.frameLen && totalLen == other.totalLen && rule == other.rule;
+}
+
+/**
+ * Records the mapping of a logical frame onto a destination set, to be gathered at output time
+ * @param src logical frame
+ * @param dest destination region - must follow the logical frame in the LED buffer; clipped to the logical pixels
+ * @param outRule the expansion rule
+ * @return true if the mapping has been recorded; false if the source and destination are not suitable for output mapping
+ * (reversed, non-adjacent, outside the LED buffer or past the logical pixels of the strip topology) - the caller needs to replicate
+ * the set right away
+ */
+bool OutputMapper::map(const CRGBSet &src, const CRGBSet &dest, const OutputRule outRule) {
+    const CRGB *shownEnd = leds + topology.logicalSize();
+    if (src.len <= 0 || dest.len <= 0 || dest.leds != src.end_pos || src.leds < leds || dest.leds >= shownEnd || dest.end_pos > leds + NUM_PIXELS)
+        return false;
+    OutputMapping next;
+    next.start = src.leds - leds;
+    next.frameLen = src.len;
+    const CRGB *end = dest.end_pos < shownEnd ? dest.end_pos : shownEnd;   //the pixels past the logical ones are not shown
+    next.totalLen = end - src.leds;
+    next.rule = outRule;
+    next.active = true;
+    if (next == current)
+        return true;
+    //a different frame mapped is materialized first, preserving the order of operations
+    if (current.active && (current.start != next.start || current.totalLen != next.totalLen))
+        apply();
+    current = next;
+    gen++;
+    return true;
+}
+
+/**
+ * Fills the buffer up to end by repeating the block - each pass copies the whole region expanded so far, hence the number of
+ * copy operations is logarithmic in the number of repetitions
+ * @param block start of the repeating block, already populated
+ * @param blockLen block length
+ * @param end end of the region to fill (exclusive)
+ */
+void OutputMapper::expand(CRGB *block, const uint16_t blockLen, const CRGB *end) {
+    CRGB *fill = block + blockLen;
+    uint16_t filled = blockLen;
+    while (fill < end) {
+        const uint16_t n = min(filled, static_cast<uint16_t>(end - fill));
+        memcpy(fill, block, n * sizeof(CRGB));
+        fill += n;
+        filled += n;
+    }
+}
+
+/**
+ * Materializes the mapping, if any, into the LED buffer and drops it - for the consumers of the whole LED buffer (e.g. the wind
+ * down transitions)
+ */
+void OutputMapper::apply() {
+    if (!current.active)
+        return;
+    current.active = false;
+    gen++;
+    CRGB *base = leds + current.start;
+    const uint16_t frameLen = current.frameLen;
+    const uint16_t totalLen = current.totalLen;
+    const CRGB *end = base + totalLen;
+    switch (current.rule) {
+        case Repeat:
+            expand(base, frameLen, end);
+            break;
+        case Mirror:
+        case Reverse: {
+            //the reversed frame follows the logical frame
+            const uint16_t revLen = min(frameLen, static_cast<uint16_t>(totalLen - frameLen));
+            CRGB *rev = base + frameLen;
+            for (uint16_t i = 0; i < revLen; i++)
+                rev[i] = base[frameLen - 1 - i];
+            if (revLen == frameLen) {
+                if (current.rule == Mirror)
+                    expand(base, frameLen * 2, end);
+                else
+                    expand(rev, frameLen, end);
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * Drops the mapping, if any, without materializing it - the replicated region is left as last written
+ */
+void OutputMapper::cancel() {
+    if (!current.active)
+        return;
+    current.active = false;
+    gen++;
+}
+
+/**
+ * Switches to the mapping of another pixel buffer swapped into the LED buffer - see FxContext
+ * @param mapping the mapping of the buffer
+ */
+void OutputMapper::restore(const OutputMapping &mapping) {
+    if (mapping == current)
+        return;
+    current = mapping;
+    gen++;
+}
+
+/**
+ * Whether a set overlaps the replicated region - the virtual part of the LED buffer while the mapping is active
+ * @param set pixel set, possibly reversed
+ * @return true if any pixel of the set is in the replicated region
+ */
+bool OutputMapper::overlaps(const CRGBSet &set) const {
+    if (!current.active || set.len == 0)
+        return false;
+    const CRGB *lo = set.len < 0 ? set.end_pos + 1 : set.leds;
+    const CRGB *hi = set.len < 0 ? set.leds + 1 : set.end_pos;
+    return lo < leds + current.start + current.totalLen && hi > leds + current.start + current.frameLen;
+}
+
+/**
+ * Gather table of the output stage - for each output pixel, the LED buffer pixel it shows: the topology gather composed with the
+ * mapping. Rebuilt only when either has changed.
+ * @param topology topology gather table - see <code>Topology::gather</code>; nullptr for the identity
+ * @return the gather table; the topology one, possibly nullptr, when no mapping is active
+ */
+const uint16_t *OutputMapper::gather(const uint16_t *topology) {
+    if (!current.active)
+        return topology;
+    if (lutGen != gen || lutTopology != topology) {
+        for (uint16_t p = 0; p < NUM_PIXELS; p++) {
+            const uint16_t t = topology == nullptr ? p : topology[p];
+            gatherLut[p] = t == TOPOLOGY_DARK ? TOPOLOGY_DARK : current.source(t);
+        }
+        lutGen = gen;
+        lutTopology = topology;
+    }
+    return gatherLut;
+}
@@ -0,0 +1,40 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include "palette_cache.h"
+#include "efx_setup.h"
+
+PaletteCache paletteCache(&palette);
+PaletteCache targetPaletteCache(&targetPalette);
+
+/**
+ * Expands the palette into the 256 color table, unconditionally
+ * @param pal palette to expand
+ */
+void PaletteCache::expand(const CRGBPalette16 &pal) {
+    snapshot = pal;
+    for (uint16_t i = 0; i < 256; i++)
+        table[i] = ColorFromPalette(pal, i, 255, LINEARBLEND);
+    valid = true;
+}
+
+/**
+ * Brings the cache in line with the tracked palette - the table is expanded again only if the palette has changed since
+ * the last expansion (a 48 byte comparison otherwise)
+ * @return true if the table has been expanded; false if it was up to date, or there is no tracked palette
+ */
+bool PaletteCache::sync() {
+    if (tracked == nullptr || (valid && snapshot == *tracked))
+        return false;
+    expand(*tracked);
+    return true;
+}
+
+/**
+ * Syncs the caches of the global palettes - called before each effect step and whenever the globals are reset, such that
+ * the effects see up-to-date palette colors through the caches
+ */
+void syncPaletteCaches() {
+    paletteCache.sync();
+    targetPaletteCache.sync();
+}
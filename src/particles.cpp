@@ -0,0 +1,91 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include "particles.h"
+#include "fx_arena.h"
+
+/**
+ * Allocates the particle arrays from the scratch arena - call from the effect setup. All particles start dead.
+ * @param capacity maximum number of live particles
+ * @return true if the pool has been allocated; false if the arena is exhausted - the pool is then empty, with no capacity
+ */
+bool ParticlePool::begin(const uint16_t capacity) {
+    cap = live = 0;
+    pos = fxArena.makeArray<fixed>(capacity);
+    vel = fxArena.makeArray<fixed>(capacity);
+    liveMap = fxArena.makeArray<uint32_t>((capacity + 31) >> 5);
+    hue = fxArena.makeArray<uint8_t>(capacity);
+    bright = fxArena.makeArray<uint8_t>(capacity);
+    life = fxArena.makeArray<uint8_t>(capacity);
+    aux = fxArena.makeArray<uint8_t>(capacity);
+    if (!pos || !vel || !liveMap || !hue || !bright || !life || !aux)
+        return false;
+    cap = capacity;
+    return true;
+}
+
+/**
+ * Claims a dead particle slot. The attributes keep the values of the particle previously in the slot - the caller initializes them.
+ * @return the slot of the new particle; -1 if all particles are alive
+ */
+int16_t ParticlePool::spawn() {
+    const uint16_t words = (cap + 31) >> 5;
+    for (uint16_t w = 0; w < words; w++) {
+        if (liveMap[w] == UINT32_MAX)
+            continue;
+        const uint16_t i = (w << 5) + __builtin_ctz(~liveMap[w]);
+        if (i >= cap)
+            break;
+        liveMap[w] |= 1u << (i & 0x1F);
+        live++;
+        return static_cast<int16_t>(i);
+    }
+    return -1;
+}
+
+/**
+ * Releases a particle slot
+ * @param i particle slot
+ */
+void ParticlePool::kill(const uint16_t i) {
+    if (!isAlive(i))
+        return;
+    liveMap[i >> 5] &= ~(1u << (i & 0x1F));
+    live--;
+}
+
+/**
+ * Kills all particles
+ */
+void ParticlePool::clear() {
+    for (uint16_t w = 0; w < (cap + 31) >> 5; w++)
+        liveMap[w] = 0;
+    live = 0;
+}
+
+/**
+ * Batched kinematics step for the live particles - advances the position by the velocity, constrains it to the range given, and
+ * accelerates the velocity
+ * @param accel velocity change per step, 15.16 fixed point
+ * @param lo lowest position allowed, 15.16 fixed point
+ * @param hi highest position allowed, 15.16 fixed point
+ */
+void ParticlePool::move(const fixed accel, const fixed lo, const fixed hi) {
+    forEach([this, accel, lo, hi](const uint16_t i) {
+        const fixed p = pos[i] + vel[i];
+        pos[i] = p < lo ? lo : (p > hi ? hi : p);
+        vel[i] += accel;
+    });
+}
+
+/**
+ * Batched aging of the live particles - the particles whose life runs out are killed
+ * @param steps number of steps to subtract from each particle's life
+ */
+void ParticlePool::age(const uint8_t steps) {
+    forEach([this, steps](const uint16_t i) {
+        life[i] = life[i] > steps ? life[i] - steps : 0;
+        if (life[i] == 0)
+            kill(i);
+    });
+}
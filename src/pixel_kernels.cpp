@@ -0,0 +1,190 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include <cstring>
+#include "pixel_kernels.h"
+
+// even (bytes 0 and 2) lanes of a word; the odd lanes are the same mask shifted by 8
+static constexpr uint32_t LANES = 0x00FF00FFu;
+
+static inline bool isAligned(const void *p) {
+    return (reinterpret_cast<uintptr_t>(p) & 3u) == 0;
+}
+
+// the Cortex-M0+ faults on unaligned word access - these are only called with word aligned pointers
+static inline uint32_t loadWord(const uint8_t *p) {
+    uint32_t w;
+    memcpy(&w, __builtin_assume_aligned(p, 4), sizeof(w));
+    return w;
+}
+
+static inline void storeWord(uint8_t *p, const uint32_t w) {
+    memcpy(__builtin_assume_aligned(p, 4), &w, sizeof(w));
+}
+
+// byte by byte load, for a source that does not share the destination's alignment
+static inline uint32_t loadBytes(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+/**
+ * Same as FastLED's <code>scale8</code> with FASTLED_SCALE8_FIXED: (i*(1+scale))/256
+ */
+static inline uint8_t scaleByte(const uint8_t i, const uint32_t scale1) {
+    return (i * scale1) >> 8;
+}
+
+/**
+ * Scales the 4 channels of a word - each product fits its 16-bit lane, (255*256) &lt; 2^16
+ */
+static inline uint32_t scaleWord(const uint32_t w, const uint32_t scale1) {
+    const uint32_t even = (((w & LANES) * scale1) >> 8) & LANES;
+    const uint32_t odd = (((w >> 8) & LANES) * scale1) & ~LANES;
+    return even | odd;
+}
+
+/**
+ * Same as FastLED's <code>blend8</code> with FASTLED_SCALE8_FIXED: (a*256 + b + b*amt - a*amt)/256
+ */
+static inline uint8_t blendByte(const uint8_t a, const uint8_t b, const uint32_t amt) {
+    return ((a << 8 | b) - a * amt + b * amt) >> 8;
+}
+
+/**
+ * Blends the 4 channels of a word. The order of operations matters - subtracting first keeps every 16-bit lane in [0, 65535]
+ * at each step, hence no borrow or carry crosses into the neighbouring lane
+ */
+static inline uint32_t blendWord(const uint32_t a, const uint32_t b, const uint32_t amt) {
+    const uint32_t ae = a & LANES, be = b & LANES;
+    const uint32_t ao = (a >> 8) & LANES, bo = (b >> 8) & LANES;
+    const uint32_t even = ((((ae << 8) | be) - ae * amt + be * amt) >> 8) & LANES;
+    const uint32_t odd = (((ao << 8) | bo) - ao * amt + bo * amt) & ~LANES;
+    return even | odd;
+}
+
+/**
+ * Same as <code>bmul8</code> in util.cpp, inlined
+ */
+static inline uint8_t mulByte(const uint8_t a, const uint8_t b) {
+    if (a == 255)
+        return b;
+    if (b == 255)
+        return a;
+    return (a * b) >> 8;
+}
+
+/**
+ * Scales the bytes in place - equivalent with FastLED's <code>nscale8</code> over the pixels these bytes belong to
+ * @param p start of the buffer
+ * @param n number of bytes (3 per pixel)
+ * @param scale scale factor, 255 leaves the bytes unchanged
+ */
+void scaleBytes(uint8_t *p, size_t n, const uint8_t scale) {
+    if (scale == 255)
+        return;
+    const uint32_t scale1 = scale + 1;
+    for (; n > 0 && !isAligned(p); --n, ++p)
+        *p = scaleByte(*p, scale1);
+    for (; n >= 4; n -= 4, p += 4)
+        storeWord(p, scaleWord(loadWord(p), scale1));
+    for (; n > 0; --n, ++p)
+        *p = scaleByte(*p, scale1);
+}
+
+/**
+ * Blends the source bytes into the destination - equivalent with FastLED's <code>nblend(CRGB*, const CRGB*, uint16_t, fract8)</code>
+ * @param dst destination buffer, receives the result
+ * @param src source (overlay) buffer, may have any alignment
+ * @param n number of bytes (3 per pixel)
+ * @param amountOfSrc blend amount, 0 leaves the destination unchanged, 255 copies the source
+ */
+void blendBytes(uint8_t *dst, const uint8_t *src, size_t n, const uint8_t amountOfSrc) {
+    if (amountOfSrc == 0)
+        return;
+    if (amountOfSrc == 255) {
+        memmove(dst, src, n);
+        return;
+    }
+    const uint32_t amt = amountOfSrc;
+    for (; n > 0 && !isAligned(dst); --n, ++dst, ++src)
+        *dst = blendByte(*dst, *src, amt);
+    if (isAligned(src)) {
+        for (; n >= 4; n -= 4, dst += 4, src += 4)
+            storeWord(dst, blendWord(loadWord(dst), loadWord(src), amt));
+    } else {
+        for (; n >= 4; n -= 4, dst += 4, src += 4)
+            storeWord(dst, blendWord(loadWord(dst), loadBytes(src), amt));
+    }
+    for (; n > 0; --n, ++dst, ++src)
+        *dst = blendByte(*dst, *src, amt);
+}
+
+/**
+ * Blends a solid color into the pixels - equivalent with FastLED's <code>CPixelView::nblend(const CRGB&amp;, fract8)</code>.
+ * The color is laid out as 3 words covering 4 pixels (12 bytes), matching the channel phase of the first aligned word
+ * @param dst destination pixel buffer, receives the result
+ * @param nPixels number of pixels
+ * @param color the color bytes, in the pixel channel order
+ * @param amountOfColor blend amount, 0 leaves the pixels unchanged, 255 fills them with the color
+ */
+void blendColorBytes(uint8_t *dst, const size_t nPixels, const uint8_t color[3], const uint8_t amountOfColor) {
+    if (amountOfColor == 0)
+        return;
+    const uint32_t amt = amountOfColor;
+    size_t n = nPixels * 3;
+    uint8_t ch = 0;
+    for (; n > 0 && !isAligned(dst); --n, ++dst, ch = ch == 2 ? 0 : ch + 1)
+        *dst = amountOfColor == 255 ? color[ch] : blendByte(*dst, color[ch], amt);
+    uint32_t pattern[3] = {0, 0, 0};
+    for (uint8_t b = 0; b < 12; b++)
+        pattern[b >> 2] |= static_cast<uint32_t>(color[(ch + b) % 3]) << ((b & 3) * 8);
+    if (amountOfColor == 255) {
+        for (; n >= 12; n -= 12, dst += 12) {
+            storeWord(dst, pattern[0]);
+            storeWord(dst + 4, pattern[1]);
+            storeWord(dst + 8, pattern[2]);
+        }
+    } else {
+        for (; n >= 12; n -= 12, dst += 12) {
+            storeWord(dst, blendWord(loadWord(dst), pattern[0], amt));
+            storeWord(dst + 4, blendWord(loadWord(dst + 4), pattern[1], amt));
+            storeWord(dst + 8, blendWord(loadWord(dst + 8), pattern[2], amt));
+        }
+    }
+    //12 bytes is a whole number of pixels - the channel phase is where it was before the 12-byte blocks
+    for (; n > 0; --n, ++dst, ch = ch == 2 ? 0 : ch + 1)
+        *dst = amountOfColor == 255 ? color[ch] : blendByte(*dst, color[ch], amt);
+}
+
+/**
+ * Multiply blend mode - equivalent with <code>bmul8</code> applied to each byte pair
+ * @param dst base layer, receives the result
+ * @param src top layer
+ * @param n number of bytes (3 per pixel)
+ */
+void multiplyBytes(uint8_t *dst, const uint8_t *src, size_t n) {
+    for (; n > 0; --n, ++dst, ++src)
+        *dst = mulByte(*dst, *src);
+}
+
+/**
+ * Screen blend mode - equivalent with <code>bscr8</code> applied to each byte pair
+ * @param dst base layer, receives the result
+ * @param src top layer
+ * @param n number of bytes (3 per pixel)
+ */
+void screenBytes(uint8_t *dst, const uint8_t *src, size_t n) {
+    for (; n > 0; --n, ++dst, ++src)
+        *dst = 255 - mulByte(255 - *dst, 255 - *src);
+}
+
+/**
+ * Overlay blend mode - equivalent with <code>bovl8</code> applied to each byte pair
+ * @param dst base layer, receives the result
+ * @param src top layer
+ * @param n number of bytes (3 per pixel)
+ */
+void overlayBytes(uint8_t *dst, const uint8_t *src, size_t n) {
+    for (; n > 0; --n, ++dst, ++src)
+        *dst = *dst < 128 ? mulByte(*dst, *src) * 2 : 255 - mulByte(255 - *dst, 255 - *src) * 2;
+}
@@ -0,0 +1,82 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include "hardware/timer.h"
+#include "span_render.h"
+#include "log.h"
+
+SpanRenderer spanRender;
+
+/**
+ * Attaches the calling task as the Render task - spans are rendered on both cores from now on
+ */
+void SpanRenderer::attach() {
+    done = xSemaphoreCreateBinary();
+    helper = xTaskGetCurrentTaskHandle();
+    log_info(F("Span renderer attached to task %s on core %d"), pcTaskGetName(helper), get_core_num());
+}
+
+/**
+ * Render task step - waits for a span to be handed over, renders it and signals the caller
+ */
+void SpanRenderer::run() {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    job(jobCtx, jobLo, jobHi);
+    xSemaphoreGive(done);
+}
+
+/**
+ * Renders the span [lo, hi) with the kernel given - split across both cores when the Render task is attached
+ * @param kernel range kernel
+ * @param ctx kernel context, passed through to the kernel
+ * @param lo first element of the span
+ * @param hi end of the span (exclusive)
+ * @param callerShare share of the span rendered by the calling core, out of 256 - the lower part of the span
+ */
+void SpanRenderer::render(const SpanKernel kernel, void *ctx, const uint16_t lo, const uint16_t hi, const uint8_t callerShare) {
+    if (!isParallel() || (hi - lo) < SPAN_RENDER_MIN) {
+        kernel(ctx, lo, hi);
+        serialSpans++;
+        return;
+    }
+    const uint16_t mid = lo + (((hi - lo) * callerShare) >> 8);
+    job = kernel;
+    jobCtx = ctx;
+    jobLo = mid;
+    jobHi = hi;
+    xTaskNotifyGive(helper);
+    kernel(ctx, lo, mid);
+    if (xSemaphoreTake(done, 0) != pdTRUE) {
+        const uint32_t start = time_us_32();
+        xSemaphoreTake(done, portMAX_DELAY);
+        barrierWaits++;
+        barrierWaitUs += time_us_32() - start;
+    }
+    parallelSpans++;
+}
+
+/**
+ * Marshals the span rendering statistics into the JSON object provided
+ * @param json JSON object to add the statistics to
+ */
+void SpanRenderer::stats(const JsonObject &json) const {
+    json["parallel"] = isParallel();
+    json["parallelSpans"] = parallelSpans;
+    json["serialSpans"] = serialSpans;
+    json["barrierWaits"] = barrierWaits;
+    json["avgBarrierWait"] = barrierWaits > 0 ? static_cast<uint32_t>(barrierWaitUs / barrierWaits) : 0;
+}
+
+/**
+ * Render task setup - attaches the task to the span renderer
+ */
+void render_setup() {
+    spanRender.attach();
+}
+
+/**
+ * Render task loop
+ */
+void render_run() {
+    spanRender.run();
+}
@@ -0,0 +1,164 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#include "topology.h"
+#include "filesystem.h"
+#include "log.h"
+
+Topology topology;
+
+/**
+ * Back to the identity mapping - one segment over the whole strip, no matrix
+ */
+void Topology::reset() {
+    numSegs = 0;
+    logical = NUM_PIXELS;
+    width = height = 0;
+    identity = true;
+}
+
+/**
+ * Loads the strip topology from a JSON file and compiles it - see the class description for the format. Any error in the description
+ * leaves the identity mapping in place.
+ * @param fname topology file name
+ * @return true if a topology has been loaded; false if there is no topology file or the description is not valid
+ */
+bool Topology::load(const char *fname) {
+    auto *json = new String();
+    json->reserve(512);
+    const size_t sz = SyncFsImpl.readFile(fname, json);
+    if (sz == 0) {
+        delete json;
+        log_info(F("No strip topology file %s - logical pixels map one to one on the strip"), fname);
+        return false;
+    }
+    JsonDocument doc;
+    const DeserializationError error = deserializeJson(doc, *json);
+    delete json;
+    if (error) {
+        log_error(F("Cannot parse strip topology file %s: %s - logical pixels map one to one on the strip"), fname, error.c_str());
+        return false;
+    }
+    numSegs = 0;
+    for (const auto jsSeg : doc["segments"].as<JsonArrayConst>()) {
+        if (numSegs >= TOPOLOGY_MAX_SEGMENTS) {
+            log_error(F("Strip topology %s has more than %d segments - logical pixels map one to one on the strip"), fname, TOPOLOGY_MAX_SEGMENTS);
+            reset();
+            return false;
+        }
+        TopoSegment &sg = segs[numSegs++];
+        sg.start = jsSeg["start"].as<uint16_t>();
+        sg.len = jsSeg["len"].as<uint16_t>();
+        sg.reverse = jsSeg["reverse"] | false;
+        sg.mirrorOf = -1;
+    }
+    for (const auto jsGroup : doc["mirrors"].as<JsonArrayConst>()) {
+        const auto group = jsGroup.as<JsonArrayConst>();
+        const int src = group[0] | -1;
+        for (size_t k = 1; k < group.size(); k++) {
+            const int m = group[k] | -1;
+            if (src < 0 || src >= numSegs || m < 0 || m >= numSegs || m == src) {
+                log_error(F("Strip topology %s has an invalid mirror group - segments %d and %d"), fname, src, m);
+                reset();
+                return false;
+            }
+            segs[m].mirrorOf = static_cast<int8_t>(src);
+        }
+    }
+    width = doc["matrix"]["width"] | 0;
+    height = doc["matrix"]["height"] | 0;
+    if (!compile(doc["matrix"]["serpentine"] | false)) {
+        log_error(F("Strip topology %s is not valid - logical pixels map one to one on the strip"), fname);
+        reset();
+        return false;
+    }
+    log_info(F("Strip topology loaded from %s [%zu bytes]: %d segments, %d logical pixels, matrix %dx%d%s"), fname, sz, numSegs, logical,
+             width, height, identity ? " - identity mapping" : "");
+    return true;
+}
+
+/**
+ * Compiles the segments and the matrix into the index tables - validates the segments fit the strip, do not overlap, mirror only
+ * segments that have their own logical pixels and leave room for the template frame <code>tpl</code> and its replication
+ * @param serpentine whether the matrix rows run alternately left to right and right to left
+ * @return true if the description is valid and compiled
+ */
+bool Topology::compile(const bool serpentine) {
+    if (numSegs == 0) {
+        log_error(F("Strip topology has no segments"));
+        return false;
+    }
+    uint16_t logicalStart[TOPOLOGY_MAX_SEGMENTS] {};
+    uint16_t next = 0;
+    for (uint8_t s = 0; s < numSegs; s++) {
+        const TopoSegment &sg = segs[s];
+        if (sg.len == 0 || sg.start + sg.len > NUM_PIXELS) {
+            log_error(F("Strip topology segment %d [%d, %d pixels] is outside the strip of %d pixels"), s, sg.start, sg.len, NUM_PIXELS);
+            return false;
+        }
+        for (uint8_t t = 0; t < s; t++) {
+            if (sg.start < segs[t].start + segs[t].len && segs[t].start < sg.start + sg.len) {
+                log_error(F("Strip topology segments %d and %d overlap"), t, s);
+                return false;
+            }
+        }
+        if (sg.mirrorOf >= 0 && segs[sg.mirrorOf].mirrorOf >= 0) {
+            log_error(F("Strip topology segment %d mirrors segment %d, itself a mirror"), s, sg.mirrorOf);
+            return false;
+        }
+        if (sg.mirrorOf < 0) {
+            logicalStart[s] = next;
+            next += sg.len;
+        }
+    }
+    for (auto &g : gatherLut)
+        g = TOPOLOGY_DARK;
+    for (uint8_t s = 0; s < numSegs; s++) {
+        const TopoSegment &sg = segs[s];
+        const uint8_t src = sg.mirrorOf < 0 ? s : sg.mirrorOf;
+        const uint16_t n = min(sg.len, segs[src].len);     //a mirror longer than its source has its extra pixels dark
+        for (uint16_t j = 0; j < n; j++) {
+            const uint16_t p = sg.reverse ? sg.start + sg.len - 1 - j : sg.start + j;
+            gatherLut[p] = logicalStart[src] + j;
+        }
+    }
+    if (next <= FRAME_SIZE) {
+        log_error(F("Strip topology has %d logical pixels - effects need more than their template frame of %d pixels"), next, FRAME_SIZE);
+        return false;
+    }
+    logical = next;
+    identity = true;
+    for (uint16_t p = 0; p < NUM_PIXELS && identity; p++)
+        identity = gatherLut[p] == p;
+    const uint32_t cells = static_cast<uint32_t>(width) * height;
+    if (cells > logical) {
+        log_error(F("Strip topology matrix %dx%d does not fit the %d logical pixels"), width, height, logical);
+        return false;
+    }
+    for (uint16_t y = 0; y < height; y++)
+        for (uint16_t x = 0; x < width; x++)
+            xyLut[y * width + x] = y * width + (serpentine && (y & 0x01) ? width - 1 - x : x);
+    return true;
+}
+
+/**
+ * Describes the topology in effect
+ * @param json the JSON object to populate
+ */
+void Topology::describe(const JsonObject &json) const {
+    json["identity"] = identity;
+    json["logical"] = logical;
+    const auto jsSegs = json["segments"].to<JsonArray>();
+    for (uint8_t s = 0; s < numSegs; s++) {
+        const auto jsSeg = jsSegs.add<JsonObject>();
+        jsSeg["start"] = segs[s].start;
+        jsSeg["len"] = segs[s].len;
+        jsSeg["reverse"] = segs[s].reverse;
+        if (segs[s].mirrorOf >= 0)
+            jsSeg["mirrorOf"] = segs[s].mirrorOf;
+    }
+    if (width > 0 && height > 0) {
+        json["width"] = width;
+        json["height"] = height;
+    }
+}
@@ -4,6 +4,8 @@
 #include "transition.h"
 #include "efx_setup.h"
 
+static constexpr const char *transitionNames[] PROGMEM = {"spots", "wipe", "fade", "split", "randomBars", "halfWipe"};
+
 // EffectTransition - we have 5 distinct off effects
 void EffectTransition::setup() {
     prefFx = 0;     //no preference - i.e. automatic from sel
@@ -14,18 +16,36 @@ void EffectTransition::setup() {
 
 void EffectTransition::resetRandomBars() {
     randomBarSegs.clear();
+    const uint16_t numPixels = topology.logicalSize();
     uint16_t sum = 0;
-    while (sum < NUM_PIXELS) {
+    while (sum < numPixels) {
         uint8_t szSeg = random8(3, 10);
         randomBarSegs.push_front(szSeg);
         sum += szSeg;
     }
-    if (sum > NUM_PIXELS)
-        randomBarSegs.front() -= (sum-NUM_PIXELS);
+    if (sum > numPixels)
+        randomBarSegs.front() -= (sum-numPixels);
+}
+
+/**
+ * The type of transition (off effect) currently selected - the index in the list of 'offXYZ' methods
+ * @return transition type, between 0 and effectsCount-1
+ */
+uint8_t EffectTransition::type() const {
+    return prefFx ? (prefFx-1) : sel/2;
+}
+
+/**
+ * Name of a transition type, suitable for reporting
+ * @param type transition type
+ * @return transition type name
+ */
+const char *EffectTransition::typeName(const uint8_t type) {
+    return type < effectsCount ? transitionNames[type] : "unknown";
 }
 
 bool EffectTransition::transition() {
-    switch (uint8_t effect = prefFx ? (prefFx-1) : sel/2) {
+    switch (type()) {
         case 0: return offSpots();
         case 1: return offWipe(sel % 2);
         case 2: return offFade();
@@ -49,6 +69,7 @@ void EffectTransition::prepare(const uint selector) {
     offPosIndex = 0;
     offSpotSegSize = turnOffSeq[offPosIndex];
     fade = random8(42, 110);
+    litMap.invalidate();
 }
 
 uint EffectTransition::selector() const {
@@ -63,28 +84,28 @@ uint EffectTransition::selector() const {
 bool EffectTransition::offSpots() {
     bool allOff = false;
 
-    EVERY_N_MILLIS(30) {
+    FRAME_EVERY_N_MILLIS(30) {
         uint8_t ledsOn = 0;
         for (uint16_t x = 0; x < offSpotSegSize; x++) {
-            const uint16_t xled = stripShuffleIndex[(offSpotShuffleOffset + x) % NUM_PIXELS];
-            FastLED.leds()[xled].fadeToBlackBy(fade);
-            if (FastLED.leds()[xled].getLuma() < 4)
-                FastLED.leds()[xled] = BKG;
+            const uint16_t xled = stripShuffle((offSpotShuffleOffset + x) % stripShuffle.size());
+            leds[xled].fadeToBlackBy(fade);
+            if (leds[xled].getLuma() < 4)
+                leds[xled] = BKG;
             else
                 ledsOn++;
         }
 
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
         if (ledsOn == 0) {
-            offSpotShuffleOffset = inc(offSpotShuffleOffset, offSpotSegSize, NUM_PIXELS);  //need to increment with szOffSpot before advancing it
+            offSpotShuffleOffset = inc(offSpotShuffleOffset, offSpotSegSize, stripShuffle.size());  //need to increment with szOffSpot before advancing it
             offPosIndex = inc(offPosIndex, 1, arrSize(turnOffSeq));
             offSpotSegSize = turnOffSeq[offPosIndex];
             fade = random8(42, 110);
         }
     }
 
-    EVERY_N_MILLIS(500) {
-        allOff = !isAnyLedOn(FastLED.leds(), FastLED.size(), BKG);
+    FRAME_EVERY_N_MILLIS(500) {
+        allOff = !litMap.anyBrighter(BKG.getLuma());
     }
 
     return allOff;
@@ -97,16 +118,17 @@ bool EffectTransition::offSpots() {
  */
 bool EffectTransition::offWipe(bool rightDir) {
     bool allOff = false;
-    EVERY_N_MILLIS(60) {
-        CRGBSet strip(leds, NUM_PIXELS);
+    FRAME_EVERY_N_MILLIS(60) {
+        CRGBSet strip = logicalSet();
         if (rightDir)
             shiftRight(strip, BKG);
         else
             shiftLeft(strip, BKG);
-        FastLED.show(stripBrightness);
+        litMap.shifted(0, topology.logicalSize()-1, rightDir ? 1 : -1);
+        showStrip(stripBrightness);
     }
-    EVERY_N_MILLIS(720) {
-        allOff = !isAnyLedOn(leds, NUM_PIXELS, BKG);
+    FRAME_EVERY_N_MILLIS(720) {
+        allOff = !litMap.anyBrighter(BKG.getLuma());
     }
 
     return allOff;
@@ -119,10 +141,11 @@ bool EffectTransition::offWipe(bool rightDir) {
  */
 bool EffectTransition::offHalfWipe(bool inward) {
     bool allOff = false;
-    EVERY_N_MILLIS(60) {
-        constexpr uint16_t halfSize = NUM_PIXELS/2;
+    FRAME_EVERY_N_MILLIS(60) {
+        const uint16_t maxIndex = topology.logicalSize()-1;
+        const uint16_t halfSize = topology.logicalSize()/2;
         CRGBSet stripH1(leds, halfSize);
-        CRGBSet stripH2(leds, halfSize, NUM_PIXELS-1);
+        CRGBSet stripH2(leds, halfSize, maxIndex);
         if (inward) {
             //inward
             shiftRight(stripH1, BKG);
@@ -132,10 +155,12 @@ bool EffectTransition::offHalfWipe(bool inward) {
             shiftLeft(stripH1, BKG);
             shiftRight(stripH2, BKG);
         }
-        FastLED.show(stripBrightness);
+        litMap.shifted(0, halfSize-1, inward ? 1 : -1);
+        litMap.shifted(halfSize, maxIndex, inward ? -1 : 1);
+        showStrip(stripBrightness);
     }
-    EVERY_N_MILLIS(720) {
-        allOff = !isAnyLedOn(leds, NUM_PIXELS, BKG);
+    FRAME_EVERY_N_MILLIS(720) {
+        allOff = !litMap.anyBrighter(BKG.getLuma());
     }
 
     return allOff;
@@ -147,13 +172,13 @@ bool EffectTransition::offHalfWipe(bool inward) {
  */
 bool EffectTransition::offFade() {
     bool allOff = false;
-    EVERY_N_MILLIS(50) {
-        CRGBSet strip(leds, NUM_PIXELS);
-        strip.fadeToBlackBy(32);
-        FastLED.show(stripBrightness);
+    FRAME_EVERY_N_MILLIS(50) {
+        CRGBSet strip = logicalSet();
+        fadeSet(strip, 32);
+        showStrip(stripBrightness);
     }
-    EVERY_N_MILLIS(500) {
-        allOff = !isAnyLedOn(leds, NUM_PIXELS, BKG);
+    FRAME_EVERY_N_MILLIS(500) {
+        allOff = !litMap.anyBrighter(BKG.getLuma());
     }
     return allOff;
 }
@@ -165,21 +190,21 @@ bool EffectTransition::offFade() {
  */
 bool EffectTransition::offSplit(bool outward) {
     bool allOff = false;
-    EVERY_N_MILLIS(50) {
-        constexpr uint16_t halfSize = NUM_PIXELS/2;
-        constexpr uint16_t maxIndex = NUM_PIXELS-1;
+    FRAME_EVERY_N_MILLIS(50) {
+        const uint16_t halfSize = topology.logicalSize()/2;
+        const uint16_t maxIndex = topology.logicalSize()-1;
         const uint16_t offSegSize = 1+offPosIndex/8;
         CRGBSet s1(leds, outward?offPosIndex:qsuba(halfSize-1, offPosIndex), outward?(offPosIndex+offSegSize):qsuba(halfSize-1, offPosIndex+offSegSize));
         CRGBSet s2(leds, outward?(maxIndex-offPosIndex):capu(halfSize+offPosIndex, maxIndex), outward?(maxIndex-offPosIndex-offSegSize):capu(halfSize+offPosIndex+offSegSize, maxIndex));
-        s1.nblend(BKG, 120);
-        s2.nblend(BKG, 120);
+        blendSet(s1, BKG, 120);
+        blendSet(s2, BKG, 120);
         if (!s1 && !s2)
             offPosIndex+=(1+offSegSize);
 
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
         allOff = offPosIndex >= halfSize;
     }
-//    EVERY_N_MILLIS(500) {
+//    FRAME_EVERY_N_MILLIS(500) {
 //        allOff = !isAnyLedOn(leds, NUM_PIXELS, BKG);
 //    }
     return allOff;
@@ -192,7 +217,7 @@ bool EffectTransition::offSplit(bool outward) {
  */
 bool EffectTransition::offRandomBars(bool rightDir) const {
     bool allOff = false;
-    EVERY_N_MILLIS(50) {
+    FRAME_EVERY_N_MILLIS(50) {
         uint16_t ovrSz = 0;
         bool segOff = true;
         for (auto &sz : randomBarSegs) {
@@ -200,7 +225,7 @@ bool EffectTransition::offRandomBars(bool rightDir) const {
                 segOff = false;
             ovrSz+=sz;
         }
-        FastLED.show(stripBrightness);
+        showStrip(stripBrightness);
         allOff = segOff;
     }
     return allOff;
@@ -3,12 +3,15 @@
 #include <LittleFS.h>
 #include <PicoLog.h>
 #include <TimeLib.h>
+#include "hardware/timer.h"
 #include "filesystem.h"
 #include "web_server.h"
 #include "comms.h"
 #include "constants.hpp"
 #include "diag.h"
 #include "efx_setup.h"
+#include "entropy_pool.h"
+#include "fx_stats.h"
 #include "FxSchedule.h"
 #include "mic.h"
 #include "net_setup.h"
@@ -39,6 +42,8 @@ static constexpr uint16_t serverPort PROGMEM = 80;
 
 WebServer web::server;
 bool web::server_handlers_configured = false;
+static TimeHistogram pollGap;     //time between web server polls - how long a request may wait to be picked up; web task only
+static TimeHistogram pollTime;    //time spent in the polls, handling the requests if any - the tail is the request handling
 
 /**
  * @brief A map that associates file paths with their corresponding in-memory resources for serving static content.
@@ -132,16 +137,20 @@ void web::handleGetStatus(WebClient &client) {
     fx["asleep"] = fxRegistry.isAsleep();
     fx["autoTheme"] = paletteFactory.isAuto();
     fx["theme"] = holidayToString(paletteFactory.getHoliday()); //could be forced to a fixed value
-    const LedEffect *curFx = fxRegistry.getCurrentEffect();
-    fx["index"] = curFx->getRegistryIndex();
-    fx["name"] = curFx->name();
+    const uint16_t curFx = fxRegistry.curEffectPos();
+    fx["index"] = curFx;
+    fx["name"] = fxRegistry.effectName(curFx);
+    fx["instances"] = fxRegistry.instancesCount();
     fx[csBroadcast] = fxBroadcastEnabled;
     auto lastFx = fx["pastEffects"].to<JsonArray>();
     fxRegistry.pastEffectsRun(lastFx); //ordered earliest to latest (current effect is the last element)
     fx[csBrightness] = stripBrightness;
     fx[csBrightnessLocked] = stripBrightnessLocked;
     fx[csAudioThreshold] = audioBumpThreshold; //current audio level threshold
+    fxLayers.describe(fx[csLayers].to<JsonArray>());
+    topology.describe(fx["topology"].to<JsonObject>());
     fx["totalAudioBumps"] = totalAudioBumps; //how many times (in total) have we bumped the effect due to audio level
+    fx["audioOverruns"] = audioOverruns; //sample blocks dropped - the mic task fell behind
     const auto audioHist = fx["audioHist"].to<JsonArray>();
     for (uint16_t x: maxAudio)
         audioHist.add<uint16_t>(x);
@@ -225,6 +234,38 @@ void web::handleGetStatus(WebClient &client) {
     log_info(F("Handler handleGetStatus invoked for %s, response size %zu bytes"), client.request().uri().c_str(), sz);
 }
 
+/**
+ * Parses and validates a layer configuration request - {"slot":0, "effect":12, "mode":"screen", "opacity":128, "lo":0, "hi":100}. The slot
+ * and the effect are required; the mode defaults to normal, the opacity to 255 (0 removes the layer), the pixel range to the whole strip.
+ * @param jsLayer the layer request
+ * @param slot parsed layer slot
+ * @param cfg parsed layer configuration
+ * @return nullptr if the request is valid; the error response otherwise
+ */
+static const char *parseLayer(const JsonVariantConst &jsLayer, uint8_t &slot, LayerConfig &cfg) {
+    if (!jsLayer["slot"].is<uint8_t>() || jsLayer["slot"].as<uint8_t>() >= FX_LAYERS)
+        return R"({"error": "Layer slot missing or out of range"})";
+    slot = jsLayer["slot"].as<uint8_t>();
+    if (!jsLayer[strEffect].is<uint16_t>() || jsLayer[strEffect].as<uint16_t>() >= fxRegistry.size())
+        return R"({"error": "Layer effect missing or unknown"})";
+    cfg.fxIndex = jsLayer[strEffect].as<uint16_t>();
+    if (!jsLayer["opacity"].isNull() && !jsLayer["opacity"].is<uint8_t>())
+        return R"({"error": "Layer opacity out of range 0-255"})";
+    cfg.opacity = jsLayer["opacity"] | static_cast<uint8_t>(255);
+    if (cfg.opacity > 0 && !LayerStack::accepts(cfg.fxIndex))
+        return R"({"error": "Layer effect cannot run as a layer"})";
+    cfg.mode = jsLayer["mode"].isNull() ? BlendNormal : LayerStack::parseMode(jsLayer["mode"].as<const char *>());
+    if (cfg.mode >= BlendModeCount)
+        return R"({"error": "Layer blend mode unknown"})";
+    if ((!jsLayer["lo"].isNull() && !jsLayer["lo"].is<uint16_t>()) || (!jsLayer["hi"].isNull() && !jsLayer["hi"].is<uint16_t>()))
+        return R"({"error": "Layer pixel range not valid"})";
+    cfg.lo = jsLayer["lo"] | static_cast<uint16_t>(0);
+    cfg.hi = jsLayer["hi"] | static_cast<uint16_t>(NUM_PIXELS);
+    if (cfg.hi > NUM_PIXELS || cfg.lo >= cfg.hi)
+        return R"({"error": "Layer pixel range not valid"})";
+    return nullptr;
+}
+
 /**
  * Web request handler - PUT /fx. Method invoked by the web server; response sent to the current client awaiting response from the server
  */
@@ -240,6 +281,15 @@ void web::handlePutConfig(WebClient &client) {
         client.send(500, mime::mimeTable[mime::txt].mimeType, error.c_str());
         return;
     }
+    //layer requests are validated before any update is made - an invalid one fails the whole request
+    for (const auto jsLayer : doc[csLayers].as<JsonArrayConst>()) {
+        uint8_t slot;
+        LayerConfig cfg;
+        if (const char *layerError = parseLayer(jsLayer, slot, cfg)) {
+            client.send(400, mime::mimeTable[mime::txt].mimeType, layerError);
+            return;
+        }
+    }
     JsonDocument resp;
     const auto upd = resp["updates"].to<JsonObject>();
     if (doc[csAuto].is<bool>()) {
@@ -284,6 +334,19 @@ void web::handlePutConfig(WebClient &client) {
             upd[csResetCal] = resetCal;
         }
     }
+    if (doc[csLayers].is<JsonArray>()) {
+        //each element configures a layer slot - see parseLayer; the layers reported are those in effect once the FX task applied the requests
+        uint32_t seq = 0;
+        for (const auto jsLayer : doc[csLayers].as<JsonArrayConst>()) {
+            uint8_t slot;
+            LayerConfig cfg;
+            parseLayer(jsLayer, slot, cfg);
+            seq = fxLayers.configure(slot, cfg);
+        }
+        if (seq > 0 && !fxLayers.waitApplied(seq))
+            upd["layersPending"] = true;
+        fxLayers.describe(upd[csLayers].to<JsonArray>());
+    }
     if (doc[csBroadcast].is<bool>()) {
         const bool syncMode = doc[csBroadcast].as<bool>();
         const bool masterEnabled = syncMode != fxBroadcastEnabled && syncMode;
@@ -328,6 +391,15 @@ void web::handleGetTasks(WebClient &client) {
     SysInfo::heapStats(heap);
     auto tasks = doc["tasks"].to<JsonObject>();
     SysInfo::taskStats(tasks);
+    auto fxSched = doc["fxScheduler"].to<JsonObject>();
+    fxScheduler.stats(fxSched);
+    auto fxTime = doc["fxTiming"].to<JsonObject>();
+    fxTiming.stats(fxTime);
+    auto entropy = doc["entropyPool"].to<JsonObject>();
+    entropyPool.stats(entropy);
+    auto webStats = doc["web"].to<JsonObject>();
+    pollGap.toJson(webStats["pollGap"].to<JsonObject>());
+    pollTime.toJson(webStats["poll"].to<JsonObject>());
     doc["boardName"] = sysInfo->getBoardName();
     doc["boardUid"] = sysInfo->getBoardId();
     doc["fwVersion"] = sysInfo->getBuildVersion();
@@ -455,10 +527,17 @@ void web::server_setup() {
 }
 
 /**
- * Web Server client handling - one at a time
+ * Web Server client handling - one at a time. Times the polls and the gap between them - the latency the other tasks on the core
+ * add to the requests.
  */
 void web::webserver() {
+    static uint32_t lastPollUs = 0;
+    const uint32_t start = time_us_32();
+    if (lastPollUs != 0)
+        pollGap.add(start - lastPollUs);
+    lastPollUs = start;
     server.handleClient();
+    pollTime.add(time_us_32() - start);
 #if MDNS_ENABLED==1
     EVERY_N_MILLIS(500) {
         mdns->process();
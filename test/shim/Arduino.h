@@ -0,0 +1,18 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_TEST_SHIM_ARDUINO_H
+#define ARDUINO_LIGHTFX_TEST_SHIM_ARDUINO_H
+
+/**
+ * Host stand-in for the arduino-pico core header, for the native test environment - only what the header-only modules under test use
+ */
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+using std::min;
+using std::max;
+
+#endif //ARDUINO_LIGHTFX_TEST_SHIM_ARDUINO_H
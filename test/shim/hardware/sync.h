@@ -0,0 +1,36 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+#ifndef ARDUINO_LIGHTFX_TEST_SHIM_HARDWARE_SYNC_H
+#define ARDUINO_LIGHTFX_TEST_SHIM_HARDWARE_SYNC_H
+
+/**
+ * Host stand-in for the Pico SDK hardware spin locks, for the native test environment - same contract, backed by atomic flags
+ */
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+typedef std::atomic_flag spin_lock_t;
+
+inline spin_lock_t *spin_lock_instance(const unsigned int lockNum) {
+    static spin_lock_t locks[32] {};
+    return &locks[lockNum & 31];
+}
+
+inline unsigned int spin_lock_claim_unused(bool) {
+    static std::atomic<unsigned int> next {0};
+    return next++;
+}
+
+inline uint32_t spin_lock_blocking(spin_lock_t *lock) {
+    while (lock->test_and_set(std::memory_order_acquire))
+        std::this_thread::yield();
+    return 0;
+}
+
+inline void spin_unlock(spin_lock_t *lock, uint32_t) {
+    lock->clear(std::memory_order_release);
+}
+
+#endif //ARDUINO_LIGHTFX_TEST_SHIM_HARDWARE_SYNC_H
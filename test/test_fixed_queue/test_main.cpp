@@ -0,0 +1,145 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+// Host soak test of FixedQueue - bounded deque semantics against a std::deque model, and no heap use - pio test -e native -f test_fixed_queue
+//
+#include <unity.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <random>
+#include "fixed_queue.h"
+
+// heap accounting - every allocation of the test program goes through these
+static size_t heapAllocs = 0;
+
+void *operator new(const size_t sz) {
+    heapAllocs++;
+    if (void *p = std::malloc(sz))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+struct TimeSync {
+    uint32_t localMillis;
+    int64_t unixMillis;
+    bool operator==(const TimeSync &o) const { return localMillis == o.localMillis && unixMillis == o.unixMillis; }
+};
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * Random pushes, pops, erases and clears on a FixedQueue and on a std::deque trimmed to the same capacity - the two must hold the
+ * same elements in the same order after every operation
+ */
+template<typename T, size_t N, typename Gen> static void soak(const uint32_t ops, Gen make) {
+    FixedQueue<T, N> q;
+    std::deque<T> model;
+    std::mt19937 rnd(N * 7919);
+    for (uint32_t op = 0; op < ops; op++) {
+        const T v = make(op);
+        switch (rnd() % 16) {
+            case 0: case 1: case 2: case 3: case 4: case 5:
+                q.push(v);
+                model.push_back(v);
+                if (model.size() > N)
+                    model.pop_front();
+                break;
+            case 6: case 7:
+                q.push_front(v);
+                model.push_front(v);
+                if (model.size() > N)
+                    model.pop_back();
+                break;
+            case 8: case 9: case 10:
+                if (!model.empty()) {
+                    q.pop();
+                    model.pop_front();
+                }
+                break;
+            case 11:
+                if (!model.empty()) {
+                    q.pop_back();
+                    model.pop_back();
+                }
+                break;
+            case 12: case 13:
+                if (!model.empty()) {
+                    const size_t at = rnd() % model.size();
+                    q.erase(q.begin() + at);
+                    model.erase(model.begin() + at);
+                }
+                break;
+            case 14:
+                if (!model.empty())
+                    TEST_ASSERT_TRUE(*std::find(q.begin(), q.end(), model.back()) == model.back());
+                break;
+            default:
+                if (rnd() % 64 == 0) {
+                    q.clear();
+                    model.clear();
+                }
+                break;
+        }
+        TEST_ASSERT_EQUAL_UINT32(model.size(), q.size());
+        TEST_ASSERT_TRUE(std::equal(model.begin(), model.end(), q.begin(), q.end()));
+        if (!model.empty()) {
+            TEST_ASSERT_TRUE(q.front() == model.front());
+            TEST_ASSERT_TRUE(q.back() == model.back());
+            TEST_ASSERT_TRUE(q.end()[-1] == model.back());
+        }
+    }
+}
+
+void test_matches_bounded_deque() {
+    soak<uint16_t, 10>(2000000, [](const uint32_t op) { return static_cast<uint16_t>(op); });
+    soak<TimeSync, 8>(500000, [](const uint32_t op) { return TimeSync{op, static_cast<int64_t>(op) * 1000}; });
+    soak<int, 1>(100000, [](const uint32_t op) { return static_cast<int>(op); });
+}
+
+/**
+ * Effect change churn as the registry and the frame loops see it - the queue makes no heap allocations at all, where the std::deque it
+ * replaced keeps allocating and freeing its chunks
+ */
+void test_no_heap_use() {
+    constexpr uint32_t ops = 10000000;
+    auto *q = new FixedQueue<uint16_t, 10>();
+    heapAllocs = 0;
+    for (uint32_t op = 0; op < ops; op++) {
+        q->push(static_cast<uint16_t>(op));
+        if (op % 3 == 0)
+            q->pop();
+        if (op % 1000 == 0 && !q->empty())
+            q->erase(q->begin() + (op % q->size()));
+    }
+    const size_t fixedAllocs = heapAllocs;
+    delete q;
+    std::deque<uint16_t> dq;
+    heapAllocs = 0;
+    for (uint32_t op = 0; op < ops; op++) {
+        dq.push_back(static_cast<uint16_t>(op));
+        if (dq.size() > 10)
+            dq.pop_front();
+        if (op % 3 == 0)
+            dq.pop_front();
+        if (op % 1000 == 0 && !dq.empty())
+            dq.erase(dq.begin() + (op % dq.size()));
+    }
+    char msg[120];
+    snprintf(msg, sizeof(msg), "%u operations: FixedQueue %zu heap allocations, std::deque %zu", ops, fixedAllocs, heapAllocs);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL_UINT32(0, fixedAllocs);
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_matches_bounded_deque);
+    RUN_TEST(test_no_heap_use);
+    return UNITY_END();
+}
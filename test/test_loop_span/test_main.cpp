@@ -0,0 +1,77 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+// Host test of the span looping behind loopRight - every length, position and direction against an index arithmetic model -
+// pio test -e native -f test_loop_span
+//
+#include <unity.h>
+#include <cstdint>
+#include <vector>
+#include "loop_span.h"
+
+/**
+ * Reference loop: the element at logical position i lands at (i + pos) % len; for a reversed span logical position i lives at memory
+ * position len - 1 - i
+ */
+static std::vector<uint32_t> refLoop(const std::vector<uint32_t> &in, const uint16_t pos, const bool reversed) {
+    const size_t len = in.size();
+    std::vector<uint32_t> out(len);
+    for (size_t i = 0; i < len; i++) {
+        const size_t from = reversed ? len - 1 - i : i;
+        const size_t to = reversed ? len - 1 - (i + pos) % len : (i + pos) % len;
+        out[to] = in[from];
+    }
+    return out;
+}
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * All lengths up to 70 (past a typical frame), positions up to twice the length (wrapping), both directions
+ */
+void test_matches_model() {
+    for (uint16_t len = 1; len <= 70; len++) {
+        std::vector<uint32_t> in(len);
+        for (uint16_t i = 0; i < len; i++)
+            in[i] = 1000u + i;
+        for (uint16_t pos = 0; pos <= 2 * len; pos++) {
+            for (const bool reversed : {false, true}) {
+                std::vector<uint32_t> span = in;
+                loopSpan(span.data(), len, pos, reversed);
+                const std::vector<uint32_t> expected = refLoop(in, pos, reversed);
+                TEST_ASSERT_EQUAL_UINT32_ARRAY(expected.data(), span.data(), len);
+            }
+        }
+    }
+}
+
+/**
+ * An empty span is left alone, and looping it does not divide by zero
+ */
+void test_empty_span() {
+    uint32_t guard = 42;
+    loopSpan(&guard, 0, 5);
+    TEST_ASSERT_EQUAL_UINT32(42, guard);
+}
+
+/**
+ * Looping right then left by the same amount restores the span
+ */
+void test_round_trip() {
+    std::vector<uint32_t> span(170);
+    for (uint16_t i = 0; i < span.size(); i++)
+        span[i] = i * 7u;
+    const std::vector<uint32_t> orig = span;
+    loopSpan(span.data(), span.size(), 37);
+    loopSpan(span.data(), span.size(), 37, true);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(orig.data(), span.data(), span.size());
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_matches_model);
+    RUN_TEST(test_empty_span);
+    RUN_TEST(test_round_trip);
+    return UNITY_END();
+}
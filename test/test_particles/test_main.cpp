@@ -0,0 +1,174 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+// Host test of the particle pool - bookkeeping against a plain model, arena exhaustion, and the FxF5 explosion fixed point kinematics
+// against the float sparks they replaced - pio test -e native -f test_particles. The kinematic step is timed on the target, see
+// particleBenchmark in fx_bench.cpp
+//
+#include <unity.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include "../../src/fx_arena.cpp"
+#include "../../src/particles.cpp"
+
+#define POOL_SIZE       128     // particles in the pool under test
+#define POOL_OPS        20000   // random pool operations checked against the model
+#define EXPLOSIONS      300     // FxF5 explosions checked against the float kinematics
+#define STRIP_SIZE      300     // pixels the explosions play over
+
+static std::mt19937 rng(0x5EED);
+
+static uint16_t randomRange(const uint16_t lo, const uint16_t hi) {
+    return std::uniform_int_distribution<uint16_t>(lo, hi - 1)(rng);
+}
+
+void setUp() {
+    fxArena.reset();
+}
+void tearDown() {}
+
+/**
+ * Random spawns, kills, aging and clears; after each operation the live count, the live slots and the slots <code>forEach</code>
+ * visits, in order, must match the model
+ */
+void test_pool_matches_model() {
+    ParticlePool pool;
+    TEST_ASSERT_TRUE(pool.begin(POOL_SIZE));
+    bool alive[POOL_SIZE] {};
+    uint8_t life[POOL_SIZE] {};
+    for (uint32_t op = 0; op < POOL_OPS; op++) {
+        switch (randomRange(0, 8)) {
+            case 0: case 1: case 2: {
+                //spawn claims the first dead slot
+                int16_t expected = -1;
+                for (uint16_t i = 0; i < POOL_SIZE && expected < 0; i++)
+                    if (!alive[i])
+                        expected = static_cast<int16_t>(i);
+                const int16_t i = pool.spawn();
+                TEST_ASSERT_EQUAL_INT16(expected, i);
+                if (i >= 0) {
+                    alive[i] = true;
+                    pool.life[i] = life[i] = randomRange(1, 24);
+                }
+                break;
+            }
+            case 3: case 4: {
+                const uint16_t i = randomRange(0, POOL_SIZE);
+                pool.kill(i);
+                alive[i] = false;
+                break;
+            }
+            case 5: case 6: {
+                const uint8_t steps = randomRange(1, 4);
+                pool.age(steps);
+                for (uint16_t i = 0; i < POOL_SIZE; i++)
+                    if (alive[i] && (life[i] = life[i] > steps ? life[i] - steps : 0) == 0)
+                        alive[i] = false;
+                break;
+            }
+            default:
+                if (randomRange(0, 256) < 8) {
+                    pool.clear();
+                    memset(alive, 0, sizeof(alive));
+                }
+                break;
+        }
+        uint16_t live = 0;
+        for (uint16_t i = 0; i < POOL_SIZE; i++) {
+            live += alive[i];
+            TEST_ASSERT_EQUAL(alive[i], pool.isAlive(i));
+        }
+        int16_t prev = -1;
+        uint16_t visited = 0;
+        pool.forEach([&](const uint16_t i) {
+            TEST_ASSERT_TRUE(static_cast<int16_t>(i) > prev && alive[i]);
+            prev = static_cast<int16_t>(i);
+            visited++;
+        });
+        TEST_ASSERT_EQUAL_UINT16(live, visited);
+        TEST_ASSERT_EQUAL_UINT16(live, pool.count());
+    }
+}
+
+/**
+ * A full pool refuses to spawn; a pool that does not fit the arena is left empty, with no capacity
+ */
+void test_pool_limits() {
+    ParticlePool pool;
+    TEST_ASSERT_TRUE(pool.begin(40));
+    for (uint16_t i = 0; i < 40; i++)
+        TEST_ASSERT_EQUAL_INT16(i, pool.spawn());
+    TEST_ASSERT_EQUAL_INT16(-1, pool.spawn());
+    pool.kill(17);
+    TEST_ASSERT_EQUAL_INT16(17, pool.spawn());
+
+    ParticlePool tooBig;
+    TEST_ASSERT_FALSE(tooBig.begin(FX_ARENA_SIZE));
+    TEST_ASSERT_EQUAL_UINT16(0, tooBig.capacity());
+    TEST_ASSERT_EQUAL_INT16(-1, tooBig.spawn());
+}
+
+/**
+ * The FxF5 explosion in fixed point against the float sparks it replaced - same random draws, same steps, the spark positions are
+ * compared at every step. A spark that reached the bottom stays at pixel 0 in both. Positions may differ by a pixel where the float
+ * position sits on a pixel boundary, never by more
+ */
+void test_explosion_matches_float() {
+    ParticlePool pool;
+    TEST_ASSERT_TRUE(pool.begin(POOL_SIZE));
+    float floatPos[POOL_SIZE];
+    float floatVel[POOL_SIZE];
+    constexpr ParticlePool::fixed gravity = -262;
+    const ParticlePool::fixed top = ParticlePool::toFixed(STRIP_SIZE - 1);
+    uint32_t compared = 0, identical = 0;
+    for (uint16_t e = 0; e < EXPLOSIONS; e++) {
+        const uint16_t flarePos = randomRange(STRIP_SIZE * 3 / 10, STRIP_SIZE * 8 / 10);
+        const uint16_t nSparks = std::min(static_cast<uint16_t>(flarePos / 3), static_cast<uint16_t>(POOL_SIZE));
+        const ParticlePool::fixed origin = ParticlePool::toFixed(static_cast<int16_t>(flarePos));
+        const int32_t velScale = static_cast<int32_t>(flarePos) * 655360 / (17 * STRIP_SIZE);
+        pool.clear();
+        for (uint16_t s = 0; s < nSparks; s++) {
+            const uint16_t r = randomRange(0, 20000);
+            const int16_t i = pool.spawn();
+            pool.pos[i] = origin;
+            const ParticlePool::fixed velocity = static_cast<ParticlePool::fixed>(r) * 65536 / 10000 - 65536;
+            pool.vel[i] = static_cast<ParticlePool::fixed>(static_cast<int64_t>(velocity) * velScale >> 16);
+            floatPos[s] = flarePos;
+            floatVel[s] = (static_cast<float>(r) / 10000.0f - 1.0f) * (flarePos / 1.7f / static_cast<float>(STRIP_SIZE));
+        }
+        int32_t dyingGravity = gravity * 256;
+        float floatGravity = -.004f;
+        for (uint16_t iter = 0; iter < 540; iter++) {
+            pool.forEach([&pool](const uint16_t i) {
+                if (pool.pixel(i) == 0)
+                    pool.kill(i);
+            });
+            pool.move((dyingGravity + 128) >> 8, 0, top);
+            dyingGravity -= dyingGravity * 15 / 1000;
+            for (uint16_t s = 0; s < nSparks; s++) {
+                if (static_cast<uint16_t>(floatPos[s]) != 0) {
+                    floatPos[s] = std::clamp(floatPos[s] + floatVel[s], 0.0f, static_cast<float>(STRIP_SIZE - 1));
+                    floatVel[s] += floatGravity;
+                }
+                const int16_t fixedPx = pool.isAlive(s) ? pool.pixel(s) : 0;
+                const int16_t d = std::abs(fixedPx - static_cast<int16_t>(floatPos[s]));
+                TEST_ASSERT_LESS_OR_EQUAL_INT16(1, d);
+                compared++;
+                identical += d == 0;
+            }
+            floatGravity *= 0.985f;
+        }
+    }
+    //off by one pixel is the exception - about 3% of the positions
+    TEST_ASSERT_GREATER_THAN_UINT32(compared * 95 / 100, identical);
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_pool_matches_model);
+    RUN_TEST(test_pool_limits);
+    RUN_TEST(test_explosion_matches_float);
+    return UNITY_END();
+}
@@ -0,0 +1,135 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+// Host bit-exactness test of the packed pixel kernels against the FastLED (FASTLED_SCALE8_FIXED=1) and util.cpp scalar formulas,
+// over every amount and every alignment - pio test -e native -f test_pixel_kernels. Their speed is measured on the target, see
+// kernelBenchmark in fx_bench.cpp
+//
+#include <unity.h>
+#include <cstring>
+#include <random>
+#include "../../src/pixel_kernels.cpp"
+
+// reference formulas, transcribed from FastLED 3.9 lib8tion (scale8, blend8) and util.cpp (bmul8, bscr8, bovl8)
+static uint8_t refScale8(const uint8_t i, const uint8_t scale) {
+    return (static_cast<uint16_t>(i) * (1 + static_cast<uint16_t>(scale))) >> 8;
+}
+
+static uint8_t refBlend8(const uint8_t a, const uint8_t b, const uint8_t amountOfB) {
+    uint16_t partial = (a << 8) | b;
+    partial += (b * amountOfB);
+    partial -= (a * amountOfB);
+    return partial >> 8;
+}
+
+// nblend over whole pixels, with its 0 and 255 shortcuts
+static void refNblend(uint8_t *dst, const uint8_t *src, const size_t n, const uint8_t amount) {
+    if (amount == 0)
+        return;
+    for (size_t i = 0; i < n; i++)
+        dst[i] = amount == 255 ? src[i] : refBlend8(dst[i], src[i], amount);
+}
+
+static uint8_t refBmul8(const uint8_t a, const uint8_t b) {
+    if (a == 255)
+        return b;
+    if (b == 255)
+        return a;
+    return (static_cast<uint16_t>(a) * static_cast<uint16_t>(b)) / 256;
+}
+
+static uint8_t refBscr8(const uint8_t a, const uint8_t b) {
+    return 255 - refBmul8(255 - a, 255 - b);
+}
+
+static uint8_t refBovl8(const uint8_t a, const uint8_t b) {
+    if (a < 128)
+        return refBmul8(a, b) * 2;
+    return 255 - refBmul8(255 - a, 255 - b) * 2;
+}
+
+static std::mt19937 rnd(20250101);
+
+static void randomize(uint8_t *p, const size_t n) {
+    for (size_t i = 0; i < n; i++)
+        p[i] = rnd();
+}
+
+void setUp() {}
+void tearDown() {}
+
+// sizes cover the head bytes before the first aligned word, whole words and the tail, up to 2 blocks of 12 bytes past the head
+static constexpr size_t maxBytes = 3 * 17;
+
+void test_scale_bit_exact() {
+    alignas(4) uint8_t buf[maxBytes + 4], ref[maxBytes + 4];
+    for (uint16_t scale = 0; scale < 256; scale++)
+        for (uint8_t ofs = 0; ofs < 4; ofs++)
+            for (size_t n = 0; n <= maxBytes; n += 3) {
+                randomize(buf, sizeof(buf));
+                memcpy(ref, buf, sizeof(buf));
+                scaleBytes(buf + ofs, n, scale);
+                for (size_t i = 0; i < n; i++)
+                    ref[ofs + i] = refScale8(ref[ofs + i], scale);
+                TEST_ASSERT_EQUAL_MEMORY(ref, buf, sizeof(buf));
+            }
+}
+
+void test_blend_bit_exact() {
+    alignas(4) uint8_t dst[maxBytes + 4], src[maxBytes + 4], ref[maxBytes + 4];
+    for (uint16_t amount = 0; amount < 256; amount++)
+        for (uint8_t dOfs = 0; dOfs < 4; dOfs++)
+            for (uint8_t sOfs = 0; sOfs < 4; sOfs++)
+                for (size_t n = 0; n <= maxBytes; n += 3) {
+                    randomize(dst, sizeof(dst));
+                    randomize(src, sizeof(src));
+                    memcpy(ref, dst, sizeof(dst));
+                    blendBytes(dst + dOfs, src + sOfs, n, amount);
+                    refNblend(ref + dOfs, src + sOfs, n, amount);
+                    TEST_ASSERT_EQUAL_MEMORY(ref, dst, sizeof(dst));
+                }
+}
+
+void test_blend_color_bit_exact() {
+    alignas(4) uint8_t dst[maxBytes + 4], ref[maxBytes + 4];
+    for (uint16_t amount = 0; amount < 256; amount++)
+        for (uint8_t ofs = 0; ofs < 4; ofs++)
+            for (size_t px = 0; px <= maxBytes / 3; px++) {
+                uint8_t color[3];
+                randomize(color, 3);
+                randomize(dst, sizeof(dst));
+                memcpy(ref, dst, sizeof(dst));
+                blendColorBytes(dst + ofs, px, color, amount);
+                for (size_t p = 0; p < px; p++)
+                    refNblend(ref + ofs + p * 3, color, 3, amount);
+                TEST_ASSERT_EQUAL_MEMORY(ref, dst, sizeof(dst));
+            }
+}
+
+void test_blend_modes_exhaustive() {
+    static uint8_t base[256 * 256], top[256 * 256], mul[256 * 256], scr[256 * 256], ovl[256 * 256];
+    for (uint32_t i = 0; i < 256 * 256; i++) {
+        base[i] = i >> 8;
+        top[i] = i & 0xFF;
+    }
+    memcpy(mul, base, sizeof(base));
+    memcpy(scr, base, sizeof(base));
+    memcpy(ovl, base, sizeof(base));
+    multiplyBytes(mul, top, sizeof(mul));
+    screenBytes(scr, top, sizeof(scr));
+    overlayBytes(ovl, top, sizeof(ovl));
+    for (uint32_t i = 0; i < 256 * 256; i++) {
+        TEST_ASSERT_EQUAL_UINT8(refBmul8(base[i], top[i]), mul[i]);
+        TEST_ASSERT_EQUAL_UINT8(refBscr8(base[i], top[i]), scr[i]);
+        TEST_ASSERT_EQUAL_UINT8(refBovl8(base[i], top[i]), ovl[i]);
+    }
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_scale_bit_exact);
+    RUN_TEST(test_blend_bit_exact);
+    RUN_TEST(test_blend_color_bit_exact);
+    RUN_TEST(test_blend_modes_exhaustive);
+    return UNITY_END();
+}
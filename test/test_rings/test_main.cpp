@@ -0,0 +1,235 @@
+//
+// Copyright (c) 2025 by Dan Luca. All rights reserved.
+//
+// Host tests and throughput benchmark of the audio and logger rings - pio test -e native -f test_rings
+//
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "spsc_ring.h"
+#include "util/mpsc_ring.h"
+
+using LogUtil::ByteSpan;
+using LogUtil::MpscByteRing;
+
+/**
+ * The mutex guarded circular buffer the rings replaced (formerly include/circular_buffer.h) - same algorithm, a lock and a modulo per
+ * element, with std::mutex standing in for CoreMutex. Kept here as the benchmark reference only.
+ */
+template<typename T> class LegacyCircularBuffer {
+    std::vector<T> buffer_;
+    size_t head_ = 0;
+    size_t tail_ = 0;
+    bool full_ = false;
+    std::mutex mutex_;
+public:
+    explicit LegacyCircularBuffer(const size_t size) : buffer_(size) {}
+
+    void push_back(const T value[], const size_t sz) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = sz > buffer_.size() ? sz - buffer_.size() : 0; i < sz; ++i) {
+            buffer_[head_] = value[i];
+            if (full_)
+                tail_ = (tail_ + 1) % buffer_.size();
+            head_ = (head_ + 1) % buffer_.size();
+            full_ = head_ == tail_;
+        }
+    }
+
+    size_t pop_front(T dest[], const size_t sz) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const size_t used = full_ ? buffer_.size() : (head_ >= tail_ ? head_ - tail_ : buffer_.size() + head_ - tail_);
+        const size_t avail = std::min(sz, used);
+        for (size_t i = 0; i < avail; i++) {
+            dest[i] = buffer_[tail_];
+            tail_ = (tail_ + 1) % buffer_.size();
+        }
+        if (avail > 0)
+            full_ = false;
+        return avail;
+    }
+};
+
+void setUp() {}
+void tearDown() {}
+
+void test_spsc_bulk_wraps_in_order() {
+    static SpscRing<short, 64> ring;
+    short in[40], out[40];
+    short next = 0, expected = 0;
+    for (int round = 0; round < 100; round++) {
+        const size_t n = 1 + round % 40;
+        for (size_t i = 0; i < n; i++)
+            in[i] = next++;
+        TEST_ASSERT_EQUAL_UINT32(n, ring.push(in, n));
+        TEST_ASSERT_EQUAL_UINT32(n, ring.pop(out, n));
+        for (size_t i = 0; i < n; i++)
+            TEST_ASSERT_EQUAL_INT16(expected++, out[i]);
+        TEST_ASSERT_TRUE(ring.empty());
+    }
+}
+
+void test_spsc_full_rejects() {
+    static SpscRing<int, 16> ring;
+    int in[20] {};
+    TEST_ASSERT_EQUAL_UINT32(16, ring.push(in, 20));
+    TEST_ASSERT_TRUE(ring.full());
+    TEST_ASSERT_FALSE(ring.push(1));
+    TEST_ASSERT_EQUAL_UINT32(0, ring.writeSpan().size);
+    ring.consume(5);
+    TEST_ASSERT_EQUAL_UINT32(5, ring.available());
+}
+
+void test_spsc_spans_zero_copy() {
+    static SpscRing<int, 16> ring;
+    int value = 0, expected = 0;
+    for (int round = 0; round < 50; round++) {
+        //fill through the write spans - two when wrapping
+        for (RingSpan<int> span = ring.writeSpan(); span.size > 0; span = ring.writeSpan()) {
+            for (size_t i = 0; i < span.size; i++)
+                span.data[i] = value++;
+            ring.commit(span.size);
+        }
+        TEST_ASSERT_TRUE(ring.full());
+        const size_t drain = 1 + round % 16;
+        size_t drained = 0;
+        while (drained < drain) {
+            const RingSpan<const int> span = ring.readSpan();
+            const size_t n = std::min(span.size, drain - drained);
+            for (size_t i = 0; i < n; i++)
+                TEST_ASSERT_EQUAL_INT(expected++, span.data[i]);
+            ring.consume(n);
+            drained += n;
+        }
+    }
+}
+
+void test_spsc_two_threads() {
+    static SpscRing<uint32_t, 1024> ring;
+    constexpr uint32_t total = 1000000;
+    std::thread producer([] {
+        uint32_t block[37];
+        uint32_t next = 0;
+        while (next < total) {
+            const size_t n = std::min<size_t>(1 + next % 37, total - next);
+            for (size_t i = 0; i < n; i++)
+                block[i] = next + i;
+            if (const size_t pushed = ring.push(block, n); pushed > 0)
+                next += pushed;
+            else
+                std::this_thread::yield();
+        }
+    });
+    uint32_t expected = 0;
+    bool ordered = true;
+    while (expected < total) {
+        const RingSpan<const uint32_t> span = ring.readSpan();
+        if (span.size == 0)
+            std::this_thread::yield();
+        for (size_t i = 0; i < span.size; i++)
+            ordered &= span.data[i] == expected++;
+        ring.consume(span.size);
+    }
+    producer.join();
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+void test_mpsc_producers_keep_order() {
+    static MpscByteRing<4096> ring;
+    constexpr int producers = 3;
+    constexpr int records = 50000;
+    static std::atomic<int> done {0};
+    const auto format = [](char *rec, const size_t sz, const int p, const int seq) {
+        return snprintf(rec, sz, "%d:%d%.*s", p, seq, seq % 11, "..........");
+    };
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([p, format] {
+            char rec[32];
+            for (int seq = 0; seq < records; seq++)
+                ring.push(rec, format(rec, sizeof(rec), p, seq));
+            done++;
+        });
+    }
+    int last[producers] = {-1, -1, -1};
+    uint32_t received = 0;
+    bool valid = true;
+    //records of one producer come in order, intact - some may have been dropped for lack of room
+    while (done < producers || !ring.empty()) {
+        ByteSpan spans[2];
+        const size_t len = ring.peek(spans);
+        if (len == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        std::string rec(spans[0].data, spans[0].size);
+        rec.append(spans[1].data, spans[1].size);
+        int p = -1, seq = -1;
+        char expected[32];
+        valid &= sscanf(rec.c_str(), "%d:%d", &p, &seq) == 2 && p >= 0 && p < producers && seq > last[p];
+        valid &= valid && rec == std::string(expected, format(expected, sizeof(expected), p, seq));
+        if (valid)
+            last[p] = seq;
+        ring.release();
+        received++;
+    }
+    for (auto &t : threads)
+        t.join();
+    TEST_ASSERT_TRUE(valid);
+    TEST_ASSERT_EQUAL_UINT32(producers * records, received + ring.dropped());
+    TEST_ASSERT_TRUE(received > 0);
+}
+
+/**
+ * Push and pop in one thread, blocks of the size given through a 1024 sample ring - reports samples per second for the legacy
+ * buffer and the SPSC ring
+ */
+static void benchBlock(const size_t block) {
+    using Clock = std::chrono::steady_clock;
+    constexpr size_t samples = 1 << 24;
+    std::vector<short> in(block), out(block);
+    for (size_t i = 0; i < block; i++)
+        in[i] = static_cast<short>(i);
+    static LegacyCircularBuffer<short> legacy(1024);
+    static SpscRing<short, 1024> ring;
+    uint64_t sink = 0;
+    auto start = Clock::now();
+    for (size_t n = 0; n < samples; n += block) {
+        legacy.push_back(in.data(), block);
+        sink += legacy.pop_front(out.data(), block);
+    }
+    const double legacyS = std::chrono::duration<double>(Clock::now() - start).count();
+    start = Clock::now();
+    for (size_t n = 0; n < samples; n += block) {
+        ring.push(in.data(), block);
+        sink += ring.pop(out.data(), block);
+    }
+    const double ringS = std::chrono::duration<double>(Clock::now() - start).count();
+    TEST_ASSERT_EQUAL_UINT64(2 * ((samples + block - 1) / block) * block, sink);
+    char msg[160];
+    snprintf(msg, sizeof(msg), "block %4zu: legacy %8.1f M samples/s, spsc %8.1f M samples/s (x%.1f)", block,
+             samples / legacyS / 1e6, samples / ringS / 1e6, legacyS / ringS);
+    TEST_MESSAGE(msg);
+}
+
+void bench_spsc_vs_legacy() {
+    for (const size_t block : {1, 16, 256})
+        benchBlock(block);
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_spsc_bulk_wraps_in_order);
+    RUN_TEST(test_spsc_full_rejects);
+    RUN_TEST(test_spsc_spans_zero_copy);
+    RUN_TEST(test_spsc_two_threads);
+    RUN_TEST(test_mpsc_producers_keep_order);
+    RUN_TEST(bench_spsc_vs_legacy);
+    return UNITY_END();
+}